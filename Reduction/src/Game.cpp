@@ -1,13 +1,25 @@
 #include "Game.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <random>
+
 #include "utils/Settings.h"
 #include "utils/Log.h"
 #include "utils/MathUtils.h"
 #include "utils/Random.h"
+#include "utils/Profiler.h"
+#include "gfx/TextureCache.h"
+#include "gfx/FontCache.h"
 
 
-Game::Game()
+Game::Game(const PacingConfig& pacing)
+	: m_Pacer(pacing)
 {
+	m_SimThread = new SimThread(m_Simulation, m_Bots, m_ReplayRecorder);
+
 	// Initialises SDL
 	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0)
 	{
@@ -46,6 +58,9 @@ Game::Game()
 	// Initialises the random generator
 	Random::init();
 
+	// Frames are timed on this thread
+	Profiler::init();
+
 	// Creates window
 	m_Window = SDL_CreateWindow("Reduction", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
 
@@ -57,8 +72,15 @@ Game::Game()
 		return;
 	}
 
-	// Creates renderer
-	m_Renderer = SDL_CreateRenderer(m_Window, -1, SDL_RENDERER_ACCELERATED);
+	// Creates renderer (vsync can only be asked for here)
+	Uint32 rendererFlags = SDL_RENDERER_ACCELERATED;
+
+	if (pacing.mode == PacingMode::VSync)
+	{
+		rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+	}
+
+	m_Renderer = SDL_CreateRenderer(m_Window, -1, rendererFlags);
 
 	if (!m_Renderer)
 	{
@@ -71,9 +93,19 @@ Game::Game()
 	// Sets the clear colour
 	SDL_SetRenderDrawColor(m_Renderer, 0, 0, 0, 255);
 
+	// Textures and fonts are shared through caches
+	TextureCache::init(m_Renderer);
+	FontCache::init(m_Renderer);
+
 	// Sets up loading screen text
 	m_LoadingText.load("res/fonts/SPACEMAN.TTF", "loading...", 56, SDL_Color { 255, 255, 255, 255 }, m_Renderer);
 
+	// Sets up profiler overlay text
+	for (unsigned int i = 0; i <= (unsigned int) ProfilePhase::Count; i++)
+	{
+		m_ProfilerTexts.push_back(new Text("res/fonts/BM Space.TTF", " ", 14, SDL_Color { 255, 255, 255, 255 }, m_Renderer));
+	}
+
 	// Initialises audio
 	initAudio();
 
@@ -83,16 +115,43 @@ Game::Game()
 
 Game::~Game()
 {
-	// Deletes players
-	for (Player* player : m_Players)
+	logPacingStats();
+
+	// Stops the round in progress before anything it uses goes
+	delete m_SimThread;
+
+	// Keeps the match that was being played when the game closed
+	finishReplay();
+
+	delete m_ReplayPlayback;
+	endOnlineMatch();
+
+	// Deletes player sprites
+	for (PlayerSprite* sprite : m_PlayerSprites)
 	{
-		delete player;
+		delete sprite;
 	}
 
+	// Deletes wall
+	delete m_Wall;
+
 	// Deletes buttons
 	delete m_NextButton;
 	delete m_TwoPlayersButton;
 	delete m_ThreePlayersButton;
+
+	// Deletes profiler overlay text
+	for (Text* text : m_ProfilerTexts)
+	{
+		delete text;
+	}
+
+	// Frees all textures and font atlases while the renderer still exists
+	TextureCache::clear();
+	FontCache::clear();
+
+	// Saves frame timings for later analysis
+	Profiler::writeCsv("profile.csv");
 }
 
 
@@ -100,6 +159,19 @@ void Game::run()
 {
 	while (m_Running)
 	{
+		// Menus only change on input, so wait for some rather than redrawing an unchanged page
+		// (except while online peers still need polling)
+		bool isIdle = m_GameState == GameState::StartScreen || m_GameState == GameState::RoundOver
+			|| (m_GameState == GameState::GameOver && !m_RollbackSession);
+
+		if (isIdle)
+		{
+			SDL_WaitEventTimeout(nullptr, MENU_REDRAW_INTERVAL);
+		}
+
+		Profiler::beginFrame();
+		GameState frameState = m_GameState;
+
 		switch (m_GameState)
 		{
 		case GameState::StartScreen:
@@ -128,14 +200,46 @@ void Game::run()
 			updateGameOver();
 			drawGameOver();
 
+			break;
+
+		case GameState::Replay:
+			handleReplayEvents();
+			updateReplay();
+			drawGameplay();
+
 			break;
 		}
+
+		// The loading screen presents itself
+		if (m_IsOnLoadingScreen)
+		{
+			m_IsOnLoadingScreen = false;
+		}
+
+		else
+		{
+			if (m_ShowProfiler)
+			{
+				drawProfilerOverlay();
+			}
+
+			ProfileScope profileScope(ProfilePhase::Present);
+			SDL_RenderPresent(m_Renderer);
+		}
+
+		Profiler::endFrame();
+		checkFrameAllocations(frameState);
+
+		m_Pacer.endFrame(isIdle);
 	}
 }
 
 
 void Game::initGameplay()
 {
+	// Grows the profile history now rather than part way through the round
+	Profiler::reserveFrames();
+
 	if (m_GameplayInitialised)
 	{
 		resetGameplayNewRound();
@@ -145,32 +249,23 @@ void Game::initGameplay()
 	// Draws loading screen
 	drawLoadingScreen();
 
-	// Loads wall texture
-	m_WallTexture = IMG_LoadTexture(m_Renderer, "res/txrs/Wall Mask.png");
-
-	if (!m_WallTexture)
-	{
-		error("Could not load Wall texture.\nSDL_Error: ", SDL_GetError());
-		m_Running = false;
-
-		return;
-	}
+	// Loads bullet texture
+	m_BulletTexture = TextureCache::acquire("res/txrs/Bullet.png");
 
-	if (SDL_QueryTexture(m_WallTexture, nullptr, nullptr, &m_WallRect.w, &m_WallRect.h) != 0)
+	if (!m_BulletTexture)
 	{
-		error("Wall texture is invalid.\nSDL_Error: ", SDL_GetError());
+		error("Could not load Bullet texture.\nSDL_Error: ", SDL_GetError());
 		m_Running = false;
 
 		return;
 	}
 
-	SDL_SetTextureAlphaMod(m_WallTexture, 60);
-
-	m_OriginalWallWidth = m_WallRect.w;
-	m_OriginalWallHeight = m_WallRect.h;
+	// Wall is drawn procedurally, so only needs the renderer
+	m_Wall = new Wall(m_Renderer);
 
-	// Loads background texture
-	m_SpaceBackgroundTexture = IMG_LoadTexture(m_Renderer, "res/txrs/Space.png");
+	// Swaps the start screen background for the gameplay one
+	TextureCache::release("res/txrs/Start Screen Space.jpg");
+	m_SpaceBackgroundTexture = TextureCache::acquire("res/txrs/Space.png");
 
 	if (!m_SpaceBackgroundTexture)
 	{
@@ -191,21 +286,20 @@ void Game::initGameplay()
 	m_SpaceBackgroundRect.w = SCREEN_WIDTH;
 	m_SpaceBackgroundRect.h = SCREEN_HEIGHT;
 
-	// Initialises barriers
-	m_Barriers.push_back(Barrier { m_Renderer, SCREEN_WIDTH / 2 - BARRIER_DISTANCE_FROM_CENTER, SCREEN_HEIGHT / 2 - BARRIER_DISTANCE_FROM_CENTER });
-	m_Barriers.push_back(Barrier { m_Renderer, SCREEN_WIDTH / 2 + BARRIER_DISTANCE_FROM_CENTER, SCREEN_HEIGHT / 2 - BARRIER_DISTANCE_FROM_CENTER });
-	m_Barriers.push_back(Barrier { m_Renderer, SCREEN_WIDTH / 2 + BARRIER_DISTANCE_FROM_CENTER, SCREEN_HEIGHT / 2 + BARRIER_DISTANCE_FROM_CENTER });
-	m_Barriers.push_back(Barrier { m_Renderer, SCREEN_WIDTH / 2 - BARRIER_DISTANCE_FROM_CENTER, SCREEN_HEIGHT / 2 + BARRIER_DISTANCE_FROM_CENTER });
-
 	m_GameplayInitialised = true;
 
 	m_FrameTimer.reset();
+	m_SimAccumulator = 0.0;
 }
 
 void Game::handleGameplayEvents()
 {
+	ProfileScope profileScope(ProfilePhase::Events);
+
 	while (SDL_PollEvent(&m_Event))
 	{
+		handleProfilerToggle();
+
 		switch (m_Event.type)
 		{
 		case SDL_QUIT:
@@ -216,83 +310,43 @@ void Game::handleGameplayEvents()
 			switch (m_Event.key.keysym.sym)
 			{
 			case SDLK_LEFT:
-				if (m_Players[0]->isAlive())
-				{
-					m_Players[0]->setRotationSpeed(-PLAYER_ROTATION_SPEED);
-				}
-
+				m_PlayerInputs[0].rotation = -1;
 				break;
 
 			case SDLK_RIGHT:
-				if (m_Players[0]->isAlive())
-				{
-					m_Players[0]->setRotationSpeed(PLAYER_ROTATION_SPEED);
-				}
-
+				m_PlayerInputs[0].rotation = 1;
 				break;
 
 			case SDLK_UP:
-				if (m_Players[0]->isAlive())
-				{
-					m_Players[0]->setAcceleration(PLAYER_ACCELERATION);
-				}
-
+				m_PlayerInputs[0].thrust = 1;
 				break;
 
 			case SDLK_DOWN:
-				if (m_Players[0]->isAlive())
-				{
-					m_Players[0]->setAcceleration(-PLAYER_ACCELERATION * 2 / 3);
-				}
-
+				m_PlayerInputs[0].thrust = -1;
 				break;
 
 			case SDLK_SLASH:
-				if (m_Players[0]->isAlive())
-				{
-					m_Players[0]->spawnBullet();
-				}
-
+				m_PlayerInputs[0].shoot = true;
 				break;
 
 			case SDLK_a:
-				if (m_Players[1]->isAlive())
-				{
-					m_Players[1]->setRotationSpeed(-PLAYER_ROTATION_SPEED);
-				}
-
+				m_PlayerInputs[1].rotation = -1;
 				break;
 
 			case SDLK_d:
-				if (m_Players[1]->isAlive())
-				{
-					m_Players[1]->setRotationSpeed(PLAYER_ROTATION_SPEED);
-				}
-
+				m_PlayerInputs[1].rotation = 1;
 				break;
 
 			case SDLK_w:
-				if (m_Players[1]->isAlive())
-				{
-					m_Players[1]->setAcceleration(PLAYER_ACCELERATION);
-				}
-
+				m_PlayerInputs[1].thrust = 1;
 				break;
 
 			case SDLK_s:
-				if (m_Players[1]->isAlive())
-				{
-					m_Players[1]->setAcceleration(-PLAYER_ACCELERATION * 2 / 3);
-				}
-
+				m_PlayerInputs[1].thrust = -1;
 				break;
 
 			case SDLK_c:
-				if (m_Players[1]->isAlive())
-				{
-					m_Players[1]->spawnBullet();
-				}
-
+				m_PlayerInputs[1].shoot = true;
 				break;
 			}
 
@@ -303,38 +357,22 @@ void Game::handleGameplayEvents()
 			{
 			case SDLK_LEFT:
 			case SDLK_RIGHT:
-				if (m_Players[0]->isAlive())
-				{
-					m_Players[0]->setRotationSpeed(0.0);
-				}
-
+				m_PlayerInputs[0].rotation = 0;
 				break;
 
 			case SDLK_UP:
 			case SDLK_DOWN:
-				if (m_Players[0]->isAlive())
-				{
-					m_Players[0]->setAcceleration(0.0);
-				}
-
+				m_PlayerInputs[0].thrust = 0;
 				break;
 
 			case SDLK_a:
 			case SDLK_d:
-				if (m_Players[1]->isAlive())
-				{
-					m_Players[1]->setRotationSpeed(0.0);
-				}
-
+				m_PlayerInputs[1].rotation = 0;
 				break;
 
 			case SDLK_w:
 			case SDLK_s:
-				if (m_Players[1]->isAlive())
-				{
-					m_Players[1]->setAcceleration(0.0);
-				}
-
+				m_PlayerInputs[1].thrust = 0;
 				break;
 			}
 
@@ -345,18 +383,12 @@ void Game::handleGameplayEvents()
 			{
 				if (m_Event.button.button == SDL_BUTTON_LEFT)
 				{
-					if (m_Players[2]->isAlive())
-					{
-						m_Players[2]->spawnBullet();
-					}
+					m_PlayerInputs[2].shoot = true;
 				}
 
 				else if (m_Event.button.button == SDL_BUTTON_RIGHT)
 				{
-					if (m_Players[2]->isAlive())
-					{
-						m_Players[2]->setAcceleration(PLAYER_ACCELERATION);
-					}
+					m_PlayerInputs[2].thrust = 1;
 				}
 			}
 
@@ -367,10 +399,7 @@ void Game::handleGameplayEvents()
 			{
 				if (m_Event.button.button == SDL_BUTTON_RIGHT)
 				{
-					if (m_Players[2]->isAlive())
-					{
-						m_Players[2]->setAcceleration(0.0);
-					}
+					m_PlayerInputs[2].thrust = 0;
 				}
 			}
 		}
@@ -378,150 +407,283 @@ void Game::handleGameplayEvents()
 }
 
 void Game::updateGameplay()
+{
+	ProfileScope profileScope(ProfilePhase::Update);
+
+	if (m_RollbackSession)
+	{
+		updateOnlineGameplay();
+		return;
+	}
+
+	// The round plays on the simulation thread from its first frame
+	if (!m_SimThread->isRunning())
+	{
+		m_SimThread->start((unsigned int) m_PlayerInputs.size());
+	}
+
+	// The grey player faces the cursor
+	if (m_NumberOfPlayers == 3)
+	{
+		m_PlayerInputs[2].hasAimTarget = true;
+		SDL_GetMouseState(&m_PlayerInputs[2].aimX, &m_PlayerInputs[2].aimY);
+	}
+
+	m_SimThread->sendInputs(m_PlayerInputs);
+
+	const RenderState& state = m_SimThread->getLatestState();
+
+	// Updates sprites and sounds to match the simulation
+	for (unsigned int i = 0; i < m_PlayerSprites.size(); i++)
+	{
+		m_PlayerSprites[i]->update(state.players[i]);
+	}
+
+	// Checks for end of game
+	if (state.isRoundOver)
+	{
+		m_SimThread->stop();
+
+		const SimThreadStats& stats = m_SimThread->getStats();
+		info("Round played over ", stats.ticks, " ticks, ", stats.lateTicks, " started late (average ", stats.totalLateness / std::max(stats.ticks, 1ull),
+			" ms, worst ", stats.maxLateness, " ms), slowest step ", stats.maxStepTime, " ms.");
+
+		m_ReplayRecorder.endRound(m_Simulation.getChecksum());
+
+		m_GameState = GameState::RoundOver;
+		initRoundOver();
+	}
+}
+
+void Game::updateOnlineGameplay()
 {
 	// Number of seconds since last frame
-	double dt = m_FrameTimer.getElapsed() / 1000;
+	double frameTime = m_FrameTimer.getElapsed() / 1000;
 	m_FrameTimer.reset();
 
-	if (m_NumberOfPlayers == 3)
+	if (frameTime > MAX_SIM_CATCH_UP_TIME)
 	{
-		if (m_Players[2]->isAlive())
-		{
-			int mouseX;
-			int mouseY;
-			SDL_GetMouseState(&mouseX, &mouseY);
+		frameTime = MAX_SIM_CATCH_UP_TIME;
+	}
 
-			int deltaX = mouseX - m_Players[2]->getRect().x;
-			int deltaY = mouseY - m_Players[2]->getRect().y;
+	m_SimAccumulator += frameTime;
 
-			if (deltaX * deltaX + deltaY * deltaY > 100)
-			{
-				m_Players[2]->setRotation(toDegrees(std::atan2(deltaY, deltaX)));
-			}
+	unsigned int localPlayer = m_RollbackSession->getConfig().localPlayer;
 
-			else
-			{
-				m_Players[2]->setVelocity(0.0);
-			}
-		}
+	// The grey player faces the cursor
+	if (localPlayer == 2)
+	{
+		m_PlayerInputs[2].hasAimTarget = true;
+		SDL_GetMouseState(&m_PlayerInputs[2].aimX, &m_PlayerInputs[2].aimY);
 	}
 
-	// Updates players
-	for (Player* player : m_Players)
+	double tickTime = m_Simulation.getClock().getTickTime();
+
+	while (m_SimAccumulator >= tickTime)
 	{
-		if (player->isAlive())
+		// A bot decides from the predicted world, as a person watching the screen would
+		if (m_Bots.isBot(localPlayer))
 		{
-			player->update(dt, m_WallScale, m_Barriers);
-			player->updateBullets(dt, m_Barriers);
+			m_Bots.decide(m_Simulation, m_PlayerInputs);
 		}
+
+		// Waiting on a slow peer drops the time, so this peer falls back in line with it
+		if (!m_RollbackSession->advance(m_PlayerInputs[localPlayer]))
+		{
+			m_SimAccumulator = 0.0;
+			break;
+		}
+
+		m_SimAccumulator -= tickTime;
+		m_PlayerInputs[localPlayer].shoot = false;
+	}
+
+	for (unsigned int i = 0; i < m_PlayerSprites.size(); i++)
+	{
+		m_PlayerSprites[i]->update(*m_Simulation.getPlayers()[i]);
 	}
 
-	// Checks for collisions between player and bullet
-	for (unsigned int playerIndex = 0; playerIndex < m_Players.size(); playerIndex++)
+	// A predicted win could still be rolled back, so the match only ends once it's confirmed
+	if (m_RollbackSession->getMatchFlow().matchWinner >= 0 && m_RollbackSession->isConfirmed())
 	{
-		Player* player = m_Players[playerIndex];
+		m_GameState = GameState::GameOver;
+		initGameOver();
+	}
+}
 
-		if (!player->isAlive())
+void Game::endOnlineMatch()
+{
+	delete m_RollbackSession;
+	m_RollbackSession = nullptr;
+}
+
+void Game::drawGameplay()
+{
+	ProfileScope profileScope(ProfilePhase::Draw);
+
+	SDL_RenderClear(m_Renderer);
+
+	// Draws background
+	SDL_RenderCopy(m_Renderer, m_SpaceBackgroundTexture, nullptr, &m_SpaceBackgroundRect);
+
+	// Draws barriers
+	SDL_SetRenderDrawColor(m_Renderer, 0, 191, 0, 255);
+
+	for (const Barrier& barrier : m_Simulation.getBarriers())
+	{
+		const Rect& verticalRect = barrier.getVerticalRect();
+		const Rect& horizontalRect = barrier.getHorizontalRect();
+		SDL_Rect barrierRects[2] = {
+			{ verticalRect.x, verticalRect.y, verticalRect.w, verticalRect.h },
+			{ horizontalRect.x, horizontalRect.y, horizontalRect.w, horizontalRect.h },
+		};
+
+		SDL_RenderFillRects(m_Renderer, barrierRects, 2);
+	}
+
+	// Offline rounds are drawn from the newest step the simulation thread has published, the rest
+	// straight from the simulation. Alpha is how far between the last two steps this frame is.
+	const RenderState* state = &m_RenderState;
+	double alpha;
+
+	if (m_SimThread->isRunning())
+	{
+		state = &m_SimThread->getLatestState();
+		alpha = m_SimThread->getAlpha(*state);
+	}
+
+	else
+	{
+		m_RenderState.capture(m_Simulation);
+		alpha = m_SimAccumulator / m_Simulation.getClock().getTickTime();
+	}
+
+	// Draws players
+	for (unsigned int i = 0; i < m_PlayerSprites.size(); i++)
+	{
+		const Player& player = state->players[i];
+
+		if (player.isAlive())
 		{
-			continue;
+			m_PlayerSprites[i]->draw(player, alpha);
 		}
+	}
+
+	// Draws bullets
+	for (unsigned int i = 0; i < state->bullets.size(); i++)
+	{
+		Rect rect = state->getInterpolatedBulletRect(i, alpha);
+		SDL_Rect bulletRect = { rect.x, rect.y, rect.w, rect.h };
+		SDL_RenderCopy(m_Renderer, m_BulletTexture, nullptr, &bulletRect);
+	}
+
+	// Draws wall around the combat area
+	m_Wall->draw(state->getInterpolatedWallScale(alpha));
+}
+
+void Game::handleReplayEvents()
+{
+	ProfileScope profileScope(ProfilePhase::Events);
+
+	while (SDL_PollEvent(&m_Event))
+	{
+		handleProfilerToggle();
 
-		for (Player* otherPlayer : m_Players)
+		switch (m_Event.type)
 		{
-			if (otherPlayer == player)
+		case SDL_QUIT:
+			m_Running = false;
+			break;
+
+		case SDL_KEYDOWN:
+			if (m_Event.key.keysym.sym == SDLK_ESCAPE)
 			{
-				continue;
+				m_Running = false;
 			}
 
-			for (unsigned int bulletIndex = 0; bulletIndex < otherPlayer->getBullets().size(); bulletIndex++)
+			else if (m_Event.key.keysym.sym == SDLK_LEFT)
 			{
-				Bullet* bullet = otherPlayer->getBullets()[bulletIndex];
-
-				if (SDL_HasIntersection(&player->getRect(), &bullet->getRect()))
-				{
-					player->takeHit(bullet);
-
-					delete bullet;
+				seekReplay(-REPLAY_SEEK_SECONDS);
+			}
 
-					// Removes the bullet from the vector
-					otherPlayer->getBullets().erase(otherPlayer->getBullets().begin() + bulletIndex);
-					bulletIndex -= 1;
-				}
+			else if (m_Event.key.keysym.sym == SDLK_RIGHT)
+			{
+				seekReplay(REPLAY_SEEK_SECONDS);
 			}
+
+			break;
 		}
 	}
+}
 
-	// Updates wall
-	if (m_WallScale >= 0.3 - WALL_SPEED)
+void Game::seekReplay(double seconds)
+{
+	if (!m_ReplayPlayback->canSeek())
 	{
-		m_WallScale += WALL_SPEED;
-		m_WallRect.w = (int) (m_OriginalWallWidth * m_WallScale);
-		m_WallRect.h = (int) (m_OriginalWallHeight * m_WallScale);
+		warn("Replay has no keyframes, so cannot seek.");
+		return;
 	}
 
-	// Checks for end of game
-	if (m_NumberOfPlayers == 2)
+	long long offset = (long long) m_Simulation.getClock().ticksFromMilliseconds(std::abs(seconds) * 1000);
+	long long tick = (long long) m_ReplayPlayback->getTicksPlayed() + (seconds < 0 ? -offset : offset);
+
+	if (tick < 0)
 	{
-		if ((int) m_Players[0]->isAlive() + (int) m_Players[1]->isAlive() <= 1)
-		{
-			m_GameState = GameState::RoundOver;
-			initRoundOver();
-		}
+		tick = 0;
 	}
 
-	else
+	if (m_ReplayPlayback->seek((unsigned long long) tick))
 	{
-		if ((int) m_Players[0]->isAlive() + (int) m_Players[1]->isAlive() + (int) m_Players[2]->isAlive() <= 1)
-		{
-			m_GameState = GameState::RoundOver;
-			initRoundOver();
-		}
+		m_SimAccumulator = 0.0;
 	}
 }
 
-void Game::drawGameplay()
+void Game::updateReplay()
 {
-	SDL_RenderClear(m_Renderer);
+	ProfileScope profileScope(ProfilePhase::Update);
 
-	// Draws background
-	SDL_RenderCopy(m_Renderer, m_SpaceBackgroundTexture, nullptr, &m_SpaceBackgroundRect);
+	// Number of seconds since last frame
+	double frameTime = m_FrameTimer.getElapsed() / 1000;
+	m_FrameTimer.reset();
 
-	// Draws barriers
-	for (Barrier& barrier : m_Barriers)
+	if (frameTime > MAX_SIM_CATCH_UP_TIME)
 	{
-		barrier.draw();
+		frameTime = MAX_SIM_CATCH_UP_TIME;
 	}
 
-	// Draws players
-	for (Player* player : m_Players)
+	m_SimAccumulator += frameTime;
+
+	// Plays the recorded ticks at the speed they were played
+	double tickTime = m_Simulation.getClock().getTickTime();
+
+	while (m_SimAccumulator >= tickTime)
 	{
-		if (player->isAlive())
+		if (!m_ReplayPlayback->step())
 		{
-			player->draw();
+			info("Replay finished after ", m_ReplayPlayback->getRoundsPlayed(), " rounds (", m_ReplayPlayback->getDesyncs(), " desynced).");
+			m_Running = false;
+
+			break;
 		}
 
-		player->drawBullets();
+		m_SimAccumulator -= tickTime;
 	}
 
-	// Sets the center of the wall opening to center of screen
-	m_WallRect.x = (SCREEN_WIDTH / 2) - (m_WallRect.w / 2);
-	m_WallRect.y = (SCREEN_HEIGHT / 2) - (m_WallRect.h / 2);
-
-	// Draws wall
-	SDL_RenderCopy(m_Renderer, m_WallTexture, nullptr, &m_WallRect);
-
-	SDL_RenderPresent(m_Renderer);
+	// Updates sprites and sounds to match the simulation
+	for (unsigned int i = 0; i < m_PlayerSprites.size(); i++)
+	{
+		m_PlayerSprites[i]->update(*m_Simulation.getPlayers()[i]);
+	}
 }
 
 void Game::resetGameplayNewRound()
 {
 	// Resets wall size
-	m_WallRect.w = m_OriginalWallWidth;
-	m_WallRect.h = m_OriginalWallHeight;
-	m_WallScale = 1.0;
+	m_Simulation.resetWall();
 
 	// Resets frame timer
 	m_FrameTimer.reset();
+	m_SimAccumulator = 0.0;
 }
 
 
@@ -549,21 +711,21 @@ void Game::initStartScreen()
 	m_LongGameButton = new Button(m_Renderer, "Long Game (7 Pt)");
 
 	// Makes powerup button smaller
-	m_SpeedPowerupButton->getText().setSize(16);
-	m_AccuracyPowerupButton->getText().setSize(16);
-	m_DamagePowerupButton->getText().setSize(16);
-	m_CooldownPowerupButton->getText().setSize(16);
+	m_SpeedPowerupButton->setTextSize(16);
+	m_AccuracyPowerupButton->setTextSize(16);
+	m_DamagePowerupButton->setTextSize(16);
+	m_CooldownPowerupButton->setTextSize(16);
 
 	// Makes game length buttons smaller
-	m_ShortGameButton->getText().setSize(18);
-	m_MediumGameButton->getText().setSize(18);
-	m_LongGameButton->getText().setSize(18);
+	m_ShortGameButton->setTextSize(18);
+	m_MediumGameButton->setTextSize(18);
+	m_LongGameButton->setTextSize(18);
 
 	m_StartScreenPage = StartScreenPage::NumberOfPlayersChoice;
 	m_StartScreenInitialised = true;
 
 	// Loads background texture
-	m_SpaceBackgroundTexture = IMG_LoadTexture(m_Renderer, "res/txrs/Start Screen Space.jpg");
+	m_SpaceBackgroundTexture = TextureCache::acquire("res/txrs/Start Screen Space.jpg");
 
 	if (!m_SpaceBackgroundTexture)
 	{
@@ -587,10 +749,10 @@ void Game::initStartScreen()
 	SDL_SetTextureColorMod(m_SpaceBackgroundTexture, 127, 127, 127);
 
 	// Powerup textures
-	m_SpeedPowerupTexture = IMG_LoadTexture(m_Renderer, "res/txrs/Bolt.png");
-	m_AccuracyPowerupTexture = IMG_LoadTexture(m_Renderer, "res/txrs/Crosshairs.png");
-	m_DamagePowerupTexture = IMG_LoadTexture(m_Renderer, "res/txrs/Heart.png");
-	m_CooldownPowerupTexture = IMG_LoadTexture(m_Renderer, "res/txrs/Stopwatch.png");
+	m_SpeedPowerupTexture = TextureCache::acquire("res/txrs/Bolt.png");
+	m_AccuracyPowerupTexture = TextureCache::acquire("res/txrs/Crosshairs.png");
+	m_DamagePowerupTexture = TextureCache::acquire("res/txrs/Heart.png");
+	m_CooldownPowerupTexture = TextureCache::acquire("res/txrs/Stopwatch.png");
 
 	if (!(m_SpeedPowerupTexture && m_AccuracyPowerupTexture && m_DamagePowerupTexture && m_CooldownPowerupTexture))
 	{
@@ -710,8 +872,12 @@ void Game::initStartScreen()
 
 void Game::handleStartScreenEvents()
 {
+	ProfileScope profileScope(ProfilePhase::Events);
+
 	while (SDL_PollEvent(&m_Event))
 	{
+		handleProfilerToggle();
+
 		switch (m_Event.type)
 		{
 		case SDL_QUIT:
@@ -777,7 +943,7 @@ void Game::handleStartScreenEvents()
 				if (m_NextButton->isMouseOver())
 				{
 					// Sets the powerups for the red player
-					m_Players[0]->setPowerups(m_SpeedPowerupChosen, m_AccuracyPowerupChosen, m_DamagePowerupChosen, m_CooldownPowerupChosen);
+					m_Simulation.getPlayers()[0]->setPowerups(m_SpeedPowerupChosen, m_AccuracyPowerupChosen, m_DamagePowerupChosen, m_CooldownPowerupChosen);
 
 					m_StartScreenPage = StartScreenPage::BluePowerUp;
 
@@ -800,12 +966,13 @@ void Game::handleStartScreenEvents()
 				if (m_NextButton->isMouseOver())
 				{
 					// Sets the powerups for the blue player
-					m_Players[1]->setPowerups(m_SpeedPowerupChosen, m_AccuracyPowerupChosen, m_DamagePowerupChosen, m_CooldownPowerupChosen);
+					m_Simulation.getPlayers()[1]->setPowerups(m_SpeedPowerupChosen, m_AccuracyPowerupChosen, m_DamagePowerupChosen, m_CooldownPowerupChosen);
 
 					if (m_NumberOfPlayers == 2)
 					{
 						m_GameState = GameState::Gameplay;
 						initGameplay();
+						m_ReplayRecorder.beginRound(m_Simulation);
 					}
 
 					else
@@ -827,10 +994,11 @@ void Game::handleStartScreenEvents()
 				if (m_NextButton->isMouseOver())
 				{
 					// Sets the powerups for the grey player
-					m_Players[2]->setPowerups(m_SpeedPowerupChosen, m_AccuracyPowerupChosen, m_DamagePowerupChosen, m_CooldownPowerupChosen);
+					m_Simulation.getPlayers()[2]->setPowerups(m_SpeedPowerupChosen, m_AccuracyPowerupChosen, m_DamagePowerupChosen, m_CooldownPowerupChosen);
 
 					m_GameState = GameState::Gameplay;
 					initGameplay();
+					m_ReplayRecorder.beginRound(m_Simulation);
 				}
 
 				break;
@@ -898,6 +1066,8 @@ void Game::handleStartScreenEvents()
 
 void Game::updateStartScreen()
 {
+	ProfileScope profileScope(ProfilePhase::Update);
+
 	switch (m_StartScreenPage)
 	{
 	case StartScreenPage::NumberOfPlayersChoice:
@@ -944,9 +1114,11 @@ void Game::updateStartScreen()
 
 void Game::drawStartScreen()
 {
+	ProfileScope profileScope(ProfilePhase::Draw);
+
+	// The loading screen stays up until the next frame
 	if (m_IsOnLoadingScreen)
 	{
-		m_IsOnLoadingScreen = false;
 		return;
 	}
 
@@ -1070,8 +1242,6 @@ void Game::drawStartScreen()
 	default:
 		break;
 	}
-
-	SDL_RenderPresent(m_Renderer);
 }
 
 void Game::resetStartScreenNewRound()
@@ -1081,37 +1251,53 @@ void Game::resetStartScreenNewRound()
 }
 
 
-void Game::initRoundOver()
+void Game::loadScoreText(SDL_Color colour)
 {
-	SDL_Color winningColour;
+	const std::vector<Player*>& players = m_Simulation.getPlayers();
+	char scoreText[40];
 
-	if (!m_Players[0]->isAlive() && !m_Players[1]->isAlive() && !(m_NumberOfPlayers == 3 && m_Players[2]->isAlive()))
+	if (m_NumberOfPlayers == 3)
 	{
-		winningColour = SDL_Color { 255, 255, 255, 255 };
+		std::snprintf(scoreText, sizeof(scoreText), "%u - %u - %u", players[0]->getPoints(), players[1]->getPoints(), players[2]->getPoints());
 	}
 
-	else if (m_Players[0]->isAlive())
+	else
 	{
-		m_Players[0]->addPoint();
-		winningColour = SDL_Color { 255, 0, 0, 255 };
+		std::snprintf(scoreText, sizeof(scoreText), "%u - %u", players[0]->getPoints(), players[1]->getPoints());
 	}
 
-	else if (m_Players[1]->isAlive())
+	m_ScoreCounterText.load("res/fonts/BM Space.TTF", scoreText, 48, colour, m_Renderer);
+}
+
+void Game::initRoundOver()
+{
+	SDL_Color winningColour;
+
+	switch (m_Simulation.awardRound())
 	{
-		m_Players[1]->addPoint();
+	case 0:
+		winningColour = SDL_Color { 255, 0, 0, 255 };
+		break;
+
+	case 1:
 		winningColour = SDL_Color { 0, 0, 255, 255 };
-	}
+		break;
 
-	else if (m_NumberOfPlayers == 3 && m_Players[2]->isAlive())
-	{
-		m_Players[2]->addPoint();
+	case 2:
 		winningColour = SDL_Color { 127, 127, 127, 255 };
+		break;
+
+	default:
+		winningColour = SDL_Color { 255, 255, 255, 255 };
+		break;
 	}
 
-	if (m_Players[0]->getPoints() == m_PointsToWin ||
-		m_Players[1]->getPoints() == m_PointsToWin ||
-		(m_NumberOfPlayers == 3 && m_Players[2]->getPoints() == m_PointsToWin))
+	if (m_Simulation.getPlayers()[0]->getPoints() == m_PointsToWin ||
+		m_Simulation.getPlayers()[1]->getPoints() == m_PointsToWin ||
+		(m_NumberOfPlayers == 3 && m_Simulation.getPlayers()[2]->getPoints() == m_PointsToWin))
 	{
+		finishReplay();
+
 		m_GameState = GameState::GameOver;
 		initGameOver();
 		return;
@@ -1119,14 +1305,7 @@ void Game::initRoundOver()
 
 	resetPlayers();
 
-	std::string scoreText = std::to_string(m_Players[0]->getPoints()) + " - " + std::to_string(m_Players[1]->getPoints());
-
-	if (m_NumberOfPlayers == 3)
-	{
-		scoreText += " - " + std::to_string(m_Players[2]->getPoints());
-	}
-
-	m_ScoreCounterText.load("res/fonts/BM Space.TTF", scoreText, 48, winningColour, m_Renderer);
+	loadScoreText(winningColour);
 	m_RedText.load("res/fonts/BM Space.TTF", "Red", 16, SDL_Color { 255, 0, 0, 255 }, m_Renderer);
 	m_BlueText.load("res/fonts/BM Space.TTF", "Blue", 16, SDL_Color { 0, 0, 255, 255 }, m_Renderer);
 
@@ -1138,8 +1317,12 @@ void Game::initRoundOver()
 
 void Game::handleRoundOverEvents()
 {
+	ProfileScope profileScope(ProfilePhase::Events);
+
 	while (SDL_PollEvent(&m_Event))
 	{
+		handleProfilerToggle();
+
 		switch (m_Event.type)
 		{
 		case SDL_QUIT:
@@ -1162,11 +1345,15 @@ void Game::handleRoundOverEvents()
 
 void Game::updateRoundOver()
 {
+	ProfileScope profileScope(ProfilePhase::Update);
+
 	m_NextButton->update();
 }
 
 void Game::drawRoundOver()
 {
+	ProfileScope profileScope(ProfilePhase::Draw);
+
 	SDL_RenderClear(m_Renderer);
 
 	SDL_RenderCopy(m_Renderer, m_SpaceBackgroundTexture, nullptr, &m_SpaceBackgroundRect);
@@ -1187,8 +1374,6 @@ void Game::drawRoundOver()
 	}
 
 	m_NextButton->draw(SCREEN_WIDTH * 7 / 8, SCREEN_HEIGHT * 7 / 8);
-
-	SDL_RenderPresent(m_Renderer);
 }
 
 
@@ -1198,19 +1383,19 @@ void Game::initGameOver()
 	std::string winner;
 	SDL_Color winningColour;
 
-	if (m_Players[0]->getPoints() == m_PointsToWin)
+	if (m_Simulation.getPlayers()[0]->getPoints() == m_PointsToWin)
 	{
 		winner += "Red";
 		winningColour = SDL_Color { 255, 0, 0, 255 };
 	}
 
-	else if (m_Players[1]->getPoints() == m_PointsToWin)
+	else if (m_Simulation.getPlayers()[1]->getPoints() == m_PointsToWin)
 	{
 		winner += "Blue";
 		winningColour = SDL_Color { 0, 0, 255, 255 };
 	}
 
-	else if (m_NumberOfPlayers == 3 &&  m_Players[2]->getPoints() == m_PointsToWin)
+	else if (m_NumberOfPlayers == 3 &&  m_Simulation.getPlayers()[2]->getPoints() == m_PointsToWin)
 	{
 		winner += "Grey";
 		winningColour = SDL_Color { 127, 127, 127, 255 };
@@ -1222,14 +1407,7 @@ void Game::initGameOver()
 	m_WinnerText.load("res/fonts/BM Space.TTF", winner, 48, winningColour, m_Renderer);
 
 	// Score counter
-	std::string scoreText = std::to_string(m_Players[0]->getPoints()) + " - " + std::to_string(m_Players[1]->getPoints());
-
-	if (m_NumberOfPlayers == 3)
-	{
-		scoreText += " - " + std::to_string(m_Players[2]->getPoints());
-	}
-
-	m_ScoreCounterText.load("res/fonts/BM Space.TTF", scoreText, 48, winningColour, m_Renderer);
+	loadScoreText(winningColour);
 	m_RedText.load("res/fonts/BM Space.TTF", "Red", 16, SDL_Color { 255, 0, 0, 255 }, m_Renderer);
 	m_BlueText.load("res/fonts/BM Space.TTF", "Blue", 16, SDL_Color { 0, 0, 255, 255 }, m_Renderer);
 
@@ -1241,8 +1419,12 @@ void Game::initGameOver()
 
 void Game::handleGameOverEvents()
 {
+	ProfileScope profileScope(ProfilePhase::Events);
+
 	while (SDL_PollEvent(&m_Event))
 	{
+		handleProfilerToggle();
+
 		switch (m_Event.type)
 		{
 		case SDL_QUIT:
@@ -1255,6 +1437,7 @@ void Game::handleGameOverEvents()
 				m_GameState = GameState::StartScreen;
 				m_StartScreenPage = StartScreenPage::NumberOfPlayersChoice;
 				resetPlayers(true);
+				endOnlineMatch();
 			}
 
 			break;
@@ -1264,11 +1447,21 @@ void Game::handleGameOverEvents()
 
 void Game::updateGameOver()
 {
+	ProfileScope profileScope(ProfilePhase::Update);
+
+	// Peers may still be waiting on this one's last inputs
+	if (m_RollbackSession)
+	{
+		m_RollbackSession->poll();
+	}
+
 	m_NextButton->update();
 }
 
 void Game::drawGameOver()
 {
+	ProfileScope profileScope(ProfilePhase::Draw);
+
 	SDL_RenderClear(m_Renderer);
 
 	SDL_RenderCopy(m_Renderer, m_SpaceBackgroundTexture, nullptr, &m_SpaceBackgroundRect);
@@ -1291,29 +1484,185 @@ void Game::drawGameOver()
 	m_WinnerText.draw(SCREEN_WIDTH / 2, SCREEN_HEIGHT * 14 / 20);
 
 	m_NextButton->draw(SCREEN_WIDTH * 7 / 8, SCREEN_HEIGHT * 7 / 8);
-
-	SDL_RenderPresent(m_Renderer);
 }
 
 
 void Game::initPlayers()
 {
-	// Removes old players if they exist
-	for (Player* player : m_Players)
+	// Each match gets its own seed, so its replay can repeat it exactly
+	unsigned int seed = std::random_device()();
+	m_Simulation.seed(seed);
+
+	m_Simulation.initPlayers(m_NumberOfPlayers);
+	initPlayerSprites();
+
+	m_ReplayRecorder.begin(ReplayHeader { seed, m_Simulation.getClock().getTickRate(), m_PointsToWin, (unsigned int) m_NumberOfPlayers });
+}
+
+void Game::finishReplay()
+{
+	if (!m_ReplayRecorder.isRecording())
+	{
+		return;
+	}
+
+	// A match quit part way through keeps the round in progress
+	if (m_ReplayRecorder.isInRound())
 	{
-		delete player;
+		m_ReplayRecorder.endRound(m_Simulation.getChecksum());
 	}
 
-	m_Players.clear();
+	// Nothing was played, so there is nothing to keep
+	if (m_ReplayRecorder.getRoundCount() == 0)
+	{
+		m_ReplayRecorder.cancel();
+		return;
+	}
 
-	// Initialises the players
-	m_Players.push_back(new Player(m_Renderer, PlayerColour::Red, RED_PLAYER_START_X, RED_PLAYER_START_Y, RED_PLAYER_START_DIRECTION));
-	m_Players.push_back(new Player(m_Renderer, PlayerColour::Blue, BLUE_PLAYER_START_X, BLUE_PLAYER_START_Y, BLUE_PLAYER_START_DIRECTION));
+	std::error_code errorCode;
+	std::filesystem::create_directories("replays", errorCode);
 
-	if (m_NumberOfPlayers == 3)
+	std::string path = "replays/" + std::to_string(std::time(nullptr)) + "-" + std::to_string(m_ReplayRecorder.getHeader().seed) + ".rdr";
+	m_ReplayRecorder.finish(path);
+}
+
+void Game::logPacingStats()
+{
+	const PacingConfig& config = m_Pacer.getConfig();
+	const PacingStats& active = m_Pacer.getActiveStats();
+	const PacingStats& idle = m_Pacer.getIdleStats();
+
+	if (config.mode == PacingMode::Limited)
+	{
+		info("Frame pacing: limited to ", config.frameRate, " fps.");
+	}
+
+	else
+	{
+		info("Frame pacing: ", FramePacer::getModeName(config.mode), ".");
+	}
+
+	if (active.frames > 0)
+	{
+		info("  Playing: ", active.frames, " frames, average ", active.getAverageFrameTime(), " ms, jitter ", active.getJitter(),
+			" ms, worst ", active.maxFrameTime, " ms, ", active.getCpuPercent(), "% CPU.");
+	}
+
+	if (idle.frames > 0)
+	{
+		info("  Menus: ", idle.frames, " frames, average ", idle.getAverageFrameTime(), " ms, ", idle.getCpuPercent(), "% CPU.");
+	}
+}
+
+void Game::checkFrameAllocations(GameState frameState)
+{
+	// Frames that start or end a round are allowed to allocate, as are the first few of one
+	if (frameState != GameState::Gameplay || m_GameState != GameState::Gameplay)
+	{
+		m_SteadyGameplayFrames = 0;
+		m_AllocationReported = false;
+
+		return;
+	}
+
+	m_SteadyGameplayFrames += 1;
+
+	if (!m_AssertNoAllocations || m_AllocationReported || m_SteadyGameplayFrames <= ALLOCATION_CHECK_GRACE_FRAMES)
 	{
-		m_Players.push_back(new Player(m_Renderer, PlayerColour::Grey, GREY_PLAYER_START_X, GREY_PLAYER_START_Y, GREY_PLAYER_START_DIRECTION));
+		return;
 	}
+
+	AllocationCounts frame = Profiler::getLastFrameAllocations();
+
+	if (frame.allocations == 0)
+	{
+		return;
+	}
+
+	// Whatever the top-level phases don't account for was on other threads (or between phases)
+	AllocationCounts events = Profiler::getLastAllocations(ProfilePhase::Events);
+	AllocationCounts update = Profiler::getLastAllocations(ProfilePhase::Update);
+	AllocationCounts draw = Profiler::getLastAllocations(ProfilePhase::Draw);
+	AllocationCounts present = Profiler::getLastAllocations(ProfilePhase::Present);
+	unsigned long long elsewhere = frame.allocations - events.allocations - update.allocations - draw.allocations - present.allocations;
+
+	error("Gameplay frame ", m_SteadyGameplayFrames, " of the round allocated ", frame.allocations, " times (", frame.bytes, " bytes): events ", events.allocations,
+		", update ", update.allocations, ", draw ", draw.allocations, ", present ", present.allocations, ", elsewhere ", elsewhere, ".");
+
+	// Once a round is enough to find the cause
+	m_AllocationReported = true;
+	SDL_assert_release(frame.allocations == 0);
+}
+
+void Game::playReplay(const std::string& path)
+{
+	if (!m_Running)
+	{
+		return;
+	}
+
+	m_ReplayPlayback = new ReplayPlayback(m_Simulation);
+
+	if (!m_ReplayPlayback->open(path))
+	{
+		m_Running = false;
+		return;
+	}
+
+	m_NumberOfPlayers = m_ReplayPlayback->getHeader().playerCount;
+	initPlayerSprites();
+
+	initGameplay();
+	m_GameState = GameState::Replay;
+
+	m_FrameTimer.reset();
+	m_SimAccumulator = 0.0;
+}
+
+void Game::playOnline(const RollbackConfig& config, const std::vector<NetAddress>& peers, const NetworkConditions& conditions)
+{
+	if (!m_Running)
+	{
+		return;
+	}
+
+	m_RollbackSession = new RollbackSession(m_Simulation, config);
+
+	// Address of the local player is the one to listen on
+	if (config.localPlayer >= peers.size() || !m_RollbackSession->start(peers[config.localPlayer].port, peers, conditions))
+	{
+		m_Running = false;
+		return;
+	}
+
+	// Online matches have no powerups and aren't recorded
+	m_NumberOfPlayers = (int) config.playerCount;
+	m_PointsToWin = config.pointsToWin;
+	initPlayerSprites();
+
+	initGameplay();
+	m_GameState = GameState::Gameplay;
+
+	m_FrameTimer.reset();
+	m_SimAccumulator = 0.0;
+}
+
+void Game::initPlayerSprites()
+{
+	// Replaces the old sprites to match the new players
+	for (PlayerSprite* sprite : m_PlayerSprites)
+	{
+		delete sprite;
+	}
+
+	m_PlayerSprites.clear();
+
+	for (Player* player : m_Simulation.getPlayers())
+	{
+		m_PlayerSprites.push_back(new PlayerSprite(m_Renderer, player->getColour()));
+	}
+
+	m_PlayerInputs.assign(m_Simulation.getPlayers().size(), PlayerInput {});
 }
 
 void Game::drawLoadingScreen()
@@ -1326,13 +1675,64 @@ void Game::drawLoadingScreen()
 	SDL_RenderPresent(m_Renderer);
 }
 
+void Game::handleProfilerToggle()
+{
+	if (m_Event.type == SDL_KEYDOWN && m_Event.key.keysym.sym == SDLK_F3 && m_Event.key.repeat == 0)
+	{
+		m_ShowProfiler = !m_ShowProfiler;
+		m_FramesSinceProfilerRefresh = PROFILER_OVERLAY_REFRESH_FRAMES;
+	}
+}
+
+void Game::drawProfilerOverlay()
+{
+	// Re-rendering text every frame would show up in the profile
+	if (m_FramesSinceProfilerRefresh >= PROFILER_OVERLAY_REFRESH_FRAMES)
+	{
+		m_FramesSinceProfilerRefresh = 0;
+
+		for (unsigned int i = 0; i < m_ProfilerTexts.size(); i++)
+		{
+			ProfilePhase phase = (ProfilePhase) i;
+			ProfileStats stats = phase == ProfilePhase::Count ? Profiler::getFrameStats() : Profiler::getStats(phase);
+			const char* name = phase == ProfilePhase::Count ? "frame" : Profiler::getPhaseName(phase);
+
+			char line[80];
+			std::snprintf(line, sizeof(line), "%-10s %6.2f avg %6.2f p99 ms %6.1f allocs", name, stats.average, stats.p99, stats.allocations);
+			m_ProfilerTexts[i]->setText(line);
+		}
+	}
+
+	m_FramesSinceProfilerRefresh += 1;
+
+	// Darkens the area behind the text
+	SDL_Rect background = { 0, 0, 360, (int) m_ProfilerTexts.size() * 18 + 8 };
+	SDL_BlendMode previousBlendMode;
+	SDL_GetRenderDrawBlendMode(m_Renderer, &previousBlendMode);
+	SDL_SetRenderDrawBlendMode(m_Renderer, SDL_BLENDMODE_BLEND);
+	SDL_SetRenderDrawColor(m_Renderer, 0, 0, 0, 160);
+	SDL_RenderFillRect(m_Renderer, &background);
+	SDL_SetRenderDrawBlendMode(m_Renderer, previousBlendMode);
+	SDL_SetRenderDrawColor(m_Renderer, 0, 0, 0, 255);
+
+	for (unsigned int i = 0; i < m_ProfilerTexts.size(); i++)
+	{
+		const SDL_Rect& rect = m_ProfilerTexts[i]->getRect();
+		m_ProfilerTexts[i]->draw(8 + rect.w / 2, 4 + i * 18 + rect.h / 2);
+	}
+}
+
 void Game::resetPlayers(bool completeReset)
 {
-	for (Player* player : m_Players)
+	m_Simulation.resetPlayers(completeReset);
+
+	for (PlayerSprite* sprite : m_PlayerSprites)
 	{
-		player->reset(completeReset);
-		player->setLifeLeft((int) PLAYER_STARTING_LIFE); // BUG: Should be done in reset(), doesn't work
+		sprite->stopSounds();
 	}
+
+	// Releases any controls held when the round ended
+	m_PlayerInputs.assign(m_Simulation.getPlayers().size(), PlayerInput {});
 }
 
 void Game::initAudio()
@@ -1341,5 +1741,5 @@ void Game::initAudio()
 	Mix_VolumeMusic(32);
 	Mix_PlayMusic(m_BackgroundMusic, -1);
 
-	Player::initAudio();
+	PlayerSprite::initAudio();
 }
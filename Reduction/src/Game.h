@@ -6,12 +6,20 @@
 #include <SDL/SDL_ttf.h>
 #include <SDL/SDL_mixer.h>
 
-#include "entities/Player.h"
-#include "entities/Bullet.h"
+#include "sim/Simulation.h"
+#include "sim/PlayerInput.h"
+#include "sim/BotRoster.h"
+#include "sim/RenderState.h"
+#include "sim/SimThread.h"
 #include "utils/Timer.h"
+#include "utils/FramePacer.h"
 #include "gfx/Text.h"
 #include "gfx/Button.h"
-#include "gfx/Barrier.h"
+#include "gfx/PlayerSprite.h"
+#include "gfx/Wall.h"
+#include "replay/ReplayRecorder.h"
+#include "replay/ReplayPlayback.h"
+#include "net/RollbackSession.h"
 
 
 enum class GameState
@@ -20,6 +28,7 @@ enum class GameState
 	Gameplay,
 	RoundOver,
 	GameOver,
+	Replay,
 };
 
 enum class StartScreenPage
@@ -58,18 +67,42 @@ private:
 	Button* m_TwoPlayersButton;
 	Button* m_ThreePlayersButton;
 
-	// Players
-	std::vector<Player*> m_Players;
+	// Gameplay state and rules
+	Simulation m_Simulation;
+
+	// Draws each player (same order as the simulation's players)
+	std::vector<PlayerSprite*> m_PlayerSprites;
+
+	// Controls currently held by each player
+	std::vector<PlayerInput> m_PlayerInputs;
+	// Slots played by the computer, whose inputs replace the controls above
+	BotRoster m_Bots;
+
+	// Plays offline rounds away from the render thread
+	SimThread* m_SimThread = nullptr;
+	// What is drawn when the simulation runs on this thread (replays and online matches)
+	RenderState m_RenderState;
+
+	// Records every match played, and plays one back when asked to
+	ReplayRecorder m_ReplayRecorder;
+	ReplayPlayback* m_ReplayPlayback = nullptr;
+
+	// Plays against other peers over the network instead of on one keyboard
+	RollbackSession* m_RollbackSession = nullptr;
 
 	// FPS clock
 	Timer m_FrameTimer;
+	// Holds the loop to the frame rate, and measures what frames cost
+	FramePacer m_Pacer;
+
+	// Frame time not yet simulated, in seconds
+	double m_SimAccumulator = 0.0;
+
+	// Shared by every bullet
+	SDL_Texture* m_BulletTexture = nullptr;
 
 	// Wall
-	double m_WallScale = 1;
-	SDL_Texture* m_WallTexture;
-	SDL_Rect m_WallRect;
-	unsigned int m_OriginalWallWidth;
-	unsigned int m_OriginalWallHeight;
+	Wall* m_Wall = nullptr;
 
 	// Background
 	SDL_Texture* m_SpaceBackgroundTexture = nullptr;
@@ -139,8 +172,15 @@ private:
 	// Audio
 	Mix_Music* m_BackgroundMusic;
 
-	// Barriers
-	std::vector<Barrier> m_Barriers;
+	// Reports allocations in gameplay frames once a round has settled (--assert-no-alloc)
+	bool m_AssertNoAllocations = false;
+	unsigned int m_SteadyGameplayFrames = 0;
+	bool m_AllocationReported = false;
+
+	// Frame profiler overlay (one line per phase, then the whole frame)
+	bool m_ShowProfiler = false;
+	std::vector<Text*> m_ProfilerTexts;
+	unsigned int m_FramesSinceProfilerRefresh = 0;
 
 private:
 	// Initialises the start screen
@@ -165,6 +205,8 @@ private:
 	// Resets the gameplay state for a new round
 	void resetGameplayNewRound();
 
+	// Loads the score counter shown between rounds and at the end
+	void loadScoreText(SDL_Color colour);
 	// Initialises the round over state
 	void initRoundOver();
 	// Handles user input for round over state
@@ -183,11 +225,37 @@ private:
 	// Renders game over state to the screen
 	void drawGameOver();
 
+	// Plays the online match in real time, ending it once every peer agrees on a winner
+	void updateOnlineGameplay();
+	// Leaves the online match, if there is one
+	void endOnlineMatch();
+
+	// Handles user input while watching a replay
+	void handleReplayEvents();
+	// Plays the replay in real time
+	void updateReplay();
+	// Jumps the replay forwards or backwards (negative seconds)
+	void seekReplay(double seconds);
+
 	// Draws the loading screen
 	void drawLoadingScreen();
 
-	// Initialises the players
+	// Shows or hides the profiler overlay on F3 (call for every polled event)
+	void handleProfilerToggle();
+	// Draws the profiler overlay, refreshing its text every few frames
+	void drawProfilerOverlay();
+
+	// Initialises the players and starts recording a new match
 	void initPlayers();
+	// Creates a sprite for each simulated player
+	void initPlayerSprites();
+
+	// Writes out the match being recorded, if any rounds were played
+	void finishReplay();
+	// Logs what the frames cost, split into menus and the rest
+	void logPacingStats();
+	// Reports the last frame's allocations if it was a steady gameplay frame (state is the one it started in)
+	void checkFrameAllocations(GameState frameState);
 
 	// Resets the players
 	void resetPlayers(bool completeReset = false);
@@ -196,9 +264,18 @@ private:
 	void initAudio();
 
 public:
-	Game();
+	explicit Game(const PacingConfig& pacing = PacingConfig());
 	~Game();
 
 	// Runs the main-loop
 	void run();
+
+	// Watches a recorded match instead of showing the menus (call before run)
+	void playReplay(const std::string& path);
+	// Joins an online match instead of showing the menus (call before run), peers are indexed by player
+	void playOnline(const RollbackConfig& config, const std::vector<NetAddress>& peers, const NetworkConditions& conditions);
+	// Treats any allocation in a settled gameplay frame as an error (call before run)
+	void assertNoAllocations() { m_AssertNoAllocations = true; }
+	// Hands a player slot to the built-in bot for every match (call before run)
+	void addBot(unsigned int slot) { m_Bots.setBot(slot, new DefaultBot()); }
 };
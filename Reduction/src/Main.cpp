@@ -1,9 +1,204 @@
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
 #include "Game.h"
+#include "utils/AllocationTracker.h"
+#include "utils/Log.h"
+
+
+// SDL's own allocator, which the counting functions pass everything on to
+static SDL_malloc_func s_SdlMalloc = nullptr;
+static SDL_calloc_func s_SdlCalloc = nullptr;
+static SDL_realloc_func s_SdlRealloc = nullptr;
+static SDL_free_func s_SdlFree = nullptr;
+
+static void* SDLCALL countSdlMalloc(size_t size)
+{
+	AllocationTracker::count(size);
+	return s_SdlMalloc(size);
+}
+
+static void* SDLCALL countSdlCalloc(size_t count, size_t size)
+{
+	AllocationTracker::count(count * size);
+	return s_SdlCalloc(count, size);
+}
+
+static void* SDLCALL countSdlRealloc(void* pointer, size_t size)
+{
+	AllocationTracker::count(size);
+	return s_SdlRealloc(pointer, size);
+}
+
+static void SDLCALL countSdlFree(void* pointer)
+{
+	s_SdlFree(pointer);
+}
+
+// Counts SDL's allocations along with the game's (before SDL allocates anything, so every block
+// it frees went through the same functions)
+static void countSdlAllocations()
+{
+	SDL_GetMemoryFunctions(&s_SdlMalloc, &s_SdlCalloc, &s_SdlRealloc, &s_SdlFree);
+
+	if (SDL_SetMemoryFunctions(countSdlMalloc, countSdlCalloc, countSdlRealloc, countSdlFree) != 0)
+	{
+		warn("Could not count SDL's allocations.\nSDL_Error: ", SDL_GetError());
+	}
+}
+
+
+// Reads "--online <player> <address> <address> [address]" and its options into a match to join
+// (addresses are "ip:port" or just a port on localhost, one per player, the local one is listened on)
+static bool parseOnlineArguments(int argc, char* argv[], RollbackConfig& config, std::vector<NetAddress>& peers, NetworkConditions& conditions)
+{
+	int argument = 2;
+	config.localPlayer = (unsigned int) std::atoi(argv[argument++]);
+
+	while (argument < argc && std::strncmp(argv[argument], "--", 2) != 0)
+	{
+		NetAddress address;
+
+		if (!NetAddress::parse(argv[argument++], address))
+		{
+			error("Bad peer address: ", argv[argument - 1]);
+			return false;
+		}
+
+		peers.push_back(address);
+	}
+
+	config.playerCount = (unsigned int) peers.size();
+
+	// Every peer must be given the same seed and points to win
+	while (argument < argc)
+	{
+		const char* option = argv[argument++];
+
+		// Read by main(), and take no value
+		if (std::strcmp(option, "--vsync") == 0 || std::strcmp(option, "--unlimited") == 0 || std::strcmp(option, "--assert-no-alloc") == 0)
+		{
+			continue;
+		}
+
+		if (argument == argc)
+		{
+			error("Missing value for option: ", option);
+			return false;
+		}
+
+		const char* value = argv[argument++];
+
+		if (std::strcmp(option, "--seed") == 0)
+		{
+			config.seed = (unsigned int) std::strtoul(value, nullptr, 10);
+		}
+
+		else if (std::strcmp(option, "--points") == 0)
+		{
+			config.pointsToWin = (unsigned int) std::atoi(value);
+		}
+
+		else if (std::strcmp(option, "--latency") == 0)
+		{
+			conditions.latencyMilliseconds = std::atof(value);
+		}
+
+		else if (std::strcmp(option, "--jitter") == 0)
+		{
+			conditions.jitterMilliseconds = std::atof(value);
+		}
+
+		else if (std::strcmp(option, "--loss") == 0)
+		{
+			conditions.lossChance = std::atof(value) / 100;
+		}
+
+		// Read by main()
+		else if (std::strcmp(option, "--bot") == 0 || std::strcmp(option, "--fps") == 0)
+		{
+		}
+
+		else
+		{
+			error("Unknown option: ", option);
+			return false;
+		}
+	}
+
+	return true;
+}
 
 
 int main(int argc, char* argv[])
 {
-	Game* reduction = new Game();
+	countSdlAllocations();
+
+	// "--fps <rate>" changes the frame rate limit, "--vsync" waits for the display instead and "--unlimited" doesn't wait at all
+	PacingConfig pacing;
+
+	for (int argument = 1; argument < argc; argument++)
+	{
+		if (std::strcmp(argv[argument], "--fps") == 0 && argument + 1 < argc)
+		{
+			pacing.mode = PacingMode::Limited;
+			pacing.frameRate = std::atof(argv[argument + 1]);
+		}
+
+		else if (std::strcmp(argv[argument], "--vsync") == 0)
+		{
+			pacing.mode = PacingMode::VSync;
+		}
+
+		else if (std::strcmp(argv[argument], "--unlimited") == 0)
+		{
+			pacing.mode = PacingMode::Unlimited;
+		}
+	}
+
+	Game* reduction = new Game(pacing);
+
+	// "--assert-no-alloc" treats any allocation in a settled gameplay frame as an error
+	for (int argument = 1; argument < argc; argument++)
+	{
+		if (std::strcmp(argv[argument], "--assert-no-alloc") == 0)
+		{
+			reduction->assertNoAllocations();
+		}
+	}
+
+	// "--bot <slot>" (any number of times) lets the computer play a slot
+	for (int argument = 1; argument + 1 < argc; argument++)
+	{
+		if (std::strcmp(argv[argument], "--bot") == 0)
+		{
+			reduction->addBot((unsigned int) std::atoi(argv[argument + 1]));
+		}
+	}
+
+	// "--replay <file>" watches a recorded match
+	if (argc > 2 && std::strcmp(argv[1], "--replay") == 0)
+	{
+		reduction->playReplay(argv[2]);
+	}
+
+	// "--online <player> <addresses...> [--seed n] [--points n] [--latency ms] [--jitter ms] [--loss percent]"
+	else if (argc > 2 && std::strcmp(argv[1], "--online") == 0)
+	{
+		RollbackConfig config;
+		std::vector<NetAddress> peers;
+		NetworkConditions conditions;
+
+		if (!parseOnlineArguments(argc, argv, config, peers, conditions))
+		{
+			delete reduction;
+			return 1;
+		}
+
+		reduction->playOnline(config, peers, conditions);
+	}
+
 	reduction->run();
 	delete reduction;
 
@@ -1,11 +1,9 @@
 #include "Barrier.h"
 
-#include "utils/Log.h"
 #include "utils/Settings.h"
 
 
-Barrier::Barrier(SDL_Renderer* renderer, int xPos, int yPos)
-	: m_Renderer(renderer)
+Barrier::Barrier(int xPos, int yPos)
 {
 	m_VerticalRect.w = BARRIER_WIDTH;
 	m_VerticalRect.h = BARRIER_LENGTH;
@@ -36,11 +34,3 @@ Barrier::Barrier(SDL_Renderer* renderer, int xPos, int yPos)
 		m_HorizontalRect.y = yPos;
 	}
 }
-
-
-void Barrier::draw()
-{
-	SDL_SetRenderDrawColor(m_Renderer, 0, 191, 0, 255);
-	SDL_RenderFillRect(m_Renderer, &m_VerticalRect);
-	SDL_RenderFillRect(m_Renderer, &m_HorizontalRect);
-}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "utils/Rect.h"
+
+
+class Barrier
+{
+	Rect m_VerticalRect;
+	Rect m_HorizontalRect;
+
+	// Rotation of the barrier
+	double m_Rotation = 0.0;
+
+public:
+	Barrier(int xPos, int yPos);
+
+	const Rect& getHorizontalRect() const { return m_HorizontalRect; }
+	const Rect& getVerticalRect() const { return m_VerticalRect; }
+};
@@ -0,0 +1,232 @@
+#include "BulletPool.h"
+
+#include "utils/ByteIO.h"
+#include "utils/MathUtils.h"
+
+
+BulletPool::BulletPool(unsigned int capacity)
+	: m_Capacity(capacity),
+	m_PosX(capacity), m_PosY(capacity), m_PrevPosX(capacity), m_PrevPosY(capacity),
+	m_VelX(capacity), m_VelY(capacity), m_Owner(capacity), m_Damage(capacity), m_Alive(capacity)
+{
+}
+
+
+bool BulletPool::spawn(double direction, double posX, double posY, unsigned int owner, int damage)
+{
+	if (m_Count == m_Capacity)
+	{
+		return false;
+	}
+
+	unsigned int index = m_Count;
+	m_Count += 1;
+
+	m_PosX[index] = posX;
+	m_PosY[index] = posY;
+	m_PrevPosX[index] = posX;
+	m_PrevPosY[index] = posY;
+	m_VelX[index] = std::cos(toRadians(direction)) * BULLET_SPEED;
+	m_VelY[index] = std::sin(toRadians(direction)) * BULLET_SPEED;
+	m_Owner[index] = (unsigned char) owner;
+	m_Damage[index] = damage;
+	m_Alive[index] = 1;
+
+	return true;
+}
+
+void BulletPool::update(double dt, const BarrierGrid& barriers)
+{
+	integrate(dt);
+	killOutOfBounds();
+	killInsideBarriers(barriers);
+}
+
+void BulletPool::integrate(double dt)
+{
+	// Plain arithmetic over contiguous arrays with no branches, so the
+	// compiler can vectorise it (dead bullets move too, that's harmless)
+	double* __restrict posX = m_PosX.data();
+	double* __restrict posY = m_PosY.data();
+	double* __restrict prevPosX = m_PrevPosX.data();
+	double* __restrict prevPosY = m_PrevPosY.data();
+	const double* __restrict velX = m_VelX.data();
+	const double* __restrict velY = m_VelY.data();
+
+	for (unsigned int i = 0; i < m_Count; i++)
+	{
+		prevPosX[i] = posX[i];
+		prevPosY[i] = posY[i];
+		posX[i] += velX[i] * dt;
+		posY[i] += velY[i] * dt;
+	}
+}
+
+void BulletPool::killOutOfBounds()
+{
+	const double* __restrict posX = m_PosX.data();
+	const double* __restrict posY = m_PosY.data();
+	unsigned char* __restrict alive = m_Alive.data();
+	unsigned int deadCount = 0;
+
+	for (unsigned int i = 0; i < m_Count; i++)
+	{
+		unsigned char inBounds = (unsigned char) ((posX[i] >= 0.0) & (posX[i] <= SCREEN_WIDTH) & (posY[i] >= 0.0) & (posY[i] <= SCREEN_HEIGHT));
+
+		deadCount += alive[i] & (inBounds ^ 1);
+		alive[i] &= inBounds;
+	}
+
+	m_DeadCount += deadCount;
+}
+
+void BulletPool::killInsideBarriers(const BarrierGrid& barriers)
+{
+	for (unsigned int i = 0; i < m_Count; i++)
+	{
+		if (m_Alive[i] && barriers.intersects(getRect(i)))
+		{
+			kill(i);
+		}
+	}
+}
+
+void BulletPool::fillGrid(SpatialGrid& grid) const
+{
+	grid.clear();
+
+	for (unsigned int i = 0; i < m_Count; i++)
+	{
+		if (m_Alive[i])
+		{
+			grid.insertPoint(i, (int) m_PosX[i], (int) m_PosY[i]);
+		}
+	}
+
+	grid.build();
+}
+
+void BulletPool::kill(unsigned int index)
+{
+	if (m_Alive[index])
+	{
+		m_Alive[index] = 0;
+		m_DeadCount += 1;
+	}
+}
+
+void BulletPool::compact()
+{
+	if (m_DeadCount == 0)
+	{
+		return;
+	}
+
+	unsigned int i = 0;
+
+	while (i < m_Count)
+	{
+		if (m_Alive[i])
+		{
+			i += 1;
+		}
+
+		else
+		{
+			// The swapped-in bullet could be dead too, so i is checked again
+			swapRemove(i);
+		}
+	}
+
+	m_DeadCount = 0;
+}
+
+void BulletPool::clear()
+{
+	m_Count = 0;
+	m_DeadCount = 0;
+}
+
+void BulletPool::swapRemove(unsigned int index)
+{
+	unsigned int last = m_Count - 1;
+
+	m_PosX[index] = m_PosX[last];
+	m_PosY[index] = m_PosY[last];
+	m_PrevPosX[index] = m_PrevPosX[last];
+	m_PrevPosY[index] = m_PrevPosY[last];
+	m_VelX[index] = m_VelX[last];
+	m_VelY[index] = m_VelY[last];
+	m_Owner[index] = m_Owner[last];
+	m_Damage[index] = m_Damage[last];
+	m_Alive[index] = m_Alive[last];
+
+	m_Count = last;
+}
+
+Rect BulletPool::getInterpolatedRect(unsigned int index, double alpha) const
+{
+	Rect rect = getRect(index);
+	rect.x = (int) (m_PrevPosX[index] + (m_PosX[index] - m_PrevPosX[index]) * alpha);
+	rect.y = (int) (m_PrevPosY[index] + (m_PosY[index] - m_PrevPosY[index]) * alpha);
+
+	return rect;
+}
+
+
+void BulletPool::saveState(std::vector<unsigned char>& out) const
+{
+	// Only the first m_Count entries of each array are in use
+	writePod(out, m_Count);
+	writeBytes(out, m_PosX.data(), m_Count * sizeof(double));
+	writeBytes(out, m_PosY.data(), m_Count * sizeof(double));
+	writeBytes(out, m_PrevPosX.data(), m_Count * sizeof(double));
+	writeBytes(out, m_PrevPosY.data(), m_Count * sizeof(double));
+	writeBytes(out, m_VelX.data(), m_Count * sizeof(double));
+	writeBytes(out, m_VelY.data(), m_Count * sizeof(double));
+	writeBytes(out, m_Owner.data(), m_Count * sizeof(unsigned char));
+	writeBytes(out, m_Damage.data(), m_Count * sizeof(int));
+	writeBytes(out, m_Alive.data(), m_Count * sizeof(unsigned char));
+}
+
+bool BulletPool::loadState(const unsigned char* data, size_t size, size_t& offset)
+{
+	unsigned int count;
+
+	if (!readPod(data, size, offset, count) || count > m_Capacity)
+	{
+		return false;
+	}
+
+	bool loaded = readBytes(data, size, offset, m_PosX.data(), count * sizeof(double))
+		&& readBytes(data, size, offset, m_PosY.data(), count * sizeof(double))
+		&& readBytes(data, size, offset, m_PrevPosX.data(), count * sizeof(double))
+		&& readBytes(data, size, offset, m_PrevPosY.data(), count * sizeof(double))
+		&& readBytes(data, size, offset, m_VelX.data(), count * sizeof(double))
+		&& readBytes(data, size, offset, m_VelY.data(), count * sizeof(double))
+		&& readBytes(data, size, offset, m_Owner.data(), count * sizeof(unsigned char))
+		&& readBytes(data, size, offset, m_Damage.data(), count * sizeof(int))
+		&& readBytes(data, size, offset, m_Alive.data(), count * sizeof(unsigned char));
+
+	m_Count = loaded ? count : 0;
+	m_DeadCount = 0;
+
+	for (unsigned int i = 0; i < m_Count; i++)
+	{
+		m_DeadCount += (unsigned int) (m_Alive[i] == 0);
+	}
+
+	return loaded;
+}
+
+size_t BulletPool::getMaxStateSize() const
+{
+	size_t bytesPerBullet = 6 * sizeof(double) + 2 * sizeof(unsigned char) + sizeof(int);
+	return sizeof(m_Count) + m_Capacity * bytesPerBullet;
+}
+
+size_t BulletPool::getMemoryUsage() const
+{
+	size_t doubles = m_PosX.capacity() + m_PosY.capacity() + m_PrevPosX.capacity() + m_PrevPosY.capacity() + m_VelX.capacity() + m_VelY.capacity();
+	return doubles * sizeof(double) + m_Owner.capacity() + m_Damage.capacity() * sizeof(int) + m_Alive.capacity();
+}
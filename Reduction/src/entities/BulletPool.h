@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "sim/BarrierGrid.h"
+#include "sim/SpatialGrid.h"
+#include "utils/Rect.h"
+#include "utils/Settings.h"
+
+
+// Every bullet in play, stored as parallel arrays in one preallocated block
+class BulletPool
+{
+private:
+	// Most bullets that can be alive at once
+	unsigned int m_Capacity;
+	unsigned int m_Count = 0;
+
+	// Current and last-step positions (last-step is for render interpolation)
+	std::vector<double> m_PosX;
+	std::vector<double> m_PosY;
+	std::vector<double> m_PrevPosX;
+	std::vector<double> m_PrevPosY;
+
+	// Velocity in pixels per second, worked out once when fired
+	std::vector<double> m_VelX;
+	std::vector<double> m_VelY;
+
+	// Index of the player that fired it, and how much life it takes on a hit
+	std::vector<unsigned char> m_Owner;
+	std::vector<int> m_Damage;
+
+	// Cleared by kill(), dead bullets are removed in one pass by compact()
+	std::vector<unsigned char> m_Alive;
+	unsigned int m_DeadCount = 0;
+
+private:
+	// Moves the last bullet into index
+	void swapRemove(unsigned int index);
+
+public:
+	explicit BulletPool(unsigned int capacity = BULLET_POOL_CAPACITY);
+
+	// Adds a bullet, returns false if the pool is full
+	bool spawn(double direction, double posX, double posY, unsigned int owner, int damage);
+
+	// Moves every bullet, killing those that leave the screen or hit a barrier
+	void update(double dt, const BarrierGrid& barriers);
+
+	// Steps of update(), exposed so they can be benchmarked separately
+	void integrate(double dt);
+	void killOutOfBounds();
+	void killInsideBarriers(const BarrierGrid& barriers);
+
+	// Buckets every live bullet by its top-left corner
+	void fillGrid(SpatialGrid& grid) const;
+
+	// Marks a bullet as dead (it stays in place until compact())
+	void kill(unsigned int index);
+	// Removes dead bullets by swapping the last live ones into their slots
+	void compact();
+	// Removes all bullets
+	void clear();
+
+	// Appends the live bullets to a snapshot, and reads them back (false if the data doesn't fit)
+	void saveState(std::vector<unsigned char>& out) const;
+	bool loadState(const unsigned char* data, size_t size, size_t& offset);
+	// Most bytes saveState() can write (with the pool full)
+	size_t getMaxStateSize() const;
+	// Bytes allocated on the heap
+	size_t getMemoryUsage() const;
+
+	unsigned int size() const { return m_Count; }
+	unsigned int getCapacity() const { return m_Capacity; }
+
+	bool isAlive(unsigned int index) const { return m_Alive[index] != 0; }
+	unsigned int getOwner(unsigned int index) const { return m_Owner[index]; }
+	int getDamage(unsigned int index) const { return m_Damage[index]; }
+	double getPosX(unsigned int index) const { return m_PosX[index]; }
+	double getPosY(unsigned int index) const { return m_PosY[index]; }
+	double getPrevPosX(unsigned int index) const { return m_PrevPosX[index]; }
+	double getPrevPosY(unsigned int index) const { return m_PrevPosY[index]; }
+	double getVelX(unsigned int index) const { return m_VelX[index]; }
+	double getVelY(unsigned int index) const { return m_VelY[index]; }
+
+	Rect getRect(unsigned int index) const { return Rect { (int) m_PosX[index], (int) m_PosY[index], BULLET_WIDTH, BULLET_HEIGHT }; }
+	// Rect blended between the last two steps (alpha from 0 to 1)
+	Rect getInterpolatedRect(unsigned int index, double alpha) const;
+};
@@ -1,125 +1,36 @@
 #include "Player.h"
 
+#include <cmath>
+
 #include "utils/Log.h"
 #include "utils/Settings.h"
 #include "utils/MathUtils.h"
-#include "utils/Random.h"
-
-
-Mix_Chunk* Player::s_ShootSound = nullptr;
-Mix_Chunk* Player::s_DeathSound = nullptr;
-Mix_Chunk* Player::s_EngineSound = nullptr;
-
-void Player::initAudio()
-{
-	s_ShootSound = Mix_LoadWAV("res/audio/Shoot Sound.mp3");
-	Mix_VolumeChunk(s_ShootSound, 32);
-	s_DeathSound = Mix_LoadWAV("res/audio/DeathFlash.mp3");
-	s_EngineSound = Mix_LoadWAV("res/audio/Rocket Thrusters.mp3");
-}
 
 
-Player::Player(SDL_Renderer* renderer, PlayerColour colour, double posX, double posY, double direction)
-	: m_Renderer(renderer), m_Colour(colour)
+Player::Player(PlayerColour colour, double posX, double posY, double direction)
+	: m_Colour(colour)
 {
-	std::string file;
-
-	switch (colour)
-	{
-	case PlayerColour::Red:
-		file.append("res/txrs/players/Red Spaceship");
-		break;
-
-	case PlayerColour::Blue:
-		file.append("res/txrs/players/Blue Spaceship");
-		break;
-
-	case PlayerColour::Grey:
-		file.append("res/txrs/players/Grey Spaceship");
-		break;
-
-	default:
-		error("Unhandled player colour case.");
-		return;
-	}
-
-	// Loads the texture
-	std::string filename = file + ".png";
-	m_NoFlameTexture = IMG_LoadTexture(m_Renderer, filename.c_str());
-	filename = file + " - Small Flame.png";
-	m_SmallFlameTexture = IMG_LoadTexture(m_Renderer, filename.c_str());
-	filename = file + " - Medium Flame.png";
-	m_MediumFlameTexture = IMG_LoadTexture(m_Renderer, filename.c_str());
-	filename = file + " - Large Flame.png";
-	m_LargeFlameTexture = IMG_LoadTexture(m_Renderer, filename.c_str());
-
-	if (!(m_NoFlameTexture && m_SmallFlameTexture && m_MediumFlameTexture && m_LargeFlameTexture))
-	{
-		error("Could not load Player texture.\nSDL_Error: ", SDL_GetError());
-		return;
-	}
-
-	if (SDL_QueryTexture(m_NoFlameTexture, nullptr, nullptr, &m_Rect.w, &m_Rect.h) != 0)
-	{
-		error("Player texture is invalid.\nSDL_Error: ", SDL_GetError());
-		return;
-	}
-
-	// Sets the active texture to no-flame
-	m_ActiveTexture = m_NoFlameTexture;
+	m_Rect.w = PLAYER_WIDTH;
+	m_Rect.h = PLAYER_HEIGHT;
 
 	// Sets the position and angle
 	setCenter(posX, posY);
 	m_Direction = direction;
 
-	updateLifeBar();
-
-	// Sets the dimensions and position for the life bar outline
-	m_LifeBarOutlineRect.w = LIFE_BAR_FULL_WIDTH;
-	m_LifeBarOutlineRect.h = LIFE_BAR_HEIGHT;
-
-	switch (m_Colour)
-	{
-	case PlayerColour::Red:
-		m_LifeBarOutlineRect.x = 30;
-		m_LifeBarOutlineRect.y = 30;
-
-		break;
-
-	case PlayerColour::Blue:
-		m_LifeBarOutlineRect.x = SCREEN_WIDTH - 30 - m_LifeBarOutlineRect.w;
-		m_LifeBarOutlineRect.y = 30;
-
-		break;
-
-	case PlayerColour::Grey:
-		m_LifeBarOutlineRect.x = 30;
-		m_LifeBarOutlineRect.y = SCREEN_HEIGHT - 30 - m_LifeBarOutlineRect.h;
-
-		break;
+	m_Rect.x = (int) m_PosX;
+	m_Rect.y = (int) m_PosY;
 
-	default:
-		break;
-	}
+	savePreviousState();
 }
 
-Player::~Player()
-{
-	// Destroys bullets
-	for (Bullet* bullet : m_Bullets)
-	{
-		delete bullet;
-	}
-}
 
 
-void Player::update(double dt, double wallScale, const std::vector<Barrier>& barriers)
+void Player::update(double dt, double wallScale, const BarrierGrid& barriers)
 {
 	// Checks if dead
 	if (m_LifeLeft <= 0)
 	{
 		m_IsAlive = false;
-		Mix_PlayChannel(-1, s_DeathSound, 0);
 	}
 
 	if (m_Velocity < 0.0)
@@ -149,26 +60,20 @@ void Player::update(double dt, double wallScale, const std::vector<Barrier>& bar
 	m_PosX += deltaX;
 	m_Rect.x = (int) m_PosX;
 
-	for (const Barrier& barrier : barriers)
+	if (barriers.intersects(m_Rect))
 	{
-		if (SDL_HasIntersection(&m_Rect, &barrier.getHorizontalRect()) || SDL_HasIntersection(&m_Rect, &barrier.getVerticalRect()))
-		{
-			m_PosX -= deltaX;
-			m_Rect.x = (int) m_PosX;
-		}
+		m_PosX -= deltaX;
+		m_Rect.x = (int) m_PosX;
 	}
 
 	double deltaY = std::sin(toRadians(m_Direction)) * m_Velocity * dt;
 	m_PosY += deltaY;
 	m_Rect.y = (int) m_PosY;
 
-	for (const Barrier& barrier : barriers)
+	if (barriers.intersects(m_Rect))
 	{
-		if (SDL_HasIntersection(&m_Rect, &barrier.getHorizontalRect()) || SDL_HasIntersection(&m_Rect, &barrier.getVerticalRect()))
-		{
-			m_PosY -= deltaY;
-			m_Rect.y = (int) m_PosY;
-		}
+		m_PosY -= deltaY;
+		m_Rect.y = (int) m_PosY;
 	}
 
 	m_Rect.x = (int) m_PosX;
@@ -181,94 +86,21 @@ void Player::update(double dt, double wallScale, const std::vector<Barrier>& bar
 
 	if (distanceFromCenterSquared > (SCREEN_HEIGHT * wallScale / 2) * (SCREEN_HEIGHT * wallScale / 2))
 	{
-		m_LifeLeft -= (int) (distanceFromCenterSquared - (SCREEN_HEIGHT * wallScale / 2) * (SCREEN_HEIGHT * wallScale / 2)) / 20000 + 1;
+		// Drains as much per simulated second at any tick rate (tuned per tick at SIM_TICK_RATE, so
+		// that rate drains exactly as before)
+		int lifeBefore = m_LifeLeft;
+		int drain = (int) (distanceFromCenterSquared - (SCREEN_HEIGHT * wallScale / 2) * (SCREEN_HEIGHT * wallScale / 2)) / 20000 + 1;
+		m_LifeLeft -= (int) std::lround(drain * dt * SIM_TICK_RATE);
 
 		if (m_LifeLeft < 0)
 		{
 			m_LifeLeft = 0;
 		}
 
-		updateLifeBar();
-	}
-
-	// Updates texture
-	if (m_Velocity > MAX_PLAYER_SPEED * 2 / 4)
-	{
-		m_ActiveTexture = m_LargeFlameTexture;
-	}
-
-	else if (m_Velocity > MAX_PLAYER_SPEED * 1 / 4)
-	{
-		m_ActiveTexture = m_MediumFlameTexture;
-	}
-
-	else if (m_Velocity > 0)
-	{
-		m_ActiveTexture = m_SmallFlameTexture;
-	}
-
-	if (m_Acceleration <= 0)
-	{
-		m_ActiveTexture = m_NoFlameTexture;
-	}
-
-	// Updates sound
-	if (m_Acceleration > 0)
-	{
-		if (m_EngineSoundChannel == -1)
-		{
-			m_EngineSoundChannel = Mix_PlayChannel(-1, s_EngineSound, -1);
-		}
-	}
-
-	else
-	{
-		if (m_EngineSoundChannel != -1)
-		{
-			Mix_FadeOutChannel(m_EngineSoundChannel, 750);
-			m_EngineSoundChannel = -1;
-		}
+		m_WallDamageTaken += lifeBefore - m_LifeLeft;
 	}
 }
 
-void Player::draw()
-{
-	SDL_RenderCopyEx(m_Renderer, m_ActiveTexture, nullptr, &m_Rect, m_Direction, nullptr, SDL_FLIP_NONE);
-
-	// Saves the current render colour
-	Uint8 r;
-	Uint8 g;
-	Uint8 b;
-	Uint8 a;
-	SDL_GetRenderDrawColor(m_Renderer, &r, &g, &b, &a);
-
-	// Sets the drawing colour
-	switch (m_Colour)
-	{
-	case PlayerColour::Red:
-		SDL_SetRenderDrawColor(m_Renderer, 255, 0, 0, 255);
-		break;
-
-	case PlayerColour::Blue:
-		SDL_SetRenderDrawColor(m_Renderer, 0, 0, 255, 255);
-		break;
-
-	case PlayerColour::Grey:
-		SDL_SetRenderDrawColor(m_Renderer, 127, 127, 127, 255);
-		break;
-
-	default:
-		break;
-	}
-
-	// Draws the life bar and outline
-	SDL_RenderDrawRect(m_Renderer, &m_LifeBarOutlineRect);
-	SDL_RenderFillRect(m_Renderer, &m_LifeBarRect);
-
-	// Returns the drawing colour back to what it was
-	SDL_SetRenderDrawColor(m_Renderer, r, g, b, a);
-}
-
 void Player::reset(bool completeReset)
 {
 	// Resets position and direction
@@ -299,23 +131,18 @@ void Player::reset(bool completeReset)
 	m_Rect.x = (int) m_PosX;
 	m_Rect.y = (int) m_PosY;
 
+	savePreviousState();
+
 	// Resets movement properties
 	m_RotationSpeed = 0.0;
 	m_Velocity = 0.0;
 	m_Acceleration = 0.0;
 	m_Drag = 0.0;
 
-	// Removes all bullets
-	for (Bullet* bullet : m_Bullets)
-	{
-		delete bullet;
-	}
-
-	m_Bullets.clear();
-
-	// Resets life
-	int m_LifeLeft = (int) PLAYER_STARTING_LIFE;
-	updateLifeBar();
+	// Resets life (this used to declare a local by mistake, so life carried over between rounds)
+	m_LifeLeft = (int) PLAYER_STARTING_LIFE;
+	m_HitDamageTaken = 0;
+	m_WallDamageTaken = 0;
 
 	// Resets powerups
 	m_SpeedPowerup = false;
@@ -327,16 +154,12 @@ void Player::reset(bool completeReset)
 	m_CooldownPowerup = false;
 	m_BulletCooldownReduction = 0.0;
 
+	// Can fire straight away in the new round
+	m_NextShotTick = 0;
+
 	// Sets back to alive
 	m_IsAlive = true;
 
-	// Resets audio
-	if (m_EngineSoundChannel != -1)
-	{
-		Mix_HaltChannel(m_EngineSoundChannel);
-		m_EngineSoundChannel = -1;
-	}
-
 	// Only resets on a new game, not new round
 	if (completeReset)
 	{
@@ -344,110 +167,76 @@ void Player::reset(bool completeReset)
 	}
 }
 
-void Player::spawnBullet()
-{
-	if (m_BulletCooldownTimer.getElapsed() >= BULLET_COOLDOWN - m_BulletCooldownReduction)
-	{
-		m_BulletCooldownTimer.reset();
-
-		double directionOffset = Random::randdouble(-m_BulletDirectionOffsetMax, m_BulletDirectionOffsetMax);
-
-		if (m_DamagePowerup)
-		{
-			m_Bullets.push_back(new Bullet(m_Renderer, m_Direction + directionOffset, m_Rect.x + m_Rect.w / 2, m_Rect.y + m_Rect.h / 2, true));
-		}
-
-		else
-		{
-			m_Bullets.push_back(new Bullet(m_Renderer, m_Direction + directionOffset, m_Rect.x + m_Rect.w / 2, m_Rect.y + m_Rect.h / 2));
-		}
-
-		// Plays sound
-		Mix_PlayChannel(-1, s_ShootSound, 0);
-	}
-}
-
-void Player::updateBullets(double dt, const std::vector<Barrier>& barriers)
+void Player::spawnBullet(BulletPool& bullets, unsigned int owner, const SimClock& clock, CounterRng& rng)
 {
-	for (unsigned int i = 0; i < m_Bullets.size(); i++)
+	if (clock.getTick() >= m_NextShotTick)
 	{
-		Bullet* bullet = m_Bullets[i];
+		double directionOffset = rng.nextDouble(-m_BulletDirectionOffsetMax, m_BulletDirectionOffsetMax);
+		int damage = m_DamagePowerup ? (int) (PLAYER_HIT_DAMAGE + BULLET_EXTRA_DAMAGE) : (int) PLAYER_HIT_DAMAGE;
 
-		if (!bullet->update(dt, barriers))
+		if (!bullets.spawn(m_Direction + directionOffset, m_Rect.x + m_Rect.w / 2, m_Rect.y + m_Rect.h / 2, owner, damage))
 		{
-			delete bullet;
-
-			// Removes the bullet from the vector
-			m_Bullets.erase(m_Bullets.begin() + i);
-			i -= 1;
+			warn("Bullet pool is full, shot dropped.");
+			return;
 		}
-	}
-}
 
-void Player::drawBullets()
-{
-	for (Bullet* bullet : m_Bullets)
-	{
-		bullet->draw();
+		m_NextShotTick = clock.getTick() + clock.ticksFromMilliseconds(BULLET_COOLDOWN - m_BulletCooldownReduction);
+		m_ShotsFired += 1;
 	}
 }
 
-void Player::takeHit(Bullet* bullet)
+void Player::takeHit(double directionX, double directionY, int damage)
 {
 	// Knockback
-	m_PosX += std::cos(toRadians(bullet->getDirection())) * BULLET_KNOCKBACK;
-	m_PosY += std::sin(toRadians(bullet->getDirection())) * BULLET_KNOCKBACK;
+	m_PosX += directionX * BULLET_KNOCKBACK;
+	m_PosY += directionY * BULLET_KNOCKBACK;
 
 	m_Rect.x = (int) m_PosX;
 	m_Rect.y = (int) m_PosY;
 
-	if (bullet->doesExtraDamage())
-	{
-		m_LifeLeft -= (int) (PLAYER_HIT_DAMAGE + BULLET_EXTRA_DAMAGE);
-	}
-
-	else
-	{
-		m_LifeLeft -= (int) PLAYER_HIT_DAMAGE;
-	}
+	int lifeBefore = m_LifeLeft;
+	m_LifeLeft -= damage;
 
 	if (m_LifeLeft < 0)
 	{
 		m_LifeLeft = 0;
 	}
 
-	updateLifeBar();
+	m_HitDamageTaken += lifeBefore - m_LifeLeft;
 }
 
-void Player::updateLifeBar()
+void Player::savePreviousState()
 {
-	// Sets the width and height of the life bar
-	m_LifeBarRect.w = (int) ((m_LifeLeft / PLAYER_STARTING_LIFE) * LIFE_BAR_FULL_WIDTH);
-	m_LifeBarRect.h = (int) LIFE_BAR_HEIGHT;
-
-	// Sets the position of the life bar
-	switch (m_Colour)
-	{
-	case PlayerColour::Red:
-		m_LifeBarRect.x = 30;
-		m_LifeBarRect.y = 30;
+	m_PrevDirection = m_Direction;
+	m_PrevPosX = m_PosX;
+	m_PrevPosY = m_PosY;
+}
 
-		break;
+Rect Player::getInterpolatedRect(double alpha) const
+{
+	Rect rect = m_Rect;
+	rect.x = (int) (m_PrevPosX + (m_PosX - m_PrevPosX) * alpha);
+	rect.y = (int) (m_PrevPosY + (m_PosY - m_PrevPosY) * alpha);
 
-	case PlayerColour::Blue:
-		m_LifeBarRect.x = SCREEN_WIDTH - 30 - m_LifeBarRect.w;
-		m_LifeBarRect.y = 30;
-		break;
+	return rect;
+}
 
-	case PlayerColour::Grey:
-		m_LifeBarRect.x = 30;
-		m_LifeBarRect.y = SCREEN_HEIGHT - 30 - m_LifeBarRect.h;
+double Player::getInterpolatedDirection(double alpha) const
+{
+	// Takes the short way round (cursor aiming can jump from -180 to 180)
+	double difference = std::fmod(m_Direction - m_PrevDirection, 360.0);
 
-		break;
+	if (difference > 180.0)
+	{
+		difference -= 360.0;
+	}
 
-	default:
-		break;
+	else if (difference < -180.0)
+	{
+		difference += 360.0;
 	}
+
+	return m_PrevDirection + difference * alpha;
 }
 
 void Player::setPowerups(bool speed, bool accuracy, bool damage, bool cooldown)
@@ -480,6 +269,4 @@ void Player::setPowerups(bool speed, bool accuracy, bool damage, bool cooldown)
 		m_BulletCooldownReduction = BULLET_COOLDOWN_REDUCTION;
 		m_LifeLeft -= (int) BULLET_POWERUP_COST;
 	}
-
-	updateLifeBar();
 }
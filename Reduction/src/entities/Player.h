@@ -2,13 +2,11 @@
 
 #include <vector>
 
-#include <SDL/SDL.h>
-#include <SDL/SDL_image.h>
-#include <SDL/SDL_mixer.h>
-
-#include "Bullet.h"
-#include "gfx/Barrier.h"
-#include "utils/Timer.h"
+#include "BulletPool.h"
+#include "sim/BarrierGrid.h"
+#include "sim/SimClock.h"
+#include "utils/CounterRng.h"
+#include "utils/Rect.h"
 #include "utils/Settings.h"
 
 
@@ -23,21 +21,7 @@ enum class PlayerColour
 class Player
 {
 private:
-	// Audio
-	static Mix_Chunk* s_ShootSound;
-	static Mix_Chunk* s_DeathSound;
-	static Mix_Chunk* s_EngineSound;
-	int m_EngineSoundChannel = -1;
-
-	// Textures for different sized flames
-	SDL_Texture* m_NoFlameTexture = nullptr;
-	SDL_Texture* m_SmallFlameTexture = nullptr;
-	SDL_Texture* m_MediumFlameTexture = nullptr;
-	SDL_Texture* m_LargeFlameTexture = nullptr;
-	SDL_Texture* m_ActiveTexture = nullptr;
-
-	SDL_Rect m_Rect;
-	SDL_Renderer* m_Renderer;
+	Rect m_Rect;
 
 	PlayerColour m_Colour;
 
@@ -49,16 +33,21 @@ private:
 	double m_Acceleration = 0.0;
 	double m_Drag = 0.0;
 
-	// Keeps track of each bullet
-	std::vector<Bullet*> m_Bullets;
+	// Position and angle before the last step, for render interpolation
+	double m_PrevDirection = 0.0;
+	double m_PrevPosX = 0.0, m_PrevPosY = 0.0;
+
+	// First tick the player can shoot again on
+	unsigned long long m_NextShotTick = 0;
 
-	// Bullet cooldown time
-	Timer m_BulletCooldownTimer;
+	// Total shots fired, lets the render layer notice new shots
+	unsigned int m_ShotsFired = 0;
 
 	// The amount of life the player has left
 	int m_LifeLeft = (int) PLAYER_STARTING_LIFE;
-	SDL_Rect m_LifeBarRect;
-	SDL_Rect m_LifeBarOutlineRect;
+	// Life lost this round to bullets and to the wall
+	int m_HitDamageTaken = 0;
+	int m_WallDamageTaken = 0;
 
 	// Powerups
 	bool m_SpeedPowerup = false;
@@ -77,20 +66,21 @@ private:
 	unsigned int m_Points = 0;
 
 public:
-	Player(SDL_Renderer* renderer, PlayerColour colour, double posX, double posY, double direction);
-	~Player();
+	Player(PlayerColour colour, double posX, double posY, double direction);
 
-	void update(double dt, double wallScale, const std::vector<Barrier>& barriers);
-	void draw();
+	void update(double dt, double wallScale, const BarrierGrid& barriers);
 	void reset(bool completeReset = false);
 
-	void spawnBullet();
-	void updateBullets(double dt, const std::vector<Barrier>& barriers);
-	void drawBullets();
-	void takeHit(Bullet* bullet);
-	void updateLifeBar();
+	// Fires into the pool if the cooldown has passed (owner is this player's index)
+	void spawnBullet(BulletPool& bullets, unsigned int owner, const SimClock& clock, CounterRng& rng);
+	// Knocks the player back along a unit vector and takes damage off its life
+	void takeHit(double directionX, double directionY, int damage);
 
-	static void initAudio();
+	// Remembers the current position and angle as the previous ones
+	void savePreviousState();
+	// Rect and angle blended between the last two steps (alpha from 0 to 1)
+	Rect getInterpolatedRect(double alpha) const;
+	double getInterpolatedDirection(double alpha) const;
 
 	void setRotationSpeed(double value) { m_RotationSpeed = value; }
 	void setAcceleration(double value) { m_Acceleration = value; }
@@ -101,9 +91,21 @@ public:
 	void addPoint() { m_Points += 1; }
 	void setLifeLeft(int value) { m_LifeLeft = value; }
 
-	SDL_Rect& getRect() { return m_Rect; }
-	std::vector<Bullet*>& getBullets() { return m_Bullets; }
-	int getLifeLeft() { return m_LifeLeft; }
-	bool isAlive() { return m_IsAlive; }
-	unsigned int getPoints() { return m_Points; }
+	const Rect& getRect() const { return m_Rect; }
+	double getPosX() const { return m_PosX; }
+	double getPosY() const { return m_PosY; }
+	PlayerColour getColour() const { return m_Colour; }
+	double getDirection() const { return m_Direction; }
+	double getVelocity() const { return m_Velocity; }
+	double getAcceleration() const { return m_Acceleration; }
+	unsigned int getShotsFired() const { return m_ShotsFired; }
+	int getLifeLeft() const { return m_LifeLeft; }
+	int getHitDamageTaken() const { return m_HitDamageTaken; }
+	int getWallDamageTaken() const { return m_WallDamageTaken; }
+	bool isAlive() const { return m_IsAlive; }
+	unsigned int getPoints() const { return m_Points; }
+	bool hasSpeedPowerup() const { return m_SpeedPowerup; }
+	bool hasAccuracyPowerup() const { return m_AccuracyPowerup; }
+	bool hasDamagePowerup() const { return m_DamagePowerup; }
+	bool hasCooldownPowerup() const { return m_CooldownPowerup; }
 };
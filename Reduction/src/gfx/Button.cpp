@@ -1,5 +1,7 @@
 #include "Button.h"
 
+#include <cstring>
+
 #include "utils/Log.h"
 
 
@@ -12,39 +14,30 @@ Button::Button(SDL_Renderer* renderer, const char* text)
 	}
 
 	m_Text.load("res/fonts/BM Space.TTF", text, 28, m_DefaultTextColour, m_Renderer);
+
+	m_HighlightedText.load("res/fonts/BM Space.TTF", text, 28, m_HighlightedTextColour, m_Renderer);
+	m_HighlightedText.setStyle(TTF_STYLE_BOLD);
 }
 
 
 void Button::update()
 {
-	if (isMouseOver())
-	{
-		if (!m_CurrentlyHighlighting)
-		{
-			m_Text.setStyle(TTF_STYLE_BOLD, false);
-			m_Text.setColour(m_HighlightedTextColour);
+	m_CurrentlyHighlighting = isMouseOver();
+}
 
-			m_CurrentlyHighlighting = true;
-		}
+void Button::draw(unsigned int centerX, unsigned int centerY)
+{
+	if (m_CurrentlyHighlighting)
+	{
+		m_HighlightedText.draw(centerX, centerY);
 	}
 
 	else
 	{
-		if (m_CurrentlyHighlighting)
-		{
-			m_Text.setStyle(TTF_STYLE_NORMAL, false);
-			m_Text.setColour(m_DefaultTextColour);
-
-			m_CurrentlyHighlighting = false;
-		}
+		m_Text.draw(centerX, centerY);
 	}
 }
 
-void Button::draw(unsigned int centerX, unsigned int centerY)
-{
-	m_Text.draw(centerX, centerY);
-}
-
 bool Button::isMouseOver()
 {
 	// Gets the mouse position
@@ -52,5 +45,29 @@ bool Button::isMouseOver()
 	int mouseY;
 	SDL_GetMouseState(&mouseX, &mouseY);
 
+	// Only the text last drawn has an up to date position
+	if (m_CurrentlyHighlighting)
+	{
+		return m_HighlightedText.rectCollides(mouseX, mouseY);
+	}
+
 	return m_Text.rectCollides(mouseX, mouseY);
 }
+
+void Button::setTextSize(unsigned int size)
+{
+	m_Text.setSize(size);
+	m_HighlightedText.setSize(size);
+}
+
+void Button::setTextColour(SDL_Color colour)
+{
+	m_DefaultTextColour = colour;
+	m_Text.setColour(colour);
+}
+
+void Button::setHighlightedTextColour(SDL_Color colour)
+{
+	m_HighlightedTextColour = colour;
+	m_HighlightedText.setColour(colour);
+}
@@ -9,8 +9,10 @@ private:
 	// Renderer for drawing
 	SDL_Renderer* m_Renderer;
 
-	// Text that represents the button
+	// Text that represents the button, built once for each hover state so
+	// hovering only swaps which one is drawn
 	Text m_Text;
+	Text m_HighlightedText;
 
 	// Colours for the text
 	SDL_Color m_DefaultTextColour = { 255, 255, 255, 255 };
@@ -30,11 +32,11 @@ public:
 	// Returns true when clicked
 	bool isMouseOver();
 
-	// Returns the text object so it can be modified
-	Text& getText() { return m_Text; }
+	// Sets the font size of both hover states
+	void setTextSize(unsigned int size);
 
 	// Sets the default text colour
-	void setTextColour(SDL_Color colour) { m_DefaultTextColour = colour; }
+	void setTextColour(SDL_Color colour);
 	// Sets the highlight text colour
-	void setHighlightedTextColour(SDL_Color colour) { m_HighlightedTextColour = colour; }
+	void setHighlightedTextColour(SDL_Color colour);
 };
@@ -0,0 +1,157 @@
+#include "Font.h"
+
+#include <algorithm>
+
+#include "utils/Settings.h"
+#include "utils/Log.h"
+
+
+// Rows of transparent pixels uploaded at a time when clearing a new atlas page (static, so adding
+// a page part way through a round doesn't allocate)
+constexpr int FONT_ATLAS_CLEAR_ROWS = 16;
+static const Uint32 s_TransparentRows[FONT_ATLAS_PAGE_SIZE * FONT_ATLAS_CLEAR_ROWS] = {};
+
+
+Font::Font(TTF_Font* font, SDL_Renderer* renderer)
+	: m_Font(font), m_Renderer(renderer)
+{
+}
+
+Font::~Font()
+{
+	for (SDL_Texture* page : m_Pages)
+	{
+		SDL_DestroyTexture(page);
+	}
+
+	TTF_CloseFont(m_Font);
+}
+
+
+bool Font::addPage()
+{
+	SDL_Texture* page = SDL_CreateTexture(m_Renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, FONT_ATLAS_PAGE_SIZE, FONT_ATLAS_PAGE_SIZE);
+
+	if (!page)
+	{
+		error("Could not create font atlas page.\nSDL_Error: ", SDL_GetError());
+		return false;
+	}
+
+	// New textures have undefined contents
+	for (int y = 0; y < FONT_ATLAS_PAGE_SIZE; y += FONT_ATLAS_CLEAR_ROWS)
+	{
+		SDL_Rect rows = { 0, y, FONT_ATLAS_PAGE_SIZE, std::min(FONT_ATLAS_CLEAR_ROWS, FONT_ATLAS_PAGE_SIZE - y) };
+		SDL_UpdateTexture(page, &rows, s_TransparentRows, FONT_ATLAS_PAGE_SIZE * sizeof(Uint32));
+	}
+
+	SDL_SetTextureBlendMode(page, SDL_BLENDMODE_BLEND);
+
+	m_Pages.push_back(page);
+	m_ShelfX = 0;
+	m_ShelfY = 0;
+	m_ShelfHeight = 0;
+
+	return true;
+}
+
+const Glyph* Font::rasterise(Uint16 codepoint)
+{
+	Glyph glyph;
+
+	if (TTF_GlyphMetrics(m_Font, codepoint, nullptr, nullptr, nullptr, nullptr, &glyph.advance) != 0)
+	{
+		return nullptr;
+	}
+
+	// Rendered alone so the glyph sits on the baseline at full line height
+	Uint16 string[2] = { codepoint, 0 };
+	SDL_Surface* surface = TTF_RenderUNICODE_Solid(m_Font, string, SDL_Color { 255, 255, 255, 255 });
+
+	// Glyphs with nothing to draw (e.g. spaces in some fonts) only move the pen
+	if (!surface)
+	{
+		return &(m_Glyphs[codepoint] = glyph);
+	}
+
+	if (surface->w > FONT_ATLAS_PAGE_SIZE || surface->h > FONT_ATLAS_PAGE_SIZE)
+	{
+		error("Glyph is too large for the font atlas (", surface->w, "x", surface->h, ").");
+		SDL_FreeSurface(surface);
+
+		return nullptr;
+	}
+
+	// Moves to the next shelf, or the next page, when out of room
+	if (m_ShelfX + surface->w > FONT_ATLAS_PAGE_SIZE)
+	{
+		m_ShelfX = 0;
+		m_ShelfY += m_ShelfHeight;
+		m_ShelfHeight = 0;
+	}
+
+	if (m_Pages.empty() || m_ShelfY + surface->h > FONT_ATLAS_PAGE_SIZE)
+	{
+		if (!addPage())
+		{
+			SDL_FreeSurface(surface);
+			return nullptr;
+		}
+	}
+
+	glyph.page = (unsigned int) m_Pages.size() - 1;
+	glyph.source = SDL_Rect { m_ShelfX, m_ShelfY, surface->w, surface->h };
+
+	// Solid surfaces are 8-bit with index 0 as the background
+	m_UploadPixels.resize(surface->w * surface->h);
+
+	for (int y = 0; y < surface->h; y++)
+	{
+		const Uint8* row = (const Uint8*) surface->pixels + y * surface->pitch;
+
+		for (int x = 0; x < surface->w; x++)
+		{
+			m_UploadPixels[y * surface->w + x] = row[x] ? 0xFFFFFFFF : 0x00000000;
+		}
+	}
+
+	SDL_UpdateTexture(m_Pages[glyph.page], &glyph.source, m_UploadPixels.data(), surface->w * sizeof(Uint32));
+	SDL_FreeSurface(surface);
+
+	m_ShelfX += glyph.source.w;
+
+	if (glyph.source.h > m_ShelfHeight)
+	{
+		m_ShelfHeight = glyph.source.h;
+	}
+
+	return &(m_Glyphs[codepoint] = glyph);
+}
+
+
+const Glyph* Font::getGlyph(Uint16 codepoint)
+{
+	auto it = m_Glyphs.find(codepoint);
+
+	if (it != m_Glyphs.end())
+	{
+		return &it->second;
+	}
+
+	if (!TTF_GlyphIsProvided(m_Font, codepoint))
+	{
+		return nullptr;
+	}
+
+	return rasterise(codepoint);
+}
+
+int Font::getKerning(Uint16 previous, Uint16 codepoint)
+{
+	if (!TTF_GetFontKerning(m_Font))
+	{
+		return 0;
+	}
+
+	return TTF_GetFontKerningSizeGlyphs(m_Font, previous, codepoint);
+}
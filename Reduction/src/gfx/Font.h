@@ -0,0 +1,65 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <SDL/SDL.h>
+#include <SDL/SDL_ttf.h>
+
+
+// Where a rasterised glyph lives in the atlas, and how far it moves the pen
+struct Glyph
+{
+	unsigned int page = 0;
+	SDL_Rect source = { 0, 0, 0, 0 };
+	int advance = 0;
+};
+
+
+// An open font whose glyphs are rasterised once into shared atlas pages
+class Font
+{
+private:
+	TTF_Font* m_Font;
+	SDL_Renderer* m_Renderer;
+
+	// Atlas textures, a new page is started when the last one fills up
+	std::vector<SDL_Texture*> m_Pages;
+
+	// Shelf packing position in the last page
+	int m_ShelfX = 0;
+	int m_ShelfY = 0;
+	int m_ShelfHeight = 0;
+
+	// Glyphs rasterised so far, keyed by code point
+	std::unordered_map<Uint16, Glyph> m_Glyphs;
+
+	// Reused when converting glyph surfaces for upload
+	std::vector<Uint32> m_UploadPixels;
+
+private:
+	// Starts a new, fully transparent, atlas page (false on failure)
+	bool addPage();
+	// Rasterises a glyph and copies it into the atlas (nullptr on failure)
+	const Glyph* rasterise(Uint16 codepoint);
+
+public:
+	// Takes ownership of an opened font
+	Font(TTF_Font* font, SDL_Renderer* renderer);
+	~Font();
+
+	Font(const Font&) = delete;
+	Font& operator=(const Font&) = delete;
+
+	// Gets a glyph, rasterising it on first use (nullptr if the font can't draw it)
+	const Glyph* getGlyph(Uint16 codepoint);
+
+	// Extra pen movement between two characters
+	int getKerning(Uint16 previous, Uint16 codepoint);
+
+	// Height of a line of text
+	int getHeight() const { return TTF_FontHeight(m_Font); }
+
+	SDL_Texture* getPage(unsigned int page) const { return m_Pages[page]; }
+	unsigned int getPageCount() const { return (unsigned int) m_Pages.size(); }
+};
@@ -0,0 +1,85 @@
+#include "FontCache.h"
+
+#include "utils/Log.h"
+
+
+SDL_Renderer* FontCache::s_Renderer = nullptr;
+std::unordered_map<std::string, FontCache::Entry> FontCache::s_Fonts;
+unsigned int FontCache::s_Hits = 0;
+unsigned int FontCache::s_Misses = 0;
+
+
+void FontCache::init(SDL_Renderer* renderer)
+{
+	s_Renderer = renderer;
+}
+
+
+std::string FontCache::makeKey(const std::string& path, unsigned int size, int style)
+{
+	return path + '|' + std::to_string(size) + '|' + std::to_string(style);
+}
+
+
+Font* FontCache::acquire(const std::string& path, unsigned int size, int style)
+{
+	std::string key = makeKey(path, size, style);
+	auto it = s_Fonts.find(key);
+
+	if (it != s_Fonts.end())
+	{
+		s_Hits += 1;
+		it->second.references += 1;
+
+		return it->second.font;
+	}
+
+	s_Misses += 1;
+
+	// Opens the file, only happens once per path, size and style
+	TTF_Font* ttfFont = TTF_OpenFont(path.c_str(), size);
+
+	if (!ttfFont)
+	{
+		error("Could not load font (filepath: ", path, ").\nSDL_Error: ", SDL_GetError());
+		return nullptr;
+	}
+
+	TTF_SetFontStyle(ttfFont, style);
+
+	Font* font = new Font(ttfFont, s_Renderer);
+	s_Fonts[key] = Entry { font, 1 };
+
+	return font;
+}
+
+void FontCache::release(const std::string& path, unsigned int size, int style)
+{
+	auto it = s_Fonts.find(makeKey(path, size, style));
+
+	// Texts that outlive the cache release after it has been cleared
+	if (it == s_Fonts.end())
+	{
+		return;
+	}
+
+	it->second.references -= 1;
+
+	if (it->second.references == 0)
+	{
+		delete it->second.font;
+		s_Fonts.erase(it);
+	}
+}
+
+void FontCache::clear()
+{
+	info("Font cache: ", s_Hits, " hits, ", s_Misses, " misses, ", s_Fonts.size(), " fonts still open.");
+
+	for (auto& [key, entry] : s_Fonts)
+	{
+		delete entry.font;
+	}
+
+	s_Fonts.clear();
+}
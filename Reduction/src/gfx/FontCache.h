@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include <SDL/SDL.h>
+#include <SDL/SDL_ttf.h>
+
+#include "Font.h"
+
+
+class FontCache
+{
+private:
+	// An open font and how many owners are borrowing it
+	struct Entry
+	{
+		Font* font = nullptr;
+		unsigned int references = 0;
+	};
+
+	// Renderer the atlases are created for
+	static SDL_Renderer* s_Renderer;
+
+	// Open fonts, keyed by path, size and style
+	static std::unordered_map<std::string, Entry> s_Fonts;
+
+	// Lookup statistics
+	static unsigned int s_Hits;
+	static unsigned int s_Misses;
+
+private:
+	static std::string makeKey(const std::string& path, unsigned int size, int style);
+
+public:
+	// Sets the renderer that atlases are created for
+	static void init(SDL_Renderer* renderer);
+
+	// Borrows a font, opening it on first use (nullptr on failure)
+	static Font* acquire(const std::string& path, unsigned int size, int style = TTF_STYLE_NORMAL);
+	// Gives back a borrowed font, closing it once no-one is using it
+	static void release(const std::string& path, unsigned int size, int style = TTF_STYLE_NORMAL);
+
+	// Closes every font, whether or not it is still borrowed
+	static void clear();
+
+	static unsigned int getHits() { return s_Hits; }
+	static unsigned int getMisses() { return s_Misses; }
+	static unsigned int getLoadedCount() { return (unsigned int) s_Fonts.size(); }
+};
@@ -0,0 +1,241 @@
+#include "PlayerSprite.h"
+
+#include "TextureCache.h"
+#include "utils/Log.h"
+#include "utils/Settings.h"
+
+
+Mix_Chunk* PlayerSprite::s_ShootSound = nullptr;
+Mix_Chunk* PlayerSprite::s_DeathSound = nullptr;
+Mix_Chunk* PlayerSprite::s_EngineSound = nullptr;
+
+void PlayerSprite::initAudio()
+{
+	s_ShootSound = Mix_LoadWAV("res/audio/Shoot Sound.mp3");
+	Mix_VolumeChunk(s_ShootSound, 32);
+	s_DeathSound = Mix_LoadWAV("res/audio/DeathFlash.mp3");
+	s_EngineSound = Mix_LoadWAV("res/audio/Rocket Thrusters.mp3");
+}
+
+
+PlayerSprite::PlayerSprite(SDL_Renderer* renderer, PlayerColour colour)
+	: m_Renderer(renderer), m_Colour(colour)
+{
+	switch (colour)
+	{
+	case PlayerColour::Red:
+		m_TexturePath = "res/txrs/players/Red Spaceship";
+		break;
+
+	case PlayerColour::Blue:
+		m_TexturePath = "res/txrs/players/Blue Spaceship";
+		break;
+
+	case PlayerColour::Grey:
+		m_TexturePath = "res/txrs/players/Grey Spaceship";
+		break;
+
+	default:
+		error("Unhandled player colour case.");
+		return;
+	}
+
+	// Borrows the textures from the cache
+	m_NoFlameTexture = TextureCache::acquire(m_TexturePath + ".png");
+	m_SmallFlameTexture = TextureCache::acquire(m_TexturePath + " - Small Flame.png");
+	m_MediumFlameTexture = TextureCache::acquire(m_TexturePath + " - Medium Flame.png");
+	m_LargeFlameTexture = TextureCache::acquire(m_TexturePath + " - Large Flame.png");
+
+	if (!(m_NoFlameTexture && m_SmallFlameTexture && m_MediumFlameTexture && m_LargeFlameTexture))
+	{
+		error("Could not load Player texture.\nSDL_Error: ", SDL_GetError());
+		return;
+	}
+
+	// Sets the active texture to no-flame
+	m_ActiveTexture = m_NoFlameTexture;
+
+	updateLifeBar((int) PLAYER_STARTING_LIFE);
+
+	// Sets the dimensions and position for the life bar outline
+	m_LifeBarOutlineRect.w = LIFE_BAR_FULL_WIDTH;
+	m_LifeBarOutlineRect.h = LIFE_BAR_HEIGHT;
+
+	switch (m_Colour)
+	{
+	case PlayerColour::Red:
+		m_LifeBarOutlineRect.x = 30;
+		m_LifeBarOutlineRect.y = 30;
+
+		break;
+
+	case PlayerColour::Blue:
+		m_LifeBarOutlineRect.x = SCREEN_WIDTH - 30 - m_LifeBarOutlineRect.w;
+		m_LifeBarOutlineRect.y = 30;
+
+		break;
+
+	case PlayerColour::Grey:
+		m_LifeBarOutlineRect.x = 30;
+		m_LifeBarOutlineRect.y = SCREEN_HEIGHT - 30 - m_LifeBarOutlineRect.h;
+
+		break;
+
+	default:
+		break;
+	}
+}
+
+PlayerSprite::~PlayerSprite()
+{
+	stopSounds();
+
+	// Gives the textures back to the cache
+	if (!m_TexturePath.empty())
+	{
+		TextureCache::release(m_TexturePath + ".png");
+		TextureCache::release(m_TexturePath + " - Small Flame.png");
+		TextureCache::release(m_TexturePath + " - Medium Flame.png");
+		TextureCache::release(m_TexturePath + " - Large Flame.png");
+	}
+}
+
+
+void PlayerSprite::update(const Player& player)
+{
+	// Death sound
+	if (m_WasAlive && !player.isAlive())
+	{
+		Mix_PlayChannel(-1, s_DeathSound, 0);
+	}
+
+	m_WasAlive = player.isAlive();
+
+	// Shoot sound
+	if (player.getShotsFired() != m_LastShotsFired)
+	{
+		m_LastShotsFired = player.getShotsFired();
+		Mix_PlayChannel(-1, s_ShootSound, 0);
+	}
+
+	updateLifeBar(player.getLifeLeft());
+
+	// Updates texture
+	if (player.getVelocity() > MAX_PLAYER_SPEED * 2 / 4)
+	{
+		m_ActiveTexture = m_LargeFlameTexture;
+	}
+
+	else if (player.getVelocity() > MAX_PLAYER_SPEED * 1 / 4)
+	{
+		m_ActiveTexture = m_MediumFlameTexture;
+	}
+
+	else if (player.getVelocity() > 0)
+	{
+		m_ActiveTexture = m_SmallFlameTexture;
+	}
+
+	if (player.getAcceleration() <= 0)
+	{
+		m_ActiveTexture = m_NoFlameTexture;
+	}
+
+	// Updates engine sound
+	if (player.isAlive() && player.getAcceleration() > 0)
+	{
+		if (m_EngineSoundChannel == -1)
+		{
+			m_EngineSoundChannel = Mix_PlayChannel(-1, s_EngineSound, -1);
+		}
+	}
+
+	else
+	{
+		if (m_EngineSoundChannel != -1)
+		{
+			Mix_FadeOutChannel(m_EngineSoundChannel, 750);
+			m_EngineSoundChannel = -1;
+		}
+	}
+}
+
+void PlayerSprite::draw(const Player& player, double alpha)
+{
+	Rect rect = player.getInterpolatedRect(alpha);
+	SDL_Rect playerRect = { rect.x, rect.y, rect.w, rect.h };
+	SDL_RenderCopyEx(m_Renderer, m_ActiveTexture, nullptr, &playerRect, player.getInterpolatedDirection(alpha), nullptr, SDL_FLIP_NONE);
+
+	// Saves the current render colour
+	Uint8 r;
+	Uint8 g;
+	Uint8 b;
+	Uint8 a;
+	SDL_GetRenderDrawColor(m_Renderer, &r, &g, &b, &a);
+
+	// Sets the drawing colour
+	switch (m_Colour)
+	{
+	case PlayerColour::Red:
+		SDL_SetRenderDrawColor(m_Renderer, 255, 0, 0, 255);
+		break;
+
+	case PlayerColour::Blue:
+		SDL_SetRenderDrawColor(m_Renderer, 0, 0, 255, 255);
+		break;
+
+	case PlayerColour::Grey:
+		SDL_SetRenderDrawColor(m_Renderer, 127, 127, 127, 255);
+		break;
+
+	default:
+		break;
+	}
+
+	// Draws the life bar and outline
+	SDL_RenderDrawRect(m_Renderer, &m_LifeBarOutlineRect);
+	SDL_RenderFillRect(m_Renderer, &m_LifeBarRect);
+
+	// Returns the drawing colour back to what it was
+	SDL_SetRenderDrawColor(m_Renderer, r, g, b, a);
+}
+
+void PlayerSprite::stopSounds()
+{
+	if (m_EngineSoundChannel != -1)
+	{
+		Mix_HaltChannel(m_EngineSoundChannel);
+		m_EngineSoundChannel = -1;
+	}
+}
+
+void PlayerSprite::updateLifeBar(int lifeLeft)
+{
+	// Sets the width and height of the life bar
+	m_LifeBarRect.w = (int) ((lifeLeft / PLAYER_STARTING_LIFE) * LIFE_BAR_FULL_WIDTH);
+	m_LifeBarRect.h = (int) LIFE_BAR_HEIGHT;
+
+	// Sets the position of the life bar
+	switch (m_Colour)
+	{
+	case PlayerColour::Red:
+		m_LifeBarRect.x = 30;
+		m_LifeBarRect.y = 30;
+
+		break;
+
+	case PlayerColour::Blue:
+		m_LifeBarRect.x = SCREEN_WIDTH - 30 - m_LifeBarRect.w;
+		m_LifeBarRect.y = 30;
+		break;
+
+	case PlayerColour::Grey:
+		m_LifeBarRect.x = 30;
+		m_LifeBarRect.y = SCREEN_HEIGHT - 30 - m_LifeBarRect.h;
+
+		break;
+
+	default:
+		break;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+
+#include <SDL/SDL.h>
+#include <SDL/SDL_mixer.h>
+
+#include "entities/Player.h"
+
+
+// Draws a simulated player and plays its sounds
+class PlayerSprite
+{
+private:
+	// Audio
+	static Mix_Chunk* s_ShootSound;
+	static Mix_Chunk* s_DeathSound;
+	static Mix_Chunk* s_EngineSound;
+	int m_EngineSoundChannel = -1;
+
+	// Textures for different sized flames (borrowed from the texture cache)
+	std::string m_TexturePath;
+	SDL_Texture* m_NoFlameTexture = nullptr;
+	SDL_Texture* m_SmallFlameTexture = nullptr;
+	SDL_Texture* m_MediumFlameTexture = nullptr;
+	SDL_Texture* m_LargeFlameTexture = nullptr;
+	SDL_Texture* m_ActiveTexture = nullptr;
+
+	SDL_Renderer* m_Renderer;
+
+	PlayerColour m_Colour;
+
+	// Life bar
+	SDL_Rect m_LifeBarRect;
+	SDL_Rect m_LifeBarOutlineRect;
+
+	// State seen on the last update, used to trigger sounds
+	unsigned int m_LastShotsFired = 0;
+	bool m_WasAlive = true;
+
+private:
+	// Updates the life bar to match the player's life
+	void updateLifeBar(int lifeLeft);
+
+public:
+	PlayerSprite(SDL_Renderer* renderer, PlayerColour colour);
+	~PlayerSprite();
+
+	PlayerSprite(const PlayerSprite&) = delete;
+	PlayerSprite& operator=(const PlayerSprite&) = delete;
+
+	// Picks the texture and plays sounds for the player's current state
+	void update(const Player& player);
+	// Draws blended between the last two simulation steps (alpha from 0 to 1)
+	void draw(const Player& player, double alpha);
+
+	// Stops any looping sounds (e.g. at the end of a round)
+	void stopSounds();
+
+	static void initAudio();
+};
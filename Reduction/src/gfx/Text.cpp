@@ -1,79 +1,171 @@
 #include "Text.h"
 
+#include "FontCache.h"
 #include "utils/Log.h"
 
 
-Text::Text(const char* fontPath, std::string text, unsigned int size, SDL_Color colour, SDL_Renderer* renderer)
+// Reads one character of UTF-8, anything outside the BMP or malformed becomes U+FFFD
+static Uint16 decodeUtf8(const std::string& text, size_t& index)
+{
+	unsigned char lead = (unsigned char) text[index++];
+
+	if (lead < 0x80)
+	{
+		return lead;
+	}
+
+	unsigned int continuationBytes = 0;
+	unsigned int codepoint = 0;
+
+	if ((lead & 0xE0) == 0xC0)
+	{
+		continuationBytes = 1;
+		codepoint = lead & 0x1F;
+	}
+
+	else if ((lead & 0xF0) == 0xE0)
+	{
+		continuationBytes = 2;
+		codepoint = lead & 0x0F;
+	}
+
+	else
+	{
+		// Skips the rest of a 4 byte sequence (outside the BMP) or a stray byte
+		while (index < text.size() && ((unsigned char) text[index] & 0xC0) == 0x80)
+		{
+			index += 1;
+		}
+
+		return 0xFFFD;
+	}
+
+	for (unsigned int i = 0; i < continuationBytes; i++)
+	{
+		if (index >= text.size() || ((unsigned char) text[index] & 0xC0) != 0x80)
+		{
+			return 0xFFFD;
+		}
+
+		codepoint = (codepoint << 6) | ((unsigned char) text[index++] & 0x3F);
+	}
+
+	return (Uint16) codepoint;
+}
+
+
+Text::Text(const char* fontPath, const std::string& text, unsigned int size, SDL_Color colour, SDL_Renderer* renderer)
 {
 	load(fontPath, text, size, colour, renderer);
 }
 
 Text::~Text()
 {
-	// Destroys the texture
-	SDL_DestroyTexture(m_TextTexture);
-	m_TextTexture = nullptr;
-
-	// Closes the font
-	TTF_CloseFont(m_Font);
-	m_Font = nullptr;
+	// Gives the font back to the cache
+	if (m_Font)
+	{
+		FontCache::release(m_FontPath, m_FontSize, m_FontStyle);
+		m_Font = nullptr;
+	}
 }
 
-void Text::load(const char* fontPath, std::string text, unsigned int size, SDL_Color colour, SDL_Renderer* renderer)
+void Text::load(const char* fontPath, const std::string& text, unsigned int size, SDL_Color colour, SDL_Renderer* renderer)
 {
+	// Gives back the font from an earlier load
+	if (m_Font)
+	{
+		FontCache::release(m_FontPath, m_FontSize, m_FontStyle);
+		m_Font = nullptr;
+	}
+
 	// Sets attributes on load
 	m_FontPath = fontPath;
 	m_Text = text;
 	m_Size = size;
+	m_Style = TTF_STYLE_NORMAL;
 	m_Colour = colour;
 	m_Renderer = renderer;
 
 	// Loads the font
-	m_Font = TTF_OpenFont(m_FontPath, size);
+	m_Font = FontCache::acquire(m_FontPath, m_Size, m_Style);
+	m_FontSize = m_Size;
+	m_FontStyle = m_Style;
 
 	// Error checking for font
 	if (m_Font == nullptr)
 	{
-		error("Could not load font (filepath: ", m_FontPath, ").\nSDLError: ", SDL_GetError());
 		return;
 	}
 
-	updateTexture();
+	updateLayout();
 
 	m_Loaded = true;
 }
 
 
-void Text::updateTexture()
+void Text::updateFont()
 {
-	// Destroys the last texture
-	SDL_DestroyTexture(m_TextTexture);
-	m_TextTexture = nullptr;
-
-	// Creates a surface for the font
-	SDL_Surface* textSurface = TTF_RenderUTF8_Solid(m_Font, m_Text.c_str(), m_Colour);
-
-	// Error checking for text surface
-	if (textSurface == nullptr)
+	if (m_FontSize == m_Size && m_FontStyle == m_Style)
 	{
-		error("Could not create text surface (filepath: ", m_FontPath, ").\nSDLError: ", SDL_GetError());
 		return;
 	}
 
-	// Creates a texture from the surface
-	m_TextTexture = SDL_CreateTextureFromSurface(m_Renderer, textSurface);
+	Font* font = FontCache::acquire(m_FontPath, m_Size, m_Style);
 
-	if (m_TextTexture == nullptr)
+	// Error checking for font (keeps drawing with the old one)
+	if (font == nullptr)
 	{
-		error("Could not create texture from surface for font (filepath: ", m_FontPath, ").\nSDLError: ", SDL_GetError());
+		m_Size = m_FontSize;
+		m_Style = m_FontStyle;
+
 		return;
 	}
 
-	// Frees the temporary surface
-	SDL_FreeSurface(textSurface);
+	FontCache::release(m_FontPath, m_FontSize, m_FontStyle);
+	m_Font = font;
+	m_FontSize = m_Size;
+	m_FontStyle = m_Style;
+}
 
-	// Gets the dimensions of the texture
-	SDL_QueryTexture(m_TextTexture, nullptr, nullptr, &m_TextRect.w, &m_TextRect.h);
+void Text::updateLayout()
+{
+	updateFont();
+	m_Glyphs.clear();
+
+	int penX = 0;
+	int width = 0;
+	Uint16 previous = 0;
+	size_t index = 0;
+
+	while (index < m_Text.size())
+	{
+		Uint16 codepoint = decodeUtf8(m_Text, index);
+		const Glyph* glyph = m_Font->getGlyph(codepoint);
+
+		// Characters the font doesn't have are left out
+		if (glyph == nullptr)
+		{
+			continue;
+		}
+
+		if (previous != 0)
+		{
+			penX += m_Font->getKerning(previous, codepoint);
+		}
+
+		m_Glyphs.push_back(PlacedGlyph { glyph, penX });
+
+		if (penX + glyph->source.w > width)
+		{
+			width = penX + glyph->source.w;
+		}
+
+		penX += glyph->advance;
+		previous = codepoint;
+	}
+
+	m_TextRect.w = width > penX ? width : penX;
+	m_TextRect.h = m_Font->getHeight();
 }
 
 bool Text::rectCollides(int x, int y)
@@ -82,7 +174,7 @@ bool Text::rectCollides(int x, int y)
 	return SDL_HasIntersection(&mouseRect, &m_TextRect);
 }
 
-void Text::setText(std::string text, bool update)
+void Text::setText(const char* text, bool update)
 {
 	if (!m_Loaded)
 	{
@@ -90,11 +182,11 @@ void Text::setText(std::string text, bool update)
 		return;
 	}
 
-	m_Text = text;
+	m_Text.assign(text);
 
 	if (update)
 	{
-		updateTexture();
+		updateLayout();
 	}
 }
 
@@ -106,11 +198,12 @@ void Text::setColour(const SDL_Color& colour, bool update)
 		return;
 	}
 
+	// Applied when drawing, so only pending font changes need a new layout
 	m_Colour = colour;
 
 	if (update)
 	{
-		updateTexture();
+		updateLayout();
 	}
 }
 
@@ -124,32 +217,25 @@ void Text::setSize(unsigned int size, bool update)
 
 	m_Size = size;
 
-	// Closes the old font
-	TTF_CloseFont(m_Font);
-
-	// Loads the font
-	m_Font = TTF_OpenFont(m_FontPath, size);
-
-	// Error checking for font
-	if (m_Font == nullptr)
-	{
-		error("Could not load font (filepath: ", m_FontPath, ").\nSDLError: ", SDL_GetError());
-		return;
-	}
-
 	if (update)
 	{
-		updateTexture();
+		updateLayout();
 	}
 }
 
 void Text::setStyle(int style, bool update)
 {
-	TTF_SetFontStyle(m_Font, style);
+	if (!m_Loaded)
+	{
+		warn("Tried to set text style before loading.");
+		return;
+	}
+
+	m_Style = style;
 
 	if (update)
 	{
-		updateTexture();
+		updateLayout();
 	}
 }
 
@@ -165,5 +251,21 @@ void Text::draw(unsigned int x, unsigned int y)
 	m_TextRect.x = x - (m_TextRect.w / 2);
 	m_TextRect.y = y - (m_TextRect.h / 2);
 
-	SDL_RenderCopy(m_Renderer, m_TextTexture, nullptr, &m_TextRect);
+	// Atlas pages are shared, so the colour is set on each draw
+	for (unsigned int page = 0; page < m_Font->getPageCount(); page++)
+	{
+		SDL_SetTextureColorMod(m_Font->getPage(page), m_Colour.r, m_Colour.g, m_Colour.b);
+		SDL_SetTextureAlphaMod(m_Font->getPage(page), m_Colour.a);
+	}
+
+	for (const PlacedGlyph& placed : m_Glyphs)
+	{
+		if (placed.glyph->source.w == 0)
+		{
+			continue;
+		}
+
+		SDL_Rect destination = { m_TextRect.x + placed.x, m_TextRect.y, placed.glyph->source.w, placed.glyph->source.h };
+		SDL_RenderCopy(m_Renderer, m_Font->getPage(placed.glyph->page), &placed.glyph->source, &destination);
+	}
 }
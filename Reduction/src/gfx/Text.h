@@ -1,48 +1,68 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <SDL/SDL.h>
 #include <SDL/SDL_ttf.h>
 
+#include "Font.h"
+
 
 class Text
 {
+	// A glyph of the text and where it starts along the line
+	struct PlacedGlyph
+	{
+		const Glyph* glyph;
+		int x;
+	};
+
 private:
-	// Whether the data and texture has been loaded
+	// Whether the data and font has been loaded
 	bool m_Loaded = false;
 
 	// Text data
-	const char* m_FontPath;
+	const char* m_FontPath = nullptr;
 	std::string m_Text;
-	unsigned int m_Size;
-	SDL_Color m_Colour;
-	SDL_Renderer* m_Renderer;
+	unsigned int m_Size = 0;
+	int m_Style = TTF_STYLE_NORMAL;
+	SDL_Color m_Colour = { 255, 255, 255, 255 };
+	SDL_Renderer* m_Renderer = nullptr;
 
-	// The font that will be used
-	TTF_Font* m_Font;
+	// The font that is drawn with (borrowed from the font cache), size and
+	// style changes only swap it on the next layout
+	Font* m_Font = nullptr;
+	unsigned int m_FontSize = 0;
+	int m_FontStyle = TTF_STYLE_NORMAL;
 
-	// SDL texture and it's rectangle
-	SDL_Texture* m_TextTexture;
-	SDL_Rect m_TextRect;
+	// Glyphs laid out along the line, drawn from the font's atlas
+	std::vector<PlacedGlyph> m_Glyphs;
+	SDL_Rect m_TextRect = { 0, 0, 0, 0 };
 
 private:
-	// Updates the texture to after data changes
-	void updateTexture();
+	// Swaps to the cached font for the current size and style
+	void updateFont();
+	// Lays out the glyphs after data changes
+	void updateLayout();
 
 public:
 	Text() = default;
-	Text(const char* fontPath, std::string text, unsigned int size, SDL_Color colour, SDL_Renderer* renderer);
+	Text(const char* fontPath, const std::string& text, unsigned int size, SDL_Color colour, SDL_Renderer* renderer);
 	~Text();
 
+	Text(const Text&) = delete;
+	Text& operator=(const Text&) = delete;
+
 	// Loads the text
-	void load(const char* fontPath, std::string text, unsigned int size, SDL_Color colour, SDL_Renderer* renderer);
+	void load(const char* fontPath, const std::string& text, unsigned int size, SDL_Color colour, SDL_Renderer* renderer);
 
 	// Whether the text has been clicked
 	bool rectCollides(int x, int y);
 
-	// Sets the text
-	void setText(std::string text, bool update = true);
+	// Sets the text (reuses the text's storage, so doesn't allocate once it has been as long)
+	void setText(const char* text, bool update = true);
+	void setText(const std::string& text, bool update = true) { setText(text.c_str(), update); }
 	// Sets the colour of the text
 	void setColour(const SDL_Color& colour, bool update = true);
 	// Sets the font size
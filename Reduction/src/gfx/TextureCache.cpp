@@ -0,0 +1,75 @@
+#include "TextureCache.h"
+
+#include "utils/Log.h"
+
+
+SDL_Renderer* TextureCache::s_Renderer = nullptr;
+std::unordered_map<std::string, TextureCache::Entry> TextureCache::s_Textures;
+unsigned int TextureCache::s_Hits = 0;
+unsigned int TextureCache::s_Misses = 0;
+
+
+void TextureCache::init(SDL_Renderer* renderer)
+{
+	s_Renderer = renderer;
+}
+
+
+SDL_Texture* TextureCache::acquire(const std::string& path)
+{
+	auto it = s_Textures.find(path);
+
+	if (it != s_Textures.end())
+	{
+		s_Hits += 1;
+		it->second.references += 1;
+
+		return it->second.texture;
+	}
+
+	s_Misses += 1;
+
+	// Decodes and uploads the file, only happens once per path
+	SDL_Texture* texture = IMG_LoadTexture(s_Renderer, path.c_str());
+
+	if (!texture)
+	{
+		error("Could not load texture (filepath: ", path, ").\nSDL_Error: ", SDL_GetError());
+		return nullptr;
+	}
+
+	s_Textures[path] = Entry { texture, 1 };
+
+	return texture;
+}
+
+void TextureCache::release(const std::string& path)
+{
+	auto it = s_Textures.find(path);
+
+	if (it == s_Textures.end())
+	{
+		warn("Tried to release a texture that is not loaded (filepath: ", path, ").");
+		return;
+	}
+
+	it->second.references -= 1;
+
+	if (it->second.references == 0)
+	{
+		SDL_DestroyTexture(it->second.texture);
+		s_Textures.erase(it);
+	}
+}
+
+void TextureCache::clear()
+{
+	info("Texture cache: ", s_Hits, " hits, ", s_Misses, " misses, ", s_Textures.size(), " textures still loaded.");
+
+	for (auto& [path, entry] : s_Textures)
+	{
+		SDL_DestroyTexture(entry.texture);
+	}
+
+	s_Textures.clear();
+}
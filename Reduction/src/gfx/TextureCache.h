@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include <SDL/SDL.h>
+#include <SDL/SDL_image.h>
+
+
+class TextureCache
+{
+private:
+	// A loaded texture and how many owners are borrowing it
+	struct Entry
+	{
+		SDL_Texture* texture = nullptr;
+		unsigned int references = 0;
+	};
+
+	// Renderer the textures are created for
+	static SDL_Renderer* s_Renderer;
+
+	// Loaded textures, keyed by file path
+	static std::unordered_map<std::string, Entry> s_Textures;
+
+	// Lookup statistics
+	static unsigned int s_Hits;
+	static unsigned int s_Misses;
+
+public:
+	// Sets the renderer that textures are created for
+	static void init(SDL_Renderer* renderer);
+
+	// Borrows the texture at path, loading it on first use (nullptr on failure)
+	static SDL_Texture* acquire(const std::string& path);
+	// Gives back a borrowed texture, destroying it once no-one is using it
+	static void release(const std::string& path);
+
+	// Destroys every texture, whether or not it is still borrowed
+	static void clear();
+
+	static unsigned int getHits() { return s_Hits; }
+	static unsigned int getMisses() { return s_Misses; }
+	static unsigned int getLoadedCount() { return (unsigned int) s_Textures.size(); }
+};
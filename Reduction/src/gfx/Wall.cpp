@@ -0,0 +1,76 @@
+#include "Wall.h"
+
+#include <cmath>
+
+#include "utils/Settings.h"
+
+
+Wall::Wall(SDL_Renderer* renderer)
+	: m_Renderer(renderer)
+{
+	// At most a rect either side of the gap on each row, plus the rows above and below it
+	m_Rects.reserve(SCREEN_HEIGHT * 2 + 2);
+}
+
+
+void Wall::draw(double scale)
+{
+	m_Rects.clear();
+
+	double radius = SCREEN_HEIGHT * scale / 2;
+	double centerX = SCREEN_WIDTH / 2.0;
+	double centerY = SCREEN_HEIGHT / 2.0;
+
+	// Rows entirely above and below the gap
+	int gapTop = (int) std::ceil(centerY - radius);
+	int gapBottom = (int) std::floor(centerY + radius);
+
+	if (gapTop < 0)
+	{
+		gapTop = 0;
+	}
+
+	if (gapBottom > SCREEN_HEIGHT)
+	{
+		gapBottom = SCREEN_HEIGHT;
+	}
+
+	if (gapTop > 0)
+	{
+		m_Rects.push_back(SDL_Rect { 0, 0, SCREEN_WIDTH, gapTop });
+	}
+
+	if (gapBottom < SCREEN_HEIGHT)
+	{
+		m_Rects.push_back(SDL_Rect { 0, gapBottom, SCREEN_WIDTH, SCREEN_HEIGHT - gapBottom });
+	}
+
+	// Rows crossing the gap are covered either side of it
+	for (int y = gapTop; y < gapBottom; y++)
+	{
+		double distanceY = y + 0.5 - centerY;
+		double halfWidthSquared = radius * radius - distanceY * distanceY;
+		double halfWidth = halfWidthSquared > 0 ? std::sqrt(halfWidthSquared) : 0;
+
+		int left = (int) std::lround(centerX - halfWidth);
+		int right = (int) std::lround(centerX + halfWidth);
+
+		if (left > 0)
+		{
+			m_Rects.push_back(SDL_Rect { 0, y, left, 1 });
+		}
+
+		if (right < SCREEN_WIDTH)
+		{
+			m_Rects.push_back(SDL_Rect { right, y, SCREEN_WIDTH - right, 1 });
+		}
+	}
+
+	// Same translucent blue as the old mask texture
+	SDL_BlendMode previousBlendMode;
+	SDL_GetRenderDrawBlendMode(m_Renderer, &previousBlendMode);
+	SDL_SetRenderDrawBlendMode(m_Renderer, SDL_BLENDMODE_BLEND);
+	SDL_SetRenderDrawColor(m_Renderer, 0, 168, 243, 60);
+	SDL_RenderFillRects(m_Renderer, m_Rects.data(), (int) m_Rects.size());
+	SDL_SetRenderDrawBlendMode(m_Renderer, previousBlendMode);
+}
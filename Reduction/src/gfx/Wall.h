@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vector>
+
+#include <SDL/SDL.h>
+
+
+// Draws the shrinking wall as the area outside a circle centred on the screen
+class Wall
+{
+private:
+	SDL_Renderer* m_Renderer;
+
+	// Rects covering the wall, rebuilt every draw (capacity reserved up front)
+	std::vector<SDL_Rect> m_Rects;
+
+public:
+	explicit Wall(SDL_Renderer* renderer);
+
+	// Draws the wall with a gap of SCREEN_HEIGHT * scale diameter (matches the simulation)
+	void draw(double scale);
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+
+// Appends values of any width up to 32 bits, packed with no padding between them (least
+// significant bit first, so a field can straddle bytes). The vector grows in blocks ahead of
+// the data and is only trimmed to size by flush().
+class BitWriter
+{
+	// Bytes the vector grows by when a word doesn't fit
+	static constexpr size_t GROWTH = 256;
+
+private:
+	std::vector<unsigned char>& m_Out;
+	// Where the next whole byte goes
+	size_t m_Position;
+
+	// Bits written but not yet stored as whole bytes
+	unsigned long long m_Pending = 0;
+	unsigned int m_PendingCount = 0;
+	size_t m_BitsWritten = 0;
+
+public:
+	explicit BitWriter(std::vector<unsigned char>& out)
+		: m_Out(out), m_Position(out.size())
+	{
+	}
+
+	void write(unsigned int value, unsigned int bits)
+	{
+		m_Pending |= (unsigned long long) (value & (unsigned int) ((1ull << bits) - 1)) << m_PendingCount;
+		m_PendingCount += bits;
+		m_BitsWritten += bits;
+
+		// Stores whole words, so most writes don't touch the vector at all
+		if (m_PendingCount >= 32)
+		{
+			if (m_Position + 4 > m_Out.size())
+			{
+				m_Out.resize(m_Position + GROWTH);
+			}
+
+			unsigned char* word = m_Out.data() + m_Position;
+			word[0] = (unsigned char) m_Pending;
+			word[1] = (unsigned char) (m_Pending >> 8);
+			word[2] = (unsigned char) (m_Pending >> 16);
+			word[3] = (unsigned char) (m_Pending >> 24);
+
+			m_Position += 4;
+			m_Pending >>= 32;
+			m_PendingCount -= 32;
+		}
+	}
+
+	void writeBool(bool value) { write((unsigned int) value, 1); }
+
+	// Stores the bits still pending, the last byte padded with zeros, and trims the vector to
+	// the data (call once everything is written)
+	void flush()
+	{
+		m_Out.resize(m_Position);
+
+		while (m_PendingCount > 0)
+		{
+			m_Out.push_back((unsigned char) m_Pending);
+			m_Pending >>= 8;
+			m_PendingCount = m_PendingCount > 8 ? m_PendingCount - 8 : 0;
+		}
+
+		m_Position = m_Out.size();
+	}
+
+	size_t getBitsWritten() const { return m_BitsWritten; }
+};
+
+
+// Reads back what a BitWriter wrote. Reading past the end gives zeros and marks the reader as
+// overrun, so a decoder can read a whole message and check once at the end.
+class BitReader
+{
+private:
+	const unsigned char* m_Data;
+	size_t m_Size;
+	size_t m_Offset = 0;
+
+	unsigned long long m_Pending = 0;
+	unsigned int m_PendingCount = 0;
+	bool m_Overrun = false;
+
+public:
+	BitReader(const unsigned char* data, size_t size)
+		: m_Data(data), m_Size(size)
+	{
+	}
+
+	unsigned int read(unsigned int bits)
+	{
+		if (m_PendingCount < bits)
+		{
+			// Tops up to at least 32 bits pending, a word at a time where the data allows
+			if (m_Size - m_Offset >= 4)
+			{
+				m_Pending |= ((unsigned long long) m_Data[m_Offset] | (unsigned long long) m_Data[m_Offset + 1] << 8 |
+					(unsigned long long) m_Data[m_Offset + 2] << 16 | (unsigned long long) m_Data[m_Offset + 3] << 24) << m_PendingCount;
+				m_Offset += 4;
+				m_PendingCount += 32;
+			}
+
+			while (m_PendingCount < bits)
+			{
+				if (m_Offset < m_Size)
+				{
+					m_Pending |= (unsigned long long) m_Data[m_Offset++] << m_PendingCount;
+				}
+
+				else
+				{
+					m_Overrun = true;
+				}
+
+				m_PendingCount += 8;
+			}
+		}
+
+		unsigned int value = (unsigned int) (m_Pending & ((1ull << bits) - 1));
+		m_Pending >>= bits;
+		m_PendingCount -= bits;
+
+		return value;
+	}
+
+	bool readBool() { return read(1) != 0; }
+
+	// Whether every read so far was within the data
+	bool isValid() const { return !m_Overrun; }
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+
+// Every message starts with a type byte and the session id (the match seed), so stray
+// packets from another match on the same port are ignored.
+//
+// Input message, sent by each peer to every other peer as often as it ticks:
+//   type byte, 4 byte session id, sender's player slot byte,
+//   4 byte ack (how many ticks of the receiver's inputs the sender has, with none missing),
+//   4 byte first tick, input count byte, then per input: a replay input flags byte and,
+//   if it aims, 2 byte aim x and y
+// Inputs are resent from the last ack, so a lost packet is covered by the next one.
+// Fixed width fields are little endian.
+
+constexpr unsigned char NET_INPUT_MESSAGE = 1;
+
+// Most inputs in one message (peers wait rather than fall further behind than this)
+constexpr unsigned int NET_MAX_INPUTS_PER_MESSAGE = 64;
+// Largest message that can be sent or received
+constexpr unsigned int NET_MAX_MESSAGE_SIZE = 15 + NET_MAX_INPUTS_PER_MESSAGE * 5;
@@ -0,0 +1,75 @@
+#include "NetworkEmulator.h"
+
+
+NetworkEmulator::NetworkEmulator(const NetworkConditions& conditions, unsigned int seed)
+	: m_Conditions(conditions), m_Rng(seed)
+{
+}
+
+
+void NetworkEmulator::send(UdpSocket& socket, const NetAddress& address, const void* data, size_t size)
+{
+	m_PacketsSent += 1;
+
+	if (m_Conditions.lossChance > 0.0 && std::uniform_real_distribution<>(0.0, 1.0)(m_Rng) < m_Conditions.lossChance)
+	{
+		m_PacketsDropped += 1;
+		return;
+	}
+
+	double delay = m_Conditions.latencyMilliseconds;
+
+	if (m_Conditions.jitterMilliseconds > 0.0)
+	{
+		delay += std::uniform_real_distribution<>(0.0, m_Conditions.jitterMilliseconds)(m_Rng);
+	}
+
+	if (delay <= 0.0)
+	{
+		socket.send(address, data, size);
+		return;
+	}
+
+	DelayedPacket packet;
+	packet.sendTime = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(delay));
+	packet.address = address;
+
+	if (!m_FreeBuffers.empty())
+	{
+		packet.data = std::move(m_FreeBuffers.back());
+		m_FreeBuffers.pop_back();
+	}
+
+	const unsigned char* bytes = (const unsigned char*) data;
+	packet.data.assign(bytes, bytes + size);
+
+	m_Packets.push_back(std::move(packet));
+}
+
+void NetworkEmulator::flush(UdpSocket& socket)
+{
+	Clock::time_point now = Clock::now();
+
+	// Jitter can let a later packet overtake an earlier one, just like a real link
+	for (unsigned int i = 0; i < m_Packets.size();)
+	{
+		DelayedPacket& packet = m_Packets[i];
+
+		if (packet.sendTime > now)
+		{
+			i++;
+			continue;
+		}
+
+		socket.send(packet.address, packet.data.data(), packet.data.size());
+
+		m_FreeBuffers.push_back(std::move(packet.data));
+
+		if (i + 1 < m_Packets.size())
+		{
+			packet = std::move(m_Packets.back());
+		}
+
+		m_Packets.pop_back();
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "UdpSocket.h"
+
+
+// Conditions to emulate on outgoing packets (all zero sends straight away)
+struct NetworkConditions
+{
+	// One-way delay added to every packet, plus up to jitter more at random
+	double latencyMilliseconds = 0.0;
+	double jitterMilliseconds = 0.0;
+	// Chance of a packet being dropped, from 0 to 1
+	double lossChance = 0.0;
+};
+
+
+// Holds outgoing packets back to emulate a slow, lossy link on localhost
+class NetworkEmulator
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct DelayedPacket
+	{
+		Clock::time_point sendTime;
+		NetAddress address;
+		std::vector<unsigned char> data;
+	};
+
+private:
+	NetworkConditions m_Conditions;
+
+	// Its own generator, so emulating never touches a simulation's random sequence
+	std::mt19937 m_Rng;
+
+	std::vector<DelayedPacket> m_Packets;
+	// Buffers of packets already sent, reused so a steady stream doesn't allocate
+	std::vector<std::vector<unsigned char>> m_FreeBuffers;
+
+	unsigned long long m_PacketsSent = 0;
+	unsigned long long m_PacketsDropped = 0;
+
+public:
+	explicit NetworkEmulator(const NetworkConditions& conditions = NetworkConditions {}, unsigned int seed = 0);
+
+	// Sends a packet once its delay has passed, unless it is dropped
+	void send(UdpSocket& socket, const NetAddress& address, const void* data, size_t size);
+	// Sends every packet whose delay has passed (call often, delays are only as accurate as this)
+	void flush(UdpSocket& socket);
+
+	const NetworkConditions& getConditions() const { return m_Conditions; }
+	unsigned long long getPacketsSent() const { return m_PacketsSent; }
+	unsigned long long getPacketsDropped() const { return m_PacketsDropped; }
+};
@@ -0,0 +1,356 @@
+#include "RollbackSession.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "NetMessages.h"
+#include "replay/ReplayFormat.h"
+#include "utils/ByteIO.h"
+#include "utils/Log.h"
+
+
+// Rounds an input to what survives being sent, so the local player plays what peers receive
+static PlayerInput normaliseInput(const PlayerInput& input)
+{
+	PlayerInput normalised;
+	unpackInputFlags(packInputFlags(input), normalised);
+
+	if (normalised.hasAimTarget)
+	{
+		normalised.aimX = std::min(std::max(input.aimX, 0), 0xFFFF);
+		normalised.aimY = std::min(std::max(input.aimY, 0), 0xFFFF);
+	}
+
+	return normalised;
+}
+
+static bool isSameInput(const PlayerInput& a, const PlayerInput& b)
+{
+	if (packInputFlags(a) != packInputFlags(b))
+	{
+		return false;
+	}
+
+	return !a.hasAimTarget || (a.aimX == b.aimX && a.aimY == b.aimY);
+}
+
+
+RollbackSession::RollbackSession(Simulation& simulation, const RollbackConfig& config)
+	: m_Simulation(simulation), m_Config(config)
+{
+}
+
+
+bool RollbackSession::start(unsigned short port, const std::vector<NetAddress>& peers, const NetworkConditions& conditions)
+{
+	if (m_Config.playerCount < 2 || m_Config.playerCount > 3 || m_Config.localPlayer >= m_Config.playerCount || peers.size() < m_Config.playerCount)
+	{
+		error("Online match needs an address for each of its 2 or 3 players, and a local player among them.");
+		return false;
+	}
+
+	if (!m_Socket.open(port))
+	{
+		return false;
+	}
+
+	m_Peers = peers;
+	m_Emulator = NetworkEmulator(conditions, m_Config.seed + m_Config.localPlayer);
+
+	// Every peer starts from the same world
+	m_Simulation.seed(m_Config.seed);
+	m_Simulation.initPlayers(m_Config.playerCount);
+	m_Simulation.resetWall();
+
+	m_Tick = 0;
+	m_MatchFlow = MatchFlow {};
+	m_RollbackTick = NO_ROLLBACK;
+
+	// The first inputDelay ticks have no inputs, so every player's are known to be the default
+	m_Inputs.assign(ROLLBACK_INPUT_HISTORY, std::vector<PlayerInput>(m_Config.playerCount));
+	m_ReceivedTicks.assign(m_Config.playerCount, m_Config.inputDelay);
+	m_PeerAcks.assign(m_Config.playerCount, m_Config.inputDelay);
+
+	m_Snapshots.clear();
+	m_SnapshotFlows.assign(m_Config.maxRollback + 1, MatchFlow {});
+
+	for (unsigned int i = 0; i < m_Config.maxRollback + 1; i++)
+	{
+		m_Snapshots.emplace_back(m_Simulation.getMaxStateSize());
+	}
+
+	m_Message.reserve(NET_MAX_MESSAGE_SIZE);
+	m_ReceiveBuffer.resize(NET_MAX_MESSAGE_SIZE);
+
+	m_LastResimulatedTicks = 0;
+	m_LastResimulationTime = 0.0;
+	m_ResimulatedTicks = 0;
+	m_Rollbacks = 0;
+	m_Stalls = 0;
+
+	return true;
+}
+
+
+bool RollbackSession::advance(const PlayerInput& localInput)
+{
+	m_LastResimulatedTicks = 0;
+	m_LastResimulationTime = 0.0;
+
+	receiveMessages();
+
+	unsigned long long& localTicks = m_ReceivedTicks[m_Config.localPlayer];
+	unsigned long long oldestAck = localTicks;
+
+	for (unsigned int player = 0; player < m_Config.playerCount; player++)
+	{
+		if (player != m_Config.localPlayer)
+		{
+			oldestAck = std::min(oldestAck, m_PeerAcks[player]);
+		}
+	}
+
+	// Waits for the slowest peer rather than predict past the rollback window, or
+	// send more inputs than fit in a message
+	if (m_Tick >= getOldestReceivedTick() + m_Config.maxRollback || localTicks >= oldestAck + NET_MAX_INPUTS_PER_MESSAGE)
+	{
+		m_Stalls += 1;
+
+		correct();
+		sendInputs();
+		m_Emulator.flush(m_Socket);
+
+		return false;
+	}
+
+	// The input is played inputDelay ticks from now
+	m_Inputs[localTicks % ROLLBACK_INPUT_HISTORY][m_Config.localPlayer] = normaliseInput(localInput);
+	localTicks += 1;
+
+	sendInputs();
+	correct();
+
+	playTick(m_Tick);
+	m_Tick += 1;
+
+	m_Emulator.flush(m_Socket);
+
+	return true;
+}
+
+void RollbackSession::poll()
+{
+	receiveMessages();
+	sendInputs();
+	m_Emulator.flush(m_Socket);
+}
+
+void RollbackSession::correct()
+{
+	if (m_RollbackTick == NO_ROLLBACK)
+	{
+		return;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	unsigned int slot = (unsigned int) (m_RollbackTick % m_Snapshots.size());
+	m_Simulation.restoreSnapshot(m_Snapshots[slot]);
+	m_MatchFlow = m_SnapshotFlows[slot];
+
+	unsigned int ticks = (unsigned int) (m_Tick - m_RollbackTick);
+
+	for (unsigned long long tick = m_RollbackTick; tick < m_Tick; tick++)
+	{
+		playTick(tick);
+	}
+
+	m_RollbackTick = NO_ROLLBACK;
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+	m_LastResimulatedTicks += ticks;
+	m_LastResimulationTime += elapsed.count();
+	m_ResimulatedTicks += ticks;
+	m_Rollbacks += 1;
+}
+
+
+const std::vector<PlayerInput>& RollbackSession::predictInputs(unsigned long long tick)
+{
+	std::vector<PlayerInput>& inputs = m_Inputs[tick % ROLLBACK_INPUT_HISTORY];
+
+	// A player is predicted to carry on doing what they last did
+	for (unsigned int player = 0; player < m_Config.playerCount; player++)
+	{
+		unsigned long long received = m_ReceivedTicks[player];
+
+		if (tick >= received)
+		{
+			inputs[player] = received > 0 ? m_Inputs[(received - 1) % ROLLBACK_INPUT_HISTORY][player] : PlayerInput {};
+		}
+	}
+
+	return inputs;
+}
+
+void RollbackSession::playTick(unsigned long long tick)
+{
+	unsigned int slot = (unsigned int) (tick % m_Snapshots.size());
+	m_Simulation.saveSnapshot(m_Snapshots[slot]);
+	m_SnapshotFlows[slot] = m_MatchFlow;
+
+	m_Simulation.step(predictInputs(tick));
+
+	m_MatchFlow.update(m_Simulation, tick + 1, m_Config.pointsToWin);
+}
+
+
+void RollbackSession::sendInputs()
+{
+	unsigned long long localTicks = m_ReceivedTicks[m_Config.localPlayer];
+
+	for (unsigned int player = 0; player < m_Config.playerCount; player++)
+	{
+		if (player == m_Config.localPlayer)
+		{
+			continue;
+		}
+
+		unsigned long long firstTick = m_PeerAcks[player];
+
+		if (localTicks - firstTick > NET_MAX_INPUTS_PER_MESSAGE)
+		{
+			firstTick = localTicks - NET_MAX_INPUTS_PER_MESSAGE;
+		}
+
+		m_Message.clear();
+		m_Message.push_back(NET_INPUT_MESSAGE);
+		writeFixed(m_Message, m_Config.seed);
+		m_Message.push_back((unsigned char) m_Config.localPlayer);
+		writeFixed(m_Message, (unsigned int) m_ReceivedTicks[player]);
+		writeFixed(m_Message, (unsigned int) firstTick);
+		m_Message.push_back((unsigned char) (localTicks - firstTick));
+
+		for (unsigned long long tick = firstTick; tick < localTicks; tick++)
+		{
+			const PlayerInput& input = m_Inputs[tick % ROLLBACK_INPUT_HISTORY][m_Config.localPlayer];
+			m_Message.push_back(packInputFlags(input));
+
+			if (input.hasAimTarget)
+			{
+				writeFixed(m_Message, (unsigned short) input.aimX);
+				writeFixed(m_Message, (unsigned short) input.aimY);
+			}
+		}
+
+		m_Emulator.send(m_Socket, m_Peers[player], m_Message.data(), m_Message.size());
+	}
+}
+
+void RollbackSession::receiveMessages()
+{
+	NetAddress from;
+	int size;
+
+	while ((size = m_Socket.receive(m_ReceiveBuffer.data(), m_ReceiveBuffer.size(), from)) >= 0)
+	{
+		handleMessage(m_ReceiveBuffer.data(), (size_t) size);
+	}
+}
+
+void RollbackSession::handleMessage(const unsigned char* data, size_t size)
+{
+	size_t offset = 0;
+	unsigned char type;
+	unsigned int sessionId;
+	unsigned char sender;
+	unsigned int ack;
+	unsigned int firstTick;
+	unsigned char count;
+
+	if (!readFixed(data, size, offset, type) || type != NET_INPUT_MESSAGE ||
+		!readFixed(data, size, offset, sessionId) || sessionId != m_Config.seed ||
+		!readFixed(data, size, offset, sender) || sender >= m_Config.playerCount || sender == m_Config.localPlayer ||
+		!readFixed(data, size, offset, ack) || !readFixed(data, size, offset, firstTick) || !readFixed(data, size, offset, count))
+	{
+		return;
+	}
+
+	// Acks only move forward, however packets are reordered
+	m_PeerAcks[sender] = std::max(m_PeerAcks[sender], std::min((unsigned long long) ack, m_ReceivedTicks[m_Config.localPlayer]));
+
+	unsigned long long& received = m_ReceivedTicks[sender];
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		PlayerInput input;
+		unsigned char flags;
+
+		if (!readFixed(data, size, offset, flags))
+		{
+			return;
+		}
+
+		unpackInputFlags(flags, input);
+
+		if (input.hasAimTarget)
+		{
+			unsigned short aimX;
+			unsigned short aimY;
+
+			if (!readFixed(data, size, offset, aimX) || !readFixed(data, size, offset, aimY))
+			{
+				return;
+			}
+
+			input.aimX = aimX;
+			input.aimY = aimY;
+		}
+
+		unsigned long long tick = (unsigned long long) firstTick + i;
+
+		// Inputs are only taken in order; anything after a gap is resent once the ack catches up
+		if (tick < received)
+		{
+			continue;
+		}
+
+		if (tick > received || tick >= m_Tick + ROLLBACK_INPUT_HISTORY - m_Snapshots.size())
+		{
+			return;
+		}
+
+		PlayerInput& stored = m_Inputs[tick % ROLLBACK_INPUT_HISTORY][sender];
+
+		if (tick < m_Tick && tick < m_RollbackTick && !isSameInput(stored, input))
+		{
+			// Can't happen while advance() waits for slow peers, but would desync if it did
+			if (tick + m_Snapshots.size() <= m_Tick)
+			{
+				warn("Input for tick ", tick, " arrived too late to roll back to.");
+			}
+
+			else
+			{
+				m_RollbackTick = tick;
+			}
+		}
+
+		stored = input;
+		received += 1;
+	}
+}
+
+
+unsigned long long RollbackSession::getOldestReceivedTick() const
+{
+	unsigned long long oldest = m_ReceivedTicks.empty() ? 0 : m_ReceivedTicks[0];
+
+	for (unsigned long long received : m_ReceivedTicks)
+	{
+		oldest = std::min(oldest, received);
+	}
+
+	return oldest;
+}
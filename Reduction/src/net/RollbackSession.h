@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vector>
+
+#include "NetworkEmulator.h"
+#include "UdpSocket.h"
+#include "sim/MatchFlow.h"
+#include "sim/Simulation.h"
+#include "sim/SimSnapshot.h"
+#include "utils/Settings.h"
+
+
+// How the match is set up, which every peer must agree on
+struct RollbackConfig
+{
+	unsigned int seed = 0;
+	unsigned int playerCount = 2;
+	unsigned int localPlayer = 0;
+	unsigned int pointsToWin = 3;
+	unsigned int inputDelay = ROLLBACK_INPUT_DELAY;
+	unsigned int maxRollback = ROLLBACK_MAX_TICKS;
+};
+
+// Peer-to-peer online play: local inputs are delayed a few ticks and sent to every peer,
+// remote inputs that haven't arrived are predicted, and when they arrive different from the
+// prediction the world is restored to before that tick and played forward again.
+class RollbackSession
+{
+private:
+	Simulation& m_Simulation;
+	RollbackConfig m_Config;
+
+	UdpSocket m_Socket;
+	NetworkEmulator m_Emulator;
+	// Address of each player slot (the local slot's is unused)
+	std::vector<NetAddress> m_Peers;
+
+	// Next tick to play, the world is as it was before it
+	unsigned long long m_Tick = 0;
+	MatchFlow m_MatchFlow;
+
+	// Inputs of every player for the last ROLLBACK_INPUT_HISTORY ticks (tick % history, then player),
+	// with predictions standing in for remote inputs not yet received
+	std::vector<std::vector<PlayerInput>> m_Inputs;
+	// Ticks of each player's inputs held, with none missing (the local player's run ahead by the input delay)
+	std::vector<unsigned long long> m_ReceivedTicks;
+	// Ticks of the local player's inputs each peer says it holds
+	std::vector<unsigned long long> m_PeerAcks;
+
+	// World and round flow before each of the last maxRollback + 1 ticks
+	std::vector<SimSnapshot> m_Snapshots;
+	std::vector<MatchFlow> m_SnapshotFlows;
+
+	// Earliest tick played with a prediction that turned out wrong
+	static constexpr unsigned long long NO_ROLLBACK = ~0ull;
+	unsigned long long m_RollbackTick = NO_ROLLBACK;
+
+	// Reused for building and receiving messages
+	std::vector<unsigned char> m_Message;
+	std::vector<unsigned char> m_ReceiveBuffer;
+
+	// Cost of the last advance() and totals since the start
+	unsigned int m_LastResimulatedTicks = 0;
+	double m_LastResimulationTime = 0.0;
+	unsigned long long m_ResimulatedTicks = 0;
+	unsigned long long m_Rollbacks = 0;
+	unsigned long long m_Stalls = 0;
+
+private:
+	// Inputs of a tick, filling in predictions for players whose input hasn't arrived
+	const std::vector<PlayerInput>& predictInputs(unsigned long long tick);
+	// Saves the world before a tick, then plays it and the round flow
+	void playTick(unsigned long long tick);
+
+	// Sends the local inputs each peer hasn't acknowledged
+	void sendInputs();
+	// Reads every waiting message
+	void receiveMessages();
+	void handleMessage(const unsigned char* data, size_t size);
+
+	// Ticks of inputs every player has, with none missing
+	unsigned long long getOldestReceivedTick() const;
+
+public:
+	RollbackSession(Simulation& simulation, const RollbackConfig& config);
+
+	// Sets the world up for the match and starts listening on port (false if the port can't be used)
+	bool start(unsigned short port, const std::vector<NetAddress>& peers, const NetworkConditions& conditions = NetworkConditions {});
+
+	// Plays the next tick with the local player's input, rolling back first if a prediction was
+	// wrong (false if it had to wait because a peer is too far behind)
+	bool advance(const PlayerInput& localInput);
+	// Sends and receives without playing a tick
+	void poll();
+	// Rolls back and replays any mispredicted ticks without playing a new one
+	void correct();
+
+	// Whether the world has been played with every player's real inputs
+	bool isConfirmed() const { return getOldestReceivedTick() >= m_Tick && m_RollbackTick == NO_ROLLBACK; }
+
+	unsigned long long getTick() const { return m_Tick; }
+	unsigned long long getConfirmedTick() const { return getOldestReceivedTick(); }
+	const MatchFlow& getMatchFlow() const { return m_MatchFlow; }
+	const RollbackConfig& getConfig() const { return m_Config; }
+	const NetworkEmulator& getEmulator() const { return m_Emulator; }
+
+	unsigned int getLastResimulatedTicks() const { return m_LastResimulatedTicks; }
+	// Milliseconds the last advance() spent re-simulating
+	double getLastResimulationTime() const { return m_LastResimulationTime; }
+	unsigned long long getResimulatedTicks() const { return m_ResimulatedTicks; }
+	unsigned long long getRollbacks() const { return m_Rollbacks; }
+	unsigned long long getStalls() const { return m_Stalls; }
+};
@@ -0,0 +1,128 @@
+#include "SharedPacket.h"
+
+
+SharedPacket::SharedPacket(PacketBuffer* buffer)
+	: m_Buffer(buffer)
+{
+	m_Buffer->m_References.fetch_add(1, std::memory_order_relaxed);
+}
+
+SharedPacket::SharedPacket(const SharedPacket& other)
+	: m_Buffer(other.m_Buffer)
+{
+	if (m_Buffer)
+	{
+		m_Buffer->m_References.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+SharedPacket::SharedPacket(SharedPacket&& other) noexcept
+	: m_Buffer(other.m_Buffer)
+{
+	other.m_Buffer = nullptr;
+}
+
+SharedPacket::~SharedPacket()
+{
+	reset();
+}
+
+SharedPacket& SharedPacket::operator=(const SharedPacket& other)
+{
+	if (m_Buffer != other.m_Buffer)
+	{
+		reset();
+		m_Buffer = other.m_Buffer;
+
+		if (m_Buffer)
+		{
+			m_Buffer->m_References.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	return *this;
+}
+
+SharedPacket& SharedPacket::operator=(SharedPacket&& other) noexcept
+{
+	if (this != &other)
+	{
+		reset();
+		m_Buffer = other.m_Buffer;
+		other.m_Buffer = nullptr;
+	}
+
+	return *this;
+}
+
+void SharedPacket::reset()
+{
+	// The last reference out makes sure every other thread's reads happened before it is reused
+	if (m_Buffer && m_Buffer->m_References.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		m_Buffer->m_Pool->release(m_Buffer);
+	}
+
+	m_Buffer = nullptr;
+}
+
+
+PacketPool::PacketPool(size_t bufferCapacity)
+	: m_BufferCapacity(bufferCapacity)
+{
+}
+
+PacketPool::~PacketPool()
+{
+	for (PacketBuffer* buffer : m_Buffers)
+	{
+		delete buffer;
+	}
+}
+
+SharedPacket PacketPool::acquire()
+{
+	PacketBuffer* buffer = nullptr;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (!m_Free.empty())
+		{
+			buffer = m_Free.back();
+			m_Free.pop_back();
+		}
+
+		else
+		{
+			buffer = new PacketBuffer(this);
+			buffer->m_Data.reserve(m_BufferCapacity);
+
+			m_Buffers.push_back(buffer);
+			// Every buffer can be free at once, so releasing never allocates
+			m_Free.reserve(m_Buffers.size());
+		}
+	}
+
+	buffer->m_Data.clear();
+
+	return SharedPacket(buffer);
+}
+
+void PacketPool::release(PacketBuffer* buffer)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Free.push_back(buffer);
+}
+
+size_t PacketPool::getMemoryUsage() const
+{
+	size_t usage = (m_Free.capacity() + m_Buffers.capacity()) * sizeof(PacketBuffer*);
+
+	for (const PacketBuffer* buffer : m_Buffers)
+	{
+		usage += sizeof(PacketBuffer) + buffer->m_Data.capacity();
+	}
+
+	return usage;
+}
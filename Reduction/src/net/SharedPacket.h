@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+
+class PacketPool;
+
+
+// Message bytes shared by everyone it is sent to. Written once before it is published and never
+// changed after, so any thread holding a reference can read it without locking.
+class PacketBuffer
+{
+	friend class PacketPool;
+	friend class SharedPacket;
+
+private:
+	std::atomic<unsigned int> m_References { 0 };
+	std::vector<unsigned char> m_Data;
+	PacketPool* m_Pool;
+
+private:
+	explicit PacketBuffer(PacketPool* pool)
+		: m_Pool(pool)
+	{
+	}
+
+public:
+	PacketBuffer(const PacketBuffer&) = delete;
+	PacketBuffer& operator=(const PacketBuffer&) = delete;
+
+	// Only to be written while the buffer has a single reference, before it is shared
+	std::vector<unsigned char>& getData() { return m_Data; }
+	const std::vector<unsigned char>& getData() const { return m_Data; }
+};
+
+
+// Counted reference to a pooled buffer, which goes back to its pool when the last one is released
+class SharedPacket
+{
+private:
+	PacketBuffer* m_Buffer = nullptr;
+
+public:
+	SharedPacket() = default;
+	explicit SharedPacket(PacketBuffer* buffer);
+	SharedPacket(const SharedPacket& other);
+	SharedPacket(SharedPacket&& other) noexcept;
+	~SharedPacket();
+
+	SharedPacket& operator=(const SharedPacket& other);
+	SharedPacket& operator=(SharedPacket&& other) noexcept;
+
+	// Drops this reference
+	void reset();
+
+	const unsigned char* getData() const { return m_Buffer->getData().data(); }
+	size_t getSize() const { return m_Buffer->getData().size(); }
+	bool isEmpty() const { return m_Buffer == nullptr; }
+	// Only valid while this is the only reference (the owner filling it in)
+	std::vector<unsigned char>& getBuffer() { return m_Buffer->getData(); }
+};
+
+
+// Recycles packet buffers, so publishing doesn't allocate once enough are in circulation.
+// Buffers can be released from any thread.
+class PacketPool
+{
+	friend class SharedPacket;
+
+private:
+	std::mutex m_Mutex;
+	std::vector<PacketBuffer*> m_Free;
+	std::vector<PacketBuffer*> m_Buffers;
+	size_t m_BufferCapacity;
+
+private:
+	void release(PacketBuffer* buffer);
+
+public:
+	// Each new buffer reserves capacity bytes
+	explicit PacketPool(size_t bufferCapacity);
+	// Every packet must have been released first
+	~PacketPool();
+
+	PacketPool(const PacketPool&) = delete;
+	PacketPool& operator=(const PacketPool&) = delete;
+
+	// An empty buffer with a single reference
+	SharedPacket acquire();
+
+	// Buffers created so far (the most ever in use at once)
+	size_t getBufferCount() const { return m_Buffers.size(); }
+	// Bytes allocated on the heap
+	size_t getMemoryUsage() const;
+};
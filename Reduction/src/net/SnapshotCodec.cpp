@@ -0,0 +1,540 @@
+#include "SnapshotCodec.h"
+
+#include "utils/Varint.h"
+
+
+// Widest delta of a position, direction or tick
+constexpr unsigned int POSITION_DELTA_BITS = SNAPSHOT_POSITION_BITS + 1;
+constexpr unsigned int DIRECTION_DELTA_BITS = SNAPSHOT_DIRECTION_BITS;
+constexpr unsigned int TICK_DELTA_BITS = 32;
+
+constexpr unsigned int PLAYER_COUNT_BITS = SNAPSHOT_OWNER_BITS + 1;
+
+
+// Writes a signed difference with a prefix code sized for small values:
+// 0 is "0", then "10" + 3 bits, "110" + 6 bits, or "111" + fullBits (all zigzag encoded)
+static void writeDelta(BitWriter& writer, int value, unsigned int fullBits)
+{
+	unsigned int zigzag = (unsigned int) zigzagEncode(value);
+
+	if (zigzag == 0)
+	{
+		writer.write(0, 1);
+	}
+
+	else if (zigzag < (1 << 3))
+	{
+		writer.write(0x1 | zigzag << 2, 5);
+	}
+
+	else if (zigzag < (1 << 6))
+	{
+		writer.write(0x3 | zigzag << 3, 9);
+	}
+
+	else
+	{
+		writer.write(0x7, 3);
+		writer.write(zigzag, fullBits);
+	}
+}
+
+static int readDelta(BitReader& reader, unsigned int fullBits)
+{
+	unsigned int bits = 0;
+
+	if (reader.readBool())
+	{
+		bits = !reader.readBool() ? 3 : (!reader.readBool() ? 6 : fullBits);
+	}
+
+	return bits > 0 ? (int) zigzagDecode(reader.read(bits)) : 0;
+}
+
+// Difference between two directions the short way round
+static int directionDelta(unsigned short to, unsigned short from)
+{
+	constexpr int TURN = 1 << SNAPSHOT_DIRECTION_BITS;
+
+	int delta = ((int) to - (int) from) & (TURN - 1);
+
+	return delta >= TURN / 2 ? delta - TURN : delta;
+}
+
+
+static void writePlayer(BitWriter& writer, const QuantizedPlayer& player)
+{
+	writer.write(player.x, SNAPSHOT_POSITION_BITS);
+	writer.write(player.y, SNAPSHOT_POSITION_BITS);
+	writer.write(player.direction, SNAPSHOT_DIRECTION_BITS);
+	writer.write(player.life, SNAPSHOT_LIFE_BITS);
+	writer.write(player.points, SNAPSHOT_POINTS_BITS);
+	writer.writeBool(player.isAlive);
+}
+
+static void readPlayer(BitReader& reader, QuantizedPlayer& player)
+{
+	player.x = (unsigned short) reader.read(SNAPSHOT_POSITION_BITS);
+	player.y = (unsigned short) reader.read(SNAPSHOT_POSITION_BITS);
+	player.direction = (unsigned short) reader.read(SNAPSHOT_DIRECTION_BITS);
+	player.life = (unsigned char) reader.read(SNAPSHOT_LIFE_BITS);
+	player.points = (unsigned char) reader.read(SNAPSHOT_POINTS_BITS);
+	player.isAlive = reader.readBool();
+}
+
+// Each changed field is flagged, and only the alive flag is always written
+static void writePlayerDelta(BitWriter& writer, const QuantizedPlayer& player, const QuantizedPlayer& base)
+{
+	bool moved = player.x != base.x || player.y != base.y;
+	writer.writeBool(moved);
+
+	if (moved)
+	{
+		writeDelta(writer, (int) player.x - (int) base.x, POSITION_DELTA_BITS);
+		writeDelta(writer, (int) player.y - (int) base.y, POSITION_DELTA_BITS);
+	}
+
+	writer.writeBool(player.direction != base.direction);
+
+	if (player.direction != base.direction)
+	{
+		writeDelta(writer, directionDelta(player.direction, base.direction), DIRECTION_DELTA_BITS);
+	}
+
+	writer.writeBool(player.life != base.life);
+
+	if (player.life != base.life)
+	{
+		writer.write(player.life, SNAPSHOT_LIFE_BITS);
+	}
+
+	writer.writeBool(player.points != base.points);
+
+	if (player.points != base.points)
+	{
+		writer.write(player.points, SNAPSHOT_POINTS_BITS);
+	}
+
+	writer.writeBool(player.isAlive);
+}
+
+static void readPlayerDelta(BitReader& reader, QuantizedPlayer& player, const QuantizedPlayer& base)
+{
+	player = base;
+
+	if (reader.readBool())
+	{
+		player.x = (unsigned short) (((int) base.x + readDelta(reader, POSITION_DELTA_BITS)) & ((1 << SNAPSHOT_POSITION_BITS) - 1));
+		player.y = (unsigned short) (((int) base.y + readDelta(reader, POSITION_DELTA_BITS)) & ((1 << SNAPSHOT_POSITION_BITS) - 1));
+	}
+
+	if (reader.readBool())
+	{
+		player.direction = (unsigned short) (((int) base.direction + readDelta(reader, DIRECTION_DELTA_BITS)) & ((1 << SNAPSHOT_DIRECTION_BITS) - 1));
+	}
+
+	if (reader.readBool())
+	{
+		player.life = (unsigned char) reader.read(SNAPSHOT_LIFE_BITS);
+	}
+
+	if (reader.readBool())
+	{
+		player.points = (unsigned char) reader.read(SNAPSHOT_POINTS_BITS);
+	}
+
+	player.isAlive = reader.readBool();
+}
+
+
+static unsigned short wrapPosition(int position)
+{
+	return (unsigned short) (position & ((1 << SNAPSHOT_POSITION_BITS) - 1));
+}
+
+static void writeNewBullet(BitWriter& writer, const QuantizedBullet& bullet)
+{
+	writer.write(bullet.x, SNAPSHOT_POSITION_BITS);
+	writer.write(bullet.y, SNAPSHOT_POSITION_BITS);
+	writer.write(bullet.direction, SNAPSHOT_DIRECTION_BITS);
+	writer.write(bullet.owner, SNAPSHOT_OWNER_BITS);
+}
+
+static void readNewBullet(BitReader& reader, QuantizedBullet& bullet)
+{
+	bullet.x = (unsigned short) reader.read(SNAPSHOT_POSITION_BITS);
+	bullet.y = (unsigned short) reader.read(SNAPSHOT_POSITION_BITS);
+	bullet.direction = (unsigned short) reader.read(SNAPSHOT_DIRECTION_BITS);
+	bullet.owner = (unsigned char) reader.read(SNAPSHOT_OWNER_BITS);
+}
+
+// Bullets in the baseline send the error against where they would have flown to since
+static void writeBulletFlight(BitWriter& writer, const QuantizedBullet& bullet, const QuantizedBullet& base, unsigned int ticks)
+{
+	writeDelta(writer, (int) bullet.x - (int) predictBulletX(base, ticks), POSITION_DELTA_BITS);
+	writeDelta(writer, (int) bullet.y - (int) predictBulletY(base, ticks), POSITION_DELTA_BITS);
+}
+
+static void readBulletFlight(BitReader& reader, QuantizedBullet& bullet, const QuantizedBullet& base, unsigned int ticks)
+{
+	bullet = base;
+	bullet.x = wrapPosition(predictBulletX(base, ticks) + readDelta(reader, POSITION_DELTA_BITS));
+	bullet.y = wrapPosition(predictBulletY(base, ticks) + readDelta(reader, POSITION_DELTA_BITS));
+}
+
+static bool isSameBullet(const QuantizedBullet& a, const QuantizedBullet& b)
+{
+	return a.owner == b.owner && a.direction == b.direction;
+}
+
+static unsigned int hashBullet(const QuantizedBullet& bullet)
+{
+	return (bullet.direction * 73856093u) ^ (bullet.owner * 83492791u);
+}
+
+
+// Players are written in full, or when there is a baseline as a changed bit and the changed
+// fields. Bullets are a prefix code then their data:
+//   0  - same bullet as in this slot of the baseline, flight error
+//   10 - the baseline's bullet from another slot (the pool reorders as bullets die), its index and flight error
+//   11 - a bullet the baseline doesn't have
+static bool readSnapshot(BitReader& reader, const StateSnapshot* baseline, StateSnapshot& snapshot)
+{
+	unsigned int ticks = 0;
+
+	if (baseline)
+	{
+		ticks = (unsigned int) readDelta(reader, TICK_DELTA_BITS);
+		snapshot.tick = baseline->tick + ticks;
+	}
+
+	else
+	{
+		snapshot.tick = reader.read(32);
+	}
+
+	unsigned int playerCount = reader.read(PLAYER_COUNT_BITS);
+
+	if (playerCount > SNAPSHOT_MAX_PLAYERS)
+	{
+		return false;
+	}
+
+	snapshot.players.resize(playerCount);
+
+	for (size_t i = 0; i < playerCount && reader.isValid(); i++)
+	{
+		QuantizedPlayer& player = snapshot.players[i];
+
+		if (baseline && i < baseline->players.size())
+		{
+			const QuantizedPlayer& base = baseline->players[i];
+
+			if (reader.readBool())
+			{
+				readPlayerDelta(reader, player, base);
+			}
+
+			else
+			{
+				player = base;
+			}
+		}
+
+		else
+		{
+			readPlayer(reader, player);
+		}
+	}
+
+	snapshot.bullets.resize(reader.read(SNAPSHOT_COUNT_BITS));
+
+	for (size_t i = 0; i < snapshot.bullets.size() && reader.isValid(); i++)
+	{
+		QuantizedBullet& bullet = snapshot.bullets[i];
+
+		if (!baseline)
+		{
+			readNewBullet(reader, bullet);
+		}
+
+		else if (!reader.readBool())
+		{
+			if (i >= baseline->bullets.size())
+			{
+				return false;
+			}
+
+			readBulletFlight(reader, bullet, baseline->bullets[i], ticks);
+		}
+
+		else if (!reader.readBool())
+		{
+			unsigned int index = reader.read(SNAPSHOT_COUNT_BITS);
+
+			if (index >= baseline->bullets.size())
+			{
+				return false;
+			}
+
+			readBulletFlight(reader, bullet, baseline->bullets[index], ticks);
+		}
+
+		else
+		{
+			readNewBullet(reader, bullet);
+		}
+	}
+
+	return reader.isValid();
+}
+
+
+SnapshotEncoder::SnapshotEncoder()
+	: m_History(SNAPSHOT_HISTORY)
+{
+}
+
+void SnapshotEncoder::buildBulletLookup(const StateSnapshot& baseline)
+{
+	size_t size = 16;
+
+	while (size < baseline.bullets.size() * 2)
+	{
+		size *= 2;
+	}
+
+	m_BulletLookup.assign(size, 0);
+
+	for (size_t i = 0; i < baseline.bullets.size(); i++)
+	{
+		size_t slot = hashBullet(baseline.bullets[i]) & (size - 1);
+
+		while (m_BulletLookup[slot] != 0)
+		{
+			slot = (slot + 1) & (size - 1);
+		}
+
+		m_BulletLookup[slot] = (unsigned short) (i + 1);
+	}
+}
+
+int SnapshotEncoder::findBullet(const QuantizedBullet& bullet, const StateSnapshot& baseline) const
+{
+	size_t mask = m_BulletLookup.size() - 1;
+
+	for (size_t slot = hashBullet(bullet) & mask; m_BulletLookup[slot] != 0; slot = (slot + 1) & mask)
+	{
+		unsigned int index = m_BulletLookup[slot] - 1u;
+
+		if (isSameBullet(baseline.bullets[index], bullet))
+		{
+			return (int) index;
+		}
+	}
+
+	return -1;
+}
+
+void SnapshotEncoder::writeSnapshot(const StateSnapshot& snapshot, const StateSnapshot* baseline, BitWriter& writer) const
+{
+	unsigned int ticks = 0;
+
+	if (baseline)
+	{
+		ticks = snapshot.tick - baseline->tick;
+		writeDelta(writer, (int) ticks, TICK_DELTA_BITS);
+	}
+
+	else
+	{
+		writer.write(snapshot.tick, 32);
+	}
+
+	writer.write((unsigned int) snapshot.players.size(), PLAYER_COUNT_BITS);
+
+	for (size_t i = 0; i < snapshot.players.size(); i++)
+	{
+		const QuantizedPlayer& player = snapshot.players[i];
+
+		if (baseline && i < baseline->players.size())
+		{
+			const QuantizedPlayer& base = baseline->players[i];
+
+			writer.writeBool(!(player == base));
+
+			if (!(player == base))
+			{
+				writePlayerDelta(writer, player, base);
+			}
+		}
+
+		else
+		{
+			writePlayer(writer, player);
+		}
+	}
+
+	writer.write((unsigned int) snapshot.bullets.size(), SNAPSHOT_COUNT_BITS);
+
+	for (size_t i = 0; i < snapshot.bullets.size(); i++)
+	{
+		const QuantizedBullet& bullet = snapshot.bullets[i];
+
+		if (!baseline)
+		{
+			writeNewBullet(writer, bullet);
+			continue;
+		}
+
+		// A slot with the same owner and heading almost always holds the same bullet (if it
+		// doesn't, the flight error is just bigger)
+		if (i < baseline->bullets.size() && isSameBullet(bullet, baseline->bullets[i]))
+		{
+			writer.write(0, 1);
+			writeBulletFlight(writer, bullet, baseline->bullets[i], ticks);
+			continue;
+		}
+
+		int index = findBullet(bullet, *baseline);
+
+		if (index >= 0)
+		{
+			writer.write(0x1, 2);
+			writer.write((unsigned int) index, SNAPSHOT_COUNT_BITS);
+			writeBulletFlight(writer, bullet, baseline->bullets[index], ticks);
+		}
+
+		else
+		{
+			writer.write(0x3, 2);
+			writeNewBullet(writer, bullet);
+		}
+	}
+}
+
+unsigned short SnapshotEncoder::encode(const StateSnapshot& snapshot, std::vector<unsigned char>& out)
+{
+	unsigned int sequence = m_NextSequence++;
+	const Entry* baseline = nullptr;
+
+	if (m_HasAck && sequence - m_AckedSequence < SNAPSHOT_HISTORY)
+	{
+		baseline = &m_History[m_AckedSequence % SNAPSHOT_HISTORY];
+	}
+
+	if (baseline && (!m_HasLookup || m_LookupSequence != baseline->sequence))
+	{
+		buildBulletLookup(baseline->snapshot);
+		m_HasLookup = true;
+		m_LookupSequence = baseline->sequence;
+	}
+
+	BitWriter writer(out);
+	writer.write(sequence & 0xFFFF, 16);
+	writer.write(baseline ? sequence - baseline->sequence : 0, SNAPSHOT_BASELINE_BITS);
+	writeSnapshot(snapshot, baseline ? &baseline->snapshot : nullptr, writer);
+	writer.flush();
+
+	// Copying into the old entry reuses its vectors
+	Entry& entry = m_History[sequence % SNAPSHOT_HISTORY];
+	entry.isValid = true;
+	entry.sequence = sequence;
+	entry.snapshot = snapshot;
+
+	return (unsigned short) sequence;
+}
+
+void SnapshotEncoder::acknowledge(unsigned short sequence)
+{
+	// Widens the sequence to the most recent one sent that ends in those 16 bits
+	unsigned int full = (m_NextSequence & ~0xFFFFu) | sequence;
+
+	if (full >= m_NextSequence)
+	{
+		full -= 0x10000;
+	}
+
+	const Entry& entry = m_History[full % SNAPSHOT_HISTORY];
+
+	if (m_NextSequence - full > SNAPSHOT_HISTORY || !entry.isValid || entry.sequence != full)
+	{
+		return;
+	}
+
+	if (!m_HasAck || full - m_AckedSequence < 0x80000000u)
+	{
+		m_HasAck = true;
+		m_AckedSequence = full;
+	}
+}
+
+void SnapshotEncoder::reset()
+{
+	for (Entry& entry : m_History)
+	{
+		entry.isValid = false;
+	}
+
+	m_HasAck = false;
+	m_HasLookup = false;
+}
+
+size_t SnapshotEncoder::getMemoryUsage() const
+{
+	size_t usage = m_History.capacity() * sizeof(Entry) + m_BulletLookup.capacity() * sizeof(unsigned short);
+
+	for (const Entry& entry : m_History)
+	{
+		usage += entry.snapshot.players.capacity() * sizeof(QuantizedPlayer) + entry.snapshot.bullets.capacity() * sizeof(QuantizedBullet);
+	}
+
+	return usage;
+}
+
+
+SnapshotDecoder::SnapshotDecoder()
+	: m_History(SNAPSHOT_HISTORY)
+{
+}
+
+bool SnapshotDecoder::decode(const unsigned char* data, size_t size, StateSnapshot& snapshot)
+{
+	BitReader reader(data, size);
+
+	unsigned short sequence = (unsigned short) reader.read(16);
+	unsigned int distance = reader.read(SNAPSHOT_BASELINE_BITS);
+
+	const StateSnapshot* baseline = nullptr;
+
+	if (distance > 0)
+	{
+		unsigned short baselineSequence = (unsigned short) (sequence - distance);
+		const Entry& entry = m_History[baselineSequence % SNAPSHOT_HISTORY];
+
+		if (!entry.isValid || entry.sequence != baselineSequence)
+		{
+			return false;
+		}
+
+		baseline = &entry.snapshot;
+	}
+
+	if (!reader.isValid() || !readSnapshot(reader, baseline, snapshot))
+	{
+		return false;
+	}
+
+	Entry& entry = m_History[sequence % SNAPSHOT_HISTORY];
+	entry.isValid = true;
+	entry.sequence = sequence;
+	entry.snapshot = snapshot;
+
+	if (!m_HasAck || (short) (sequence - m_Ack) > 0)
+	{
+		m_HasAck = true;
+		m_Ack = sequence;
+	}
+
+	return true;
+}
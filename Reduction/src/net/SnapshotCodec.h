@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "BitStream.h"
+#include "StateSnapshot.h"
+#include "utils/Settings.h"
+
+
+// Bits used for how many states back a message's baseline is (0 for none)
+constexpr unsigned int SNAPSHOT_BASELINE_BITS = 4;
+static_assert(SNAPSHOT_HISTORY == 1 << SNAPSHOT_BASELINE_BITS, "Every state in the history must be reachable as a baseline");
+
+// Most bytes a message from SnapshotEncoder can take, whatever its baseline
+constexpr size_t getMaxSnapshotSize(unsigned int players, unsigned int bullets)
+{
+	// Header (sequence, baseline, widest tick and the counts), then the widest player and bullet deltas
+	return (16 + SNAPSHOT_BASELINE_BITS + 35 + SNAPSHOT_OWNER_BITS + 1 + SNAPSHOT_COUNT_BITS + players * 66 + bullets * 56 + 7) / 8;
+}
+
+// Server side of one connection: numbers each state sent and encodes it against the newest state
+// the client has acknowledged, so a lost message never leaves the client unable to decode.
+// States are bit-packed changes from that baseline: unchanged players cost a bit, and a bullet
+// that was in the baseline costs a few bits of error against where it would have flown to.
+class SnapshotEncoder
+{
+	struct Entry
+	{
+		bool isValid = false;
+		unsigned int sequence = 0;
+		StateSnapshot snapshot;
+	};
+
+private:
+	// States sent, by sequence % SNAPSHOT_HISTORY
+	std::vector<Entry> m_History;
+	unsigned int m_NextSequence = 0;
+
+	bool m_HasAck = false;
+	unsigned int m_AckedSequence = 0;
+
+	// Hash table of the baseline's bullets by owner and velocity (index + 1, 0 for empty), which
+	// finds bullets the pool moved to another slot. Rebuilt when the baseline changes.
+	std::vector<unsigned short> m_BulletLookup;
+	bool m_HasLookup = false;
+	unsigned int m_LookupSequence = 0;
+
+private:
+	void buildBulletLookup(const StateSnapshot& baseline);
+	// Index of a bullet with the same owner and velocity in the baseline (-1 if there isn't one)
+	int findBullet(const QuantizedBullet& bullet, const StateSnapshot& baseline) const;
+
+	void writeSnapshot(const StateSnapshot& snapshot, const StateSnapshot* baseline, BitWriter& writer) const;
+
+public:
+	SnapshotEncoder();
+
+	// Appends a message: 2 byte sequence, baseline distance, then the encoded state, and returns
+	// the sequence (no allocation once the history and out have grown to the largest state)
+	unsigned short encode(const StateSnapshot& snapshot, std::vector<unsigned char>& out);
+	// Takes a sequence the client says it decoded (stale and unknown ones are ignored)
+	void acknowledge(unsigned short sequence);
+	// Forgets every state, for a new client
+	void reset();
+
+	// Bytes allocated on the heap
+	size_t getMemoryUsage() const;
+};
+
+
+// Client side of a connection: keeps the states it decoded as baselines for the next ones
+class SnapshotDecoder
+{
+	struct Entry
+	{
+		bool isValid = false;
+		unsigned short sequence = 0;
+		StateSnapshot snapshot;
+	};
+
+private:
+	std::vector<Entry> m_History;
+
+	bool m_HasAck = false;
+	unsigned short m_Ack = 0;
+
+public:
+	SnapshotDecoder();
+
+	// Decodes one message (false if it is malformed or its baseline was never received)
+	bool decode(const unsigned char* data, size_t size, StateSnapshot& snapshot);
+
+	// Newest sequence decoded, to send back to the encoder
+	bool hasAck() const { return m_HasAck; }
+	unsigned short getAck() const { return m_Ack; }
+};
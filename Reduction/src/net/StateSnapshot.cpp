@@ -0,0 +1,124 @@
+#include "StateSnapshot.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "utils/MathUtils.h"
+
+
+// Velocity of a bullet at every quantized heading
+struct BulletVelocityTable
+{
+	short x[1 << SNAPSHOT_DIRECTION_BITS];
+	short y[1 << SNAPSHOT_DIRECTION_BITS];
+
+	BulletVelocityTable()
+	{
+		double scale = BULLET_SPEED * SNAPSHOT_POSITION_SCALE * SNAPSHOT_VELOCITY_SCALE / SERVER_TICK_RATE;
+
+		for (unsigned int direction = 0; direction < (1u << SNAPSHOT_DIRECTION_BITS); direction++)
+		{
+			double radians = toRadians(dequantizeDirection((unsigned short) direction));
+
+			x[direction] = (short) std::lround(std::cos(radians) * scale);
+			y[direction] = (short) std::lround(std::sin(radians) * scale);
+		}
+	}
+};
+
+static const BulletVelocityTable& getBulletVelocityTable()
+{
+	static const BulletVelocityTable table;
+
+	return table;
+}
+
+
+// Rounds and clamps a value into an unsigned field of bits bits
+static unsigned int quantize(double value, unsigned int bits)
+{
+	return (unsigned int) std::min(std::max(std::lround(value), 0l), (long) ((1u << bits) - 1));
+}
+
+unsigned short quantizePosition(double position)
+{
+	return (unsigned short) quantize((position + SNAPSHOT_POSITION_MARGIN) * SNAPSHOT_POSITION_SCALE, SNAPSHOT_POSITION_BITS);
+}
+
+double dequantizePosition(unsigned short position)
+{
+	return (double) position / SNAPSHOT_POSITION_SCALE - SNAPSHOT_POSITION_MARGIN;
+}
+
+unsigned short quantizeDirection(double degrees)
+{
+	double turns = degrees / 360.0;
+	turns -= std::floor(turns);
+
+	// A full turn wraps back to 0
+	return (unsigned short) (std::lround(turns * (1 << SNAPSHOT_DIRECTION_BITS)) & ((1 << SNAPSHOT_DIRECTION_BITS) - 1));
+}
+
+double dequantizeDirection(unsigned short direction)
+{
+	return direction * 360.0 / (1 << SNAPSHOT_DIRECTION_BITS);
+}
+
+unsigned char quantizeLife(int life)
+{
+	return (unsigned char) quantize((double) life / SNAPSHOT_LIFE_STEP, SNAPSHOT_LIFE_BITS);
+}
+
+short getBulletVelocityX(unsigned short direction)
+{
+	return getBulletVelocityTable().x[direction & ((1 << SNAPSHOT_DIRECTION_BITS) - 1)];
+}
+
+short getBulletVelocityY(unsigned short direction)
+{
+	return getBulletVelocityTable().y[direction & ((1 << SNAPSHOT_DIRECTION_BITS) - 1)];
+}
+
+
+QuantizedPlayer quantizePlayer(const Player& player)
+{
+	QuantizedPlayer quantized;
+	quantized.x = quantizePosition(player.getPosX());
+	quantized.y = quantizePosition(player.getPosY());
+	quantized.direction = quantizeDirection(player.getDirection());
+	quantized.life = quantizeLife(player.getLifeLeft());
+	quantized.points = (unsigned char) std::min(player.getPoints(), (1u << SNAPSHOT_POINTS_BITS) - 1);
+	quantized.isAlive = player.isAlive();
+
+	return quantized;
+}
+
+void quantizeBullets(const BulletPool& bullets, std::vector<QuantizedBullet>& out)
+{
+	unsigned int count = std::min(bullets.size(), SNAPSHOT_MAX_BULLETS);
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		QuantizedBullet bullet;
+		bullet.x = quantizePosition(bullets.getPosX(i));
+		bullet.y = quantizePosition(bullets.getPosY(i));
+		bullet.direction = quantizeDirection(toDegrees(std::atan2(bullets.getVelY(i), bullets.getVelX(i))));
+		bullet.owner = (unsigned char) bullets.getOwner(i);
+
+		out.push_back(bullet);
+	}
+}
+
+void quantizeSimulation(const Simulation& simulation, StateSnapshot& snapshot)
+{
+	snapshot.tick = (unsigned int) simulation.getClock().getTick();
+	snapshot.players.clear();
+	snapshot.bullets.clear();
+
+	for (const Player* player : simulation.getPlayers())
+	{
+		snapshot.players.push_back(quantizePlayer(*player));
+	}
+
+	quantizeBullets(simulation.getBullets(), snapshot.bullets);
+}
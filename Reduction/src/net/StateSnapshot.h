@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+
+#include "entities/BulletPool.h"
+#include "sim/Simulation.h"
+
+
+// Fixed-point precision of the state sent to clients. Positions are quarter pixels, offset by
+// a margin so bullets just off screen still fit. Bullets all fly at BULLET_SPEED, so only their
+// heading is sent, and their velocities (sixteenths of a position unit per server tick) are
+// looked up from it.
+constexpr int SNAPSHOT_POSITION_SCALE = 4;
+constexpr int SNAPSHOT_POSITION_MARGIN = 32;
+constexpr unsigned int SNAPSHOT_POSITION_BITS = 12;
+constexpr unsigned int SNAPSHOT_DIRECTION_BITS = 10;
+constexpr int SNAPSHOT_LIFE_STEP = 100;
+constexpr unsigned int SNAPSHOT_LIFE_BITS = 7;
+constexpr unsigned int SNAPSHOT_POINTS_BITS = 8;
+constexpr int SNAPSHOT_VELOCITY_SCALE = 16;
+constexpr unsigned int SNAPSHOT_OWNER_BITS = 6;
+
+// Most players and bullets a snapshot can hold
+constexpr unsigned int SNAPSHOT_MAX_PLAYERS = 1 << SNAPSHOT_OWNER_BITS;
+constexpr unsigned int SNAPSHOT_COUNT_BITS = 11;
+constexpr unsigned int SNAPSHOT_MAX_BULLETS = (1 << SNAPSHOT_COUNT_BITS) - 1;
+
+
+struct QuantizedPlayer
+{
+	unsigned short x = 0;
+	unsigned short y = 0;
+	unsigned short direction = 0;
+	unsigned char life = 0;
+	unsigned char points = 0;
+	bool isAlive = false;
+
+	bool operator==(const QuantizedPlayer& other) const
+	{
+		return x == other.x && y == other.y && direction == other.direction && life == other.life && points == other.points && isAlive == other.isAlive;
+	}
+};
+
+struct QuantizedBullet
+{
+	unsigned short x = 0;
+	unsigned short y = 0;
+	unsigned short direction = 0;
+	unsigned char owner = 0;
+
+	bool operator==(const QuantizedBullet& other) const
+	{
+		return x == other.x && y == other.y && direction == other.direction && owner == other.owner;
+	}
+};
+
+
+// Everything a client draws, at the precision it is sent with. Bullets keep their pool order,
+// so a slot usually holds the same bullet from one snapshot to the next.
+struct StateSnapshot
+{
+	unsigned int tick = 0;
+	std::vector<QuantizedPlayer> players;
+	std::vector<QuantizedBullet> bullets;
+
+	bool operator==(const StateSnapshot& other) const { return tick == other.tick && players == other.players && bullets == other.bullets; }
+	bool operator!=(const StateSnapshot& other) const { return !(*this == other); }
+};
+
+
+// Fixed-point conversions (quantized values clamp to the range of their field)
+unsigned short quantizePosition(double position);
+double dequantizePosition(unsigned short position);
+unsigned short quantizeDirection(double degrees);
+double dequantizeDirection(unsigned short direction);
+unsigned char quantizeLife(int life);
+
+// Velocity of a bullet along each axis from its quantized heading (from a table, so the encoder
+// and decoder always agree)
+short getBulletVelocityX(unsigned short direction);
+short getBulletVelocityY(unsigned short direction);
+
+// Quantizes a player, and appends every bullet in a pool
+QuantizedPlayer quantizePlayer(const Player& player);
+void quantizeBullets(const BulletPool& bullets, std::vector<QuantizedBullet>& out);
+
+// Fills a snapshot from the simulation (reusing its vectors, so no allocation once they have grown)
+void quantizeSimulation(const Simulation& simulation, StateSnapshot& snapshot);
+
+// Where a bullet is expected to be ticks after it was at its quantized position (integer maths
+// only, so the encoder and decoder always agree)
+inline unsigned short predictBulletPosition(unsigned short position, short velocity, unsigned int ticks)
+{
+	// Rounds to the nearest position unit, flooring so both directions round alike
+	long long moved = (long long) velocity * ticks + SNAPSHOT_VELOCITY_SCALE / 2;
+	long long offset = moved >= 0 ? moved / SNAPSHOT_VELOCITY_SCALE : -((-moved + SNAPSHOT_VELOCITY_SCALE - 1) / SNAPSHOT_VELOCITY_SCALE);
+	long long predicted = position + offset;
+
+	return (unsigned short) (predicted < 0 ? 0 : (predicted > (1 << SNAPSHOT_POSITION_BITS) - 1 ? (1 << SNAPSHOT_POSITION_BITS) - 1 : predicted));
+}
+
+inline unsigned short predictBulletX(const QuantizedBullet& bullet, unsigned int ticks) { return predictBulletPosition(bullet.x, getBulletVelocityX(bullet.direction), ticks); }
+inline unsigned short predictBulletY(const QuantizedBullet& bullet, unsigned int ticks) { return predictBulletPosition(bullet.y, getBulletVelocityY(bullet.direction), ticks); }
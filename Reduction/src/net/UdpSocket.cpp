@@ -0,0 +1,212 @@
+#include "UdpSocket.h"
+
+#include <cstdlib>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#include <mstcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "utils/Log.h"
+
+
+bool NetAddress::parse(const std::string& text, NetAddress& address)
+{
+	size_t colon = text.rfind(':');
+	std::string host = colon == std::string::npos ? "127.0.0.1" : text.substr(0, colon);
+	std::string port = colon == std::string::npos ? text : text.substr(colon + 1);
+
+	char* end = nullptr;
+	long portNumber = std::strtol(port.c_str(), &end, 10);
+
+	if (port.empty() || *end != '\0' || portNumber <= 0 || portNumber > 65535)
+	{
+		return false;
+	}
+
+	in_addr ip;
+
+	if (inet_pton(AF_INET, host.c_str(), &ip) != 1)
+	{
+		return false;
+	}
+
+	address.ip = ntohl(ip.s_addr);
+	address.port = (unsigned short) portNumber;
+
+	return true;
+}
+
+
+#ifdef _WIN32
+
+using NativeSocket = SOCKET;
+
+// Winsock needs starting once per process before any socket is made
+static bool startSockets()
+{
+	static bool started = false;
+
+	if (!started)
+	{
+		WSADATA data;
+		started = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+	}
+
+	return started;
+}
+
+static void setNonBlocking(std::intptr_t socket)
+{
+	u_long nonBlocking = 1;
+	ioctlsocket((NativeSocket) socket, FIONBIO, &nonBlocking);
+
+	// Stops a packet sent to a peer that isn't listening yet failing the next receive
+	BOOL reportReset = FALSE;
+	DWORD bytesReturned = 0;
+	WSAIoctl((NativeSocket) socket, SIO_UDP_CONNRESET, &reportReset, sizeof(reportReset), nullptr, 0, &bytesReturned, nullptr, nullptr);
+}
+
+static void closeSocket(std::intptr_t socket)
+{
+	closesocket((NativeSocket) socket);
+}
+
+#else
+
+using NativeSocket = int;
+
+static bool startSockets()
+{
+	return true;
+}
+
+static void setNonBlocking(std::intptr_t socket)
+{
+	fcntl((NativeSocket) socket, F_SETFL, fcntl((NativeSocket) socket, F_GETFL, 0) | O_NONBLOCK);
+}
+
+static void closeSocket(std::intptr_t socket)
+{
+	::close((NativeSocket) socket);
+}
+
+#endif
+
+
+UdpSocket::~UdpSocket()
+{
+	close();
+}
+
+bool UdpSocket::open(unsigned short port)
+{
+	close();
+
+	if (!startSockets())
+	{
+		error("Could not start Winsock.");
+		return false;
+	}
+
+	m_Socket = (std::intptr_t) socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+	if (m_Socket == -1)
+	{
+		error("Could not create a UDP socket.");
+		return false;
+	}
+
+	setNonBlocking(m_Socket);
+
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(port);
+
+	if (bind((NativeSocket) m_Socket, (const sockaddr*) &address, sizeof(address)) != 0)
+	{
+		error("Could not bind UDP port ", port, ".");
+		close();
+
+		return false;
+	}
+
+	return true;
+}
+
+void UdpSocket::close()
+{
+	if (m_Socket != -1)
+	{
+		closeSocket(m_Socket);
+		m_Socket = -1;
+	}
+}
+
+
+bool UdpSocket::send(const NetAddress& address, const void* data, size_t size)
+{
+	if (m_Socket == -1)
+	{
+		return false;
+	}
+
+	sockaddr_in to = {};
+	to.sin_family = AF_INET;
+	to.sin_addr.s_addr = htonl(address.ip);
+	to.sin_port = htons(address.port);
+
+	return sendto((NativeSocket) m_Socket, (const char*) data, (int) size, 0, (const sockaddr*) &to, sizeof(to)) == (int) size;
+}
+
+int UdpSocket::receive(void* buffer, size_t capacity, NetAddress& from)
+{
+	if (m_Socket == -1)
+	{
+		return -1;
+	}
+
+	sockaddr_in address = {};
+	socklen_t addressSize = sizeof(address);
+
+	int received = (int) recvfrom((NativeSocket) m_Socket, (char*) buffer, (int) capacity, 0, (sockaddr*) &address, &addressSize);
+
+	if (received < 0)
+	{
+		return -1;
+	}
+
+	from.ip = ntohl(address.sin_addr.s_addr);
+	from.port = ntohs(address.sin_port);
+
+	return received;
+}
+
+unsigned short UdpSocket::getPort() const
+{
+	if (m_Socket == -1)
+	{
+		return 0;
+	}
+
+	sockaddr_in address = {};
+	socklen_t addressSize = sizeof(address);
+
+	if (getsockname((NativeSocket) m_Socket, (sockaddr*) &address, &addressSize) != 0)
+	{
+		return 0;
+	}
+
+	return ntohs(address.sin_port);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+// IPv4 address and port, both in host byte order
+struct NetAddress
+{
+	unsigned int ip = 0;
+	unsigned short port = 0;
+
+	bool operator==(const NetAddress& other) const { return ip == other.ip && port == other.port; }
+	bool operator!=(const NetAddress& other) const { return !(*this == other); }
+
+	// Reads "a.b.c.d:port", or just "port" for localhost (false if it isn't either)
+	static bool parse(const std::string& text, NetAddress& address);
+	static NetAddress localhost(unsigned short port) { return NetAddress { 0x7F000001, port }; }
+};
+
+
+// Non-blocking UDP socket
+class UdpSocket
+{
+private:
+	// Big enough for a Windows SOCKET, whose invalid value is also -1
+	std::intptr_t m_Socket = -1;
+
+public:
+	UdpSocket() = default;
+	~UdpSocket();
+
+	UdpSocket(const UdpSocket&) = delete;
+	UdpSocket& operator=(const UdpSocket&) = delete;
+
+	// Binds to a port on every interface (false if the port is taken or sockets are unavailable)
+	bool open(unsigned short port);
+	void close();
+
+	// Sends one datagram (false if it couldn't be queued, UDP gives no delivery guarantee either way)
+	bool send(const NetAddress& address, const void* data, size_t size);
+	// Receives one datagram if any has arrived, returns its size (-1 if there was nothing to read)
+	int receive(void* buffer, size_t capacity, NetAddress& from);
+
+	// Port the socket is bound to (the one picked for it when opened on port 0)
+	unsigned short getPort() const;
+
+	bool isOpen() const { return m_Socket != -1; }
+};
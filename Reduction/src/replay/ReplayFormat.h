@@ -0,0 +1,110 @@
+#pragma once
+
+#include <vector>
+
+#include "sim/PlayerInput.h"
+
+
+// Replay files are laid out as:
+//   header:  "RDRP", version byte, varint seed, varint tick rate, varint points to win, player count byte
+//   rounds:  ROUND tag, powerup flags byte per player, varint tick count, varint stream length,
+//            tick stream, 4 byte little endian checksum of the world when the round ended
+//   end:     END tag
+//   keyframes: one blob per keyframe, see below
+//   index:   4 byte keyframe interval, 4 byte round count, 8 byte file offset of each ROUND tag,
+//            4 byte keyframe count, then per keyframe: 8 byte replay tick, 4 byte round index,
+//            4 byte tick within the round, 8 byte file offset and 4 byte size of its blob
+//   trailer: 8 byte file offset of the index, then "RDIX" (the last 12 bytes of the file)
+// Fixed width fields after the end tag are little endian, and keyframe N is at replay tick
+// N * interval (replay ticks count every round's ticks in order), so seeking needs no search.
+//
+// Version 3 is the current layout. Its bytes are the same as version 2 (which added the keyframes
+// and index), but bullet spread is drawn from the Philox stream, so the same inputs no longer play
+// out the same under an older version's generator and older files are refused.
+//
+// A tick stream is alternating runs and changes, starting and ending with a run:
+//   run:     varint number of ticks with the same inputs as the tick before
+//   change:  varint bitmask of players whose input changed, then for each of them an input
+//            flags byte and, if they aim, zigzag varint deltas of the aim position
+// Every player's input starts each round as a default PlayerInput.
+//
+// A keyframe blob is taken before its tick is played and holds where the tick stream reader was:
+//   4 byte offset into the round's tick stream of the run being read, 8 byte ticks of that run
+//   already played, then per player the input flags byte and 4 byte aim x and y, then the
+//   simulation snapshot from Simulation::saveState (only valid for the build that wrote it).
+
+constexpr unsigned char REPLAY_MAGIC[4] = { 'R', 'D', 'R', 'P' };
+constexpr unsigned char REPLAY_VERSION = 3;
+// Oldest version that can still be played
+constexpr unsigned char REPLAY_MIN_VERSION = 3;
+constexpr unsigned char REPLAY_INDEX_MAGIC[4] = { 'R', 'D', 'I', 'X' };
+
+constexpr unsigned char REPLAY_END_TAG = 0;
+constexpr unsigned char REPLAY_ROUND_TAG = 1;
+
+// Most player slots a tick stream's change mask can hold
+constexpr unsigned int REPLAY_MAX_PLAYERS = 64;
+
+// Bits of a powerup flags byte
+constexpr unsigned char POWERUP_SPEED = 1 << 0;
+constexpr unsigned char POWERUP_ACCURACY = 1 << 1;
+constexpr unsigned char POWERUP_DAMAGE = 1 << 2;
+constexpr unsigned char POWERUP_COOLDOWN = 1 << 3;
+
+// Bits of an input flags byte (rotation and thrust are stored plus one)
+constexpr unsigned char INPUT_ROTATION_MASK = 0x03;
+constexpr unsigned char INPUT_THRUST_SHIFT = 2;
+constexpr unsigned char INPUT_THRUST_MASK = 0x03 << INPUT_THRUST_SHIFT;
+constexpr unsigned char INPUT_SHOOT = 1 << 4;
+constexpr unsigned char INPUT_AIM = 1 << 5;
+
+
+// Packs the parts of an input the simulation reads, other than the aim position, into a flags byte
+inline unsigned char packInputFlags(const PlayerInput& input)
+{
+	unsigned char rotation = (unsigned char) ((input.rotation > 0) - (input.rotation < 0) + 1);
+	unsigned char thrust = (unsigned char) ((input.thrust > 0) - (input.thrust < 0) + 1);
+
+	unsigned char flags = rotation | (unsigned char) (thrust << INPUT_THRUST_SHIFT);
+	flags |= input.shoot ? INPUT_SHOOT : 0;
+	flags |= input.hasAimTarget ? INPUT_AIM : 0;
+
+	return flags;
+}
+
+// Sets everything but the aim position from a flags byte
+inline void unpackInputFlags(unsigned char flags, PlayerInput& input)
+{
+	input.rotation = (flags & INPUT_ROTATION_MASK) - 1;
+	input.thrust = ((flags & INPUT_THRUST_MASK) >> INPUT_THRUST_SHIFT) - 1;
+	input.shoot = (flags & INPUT_SHOOT) != 0;
+	input.hasAimTarget = (flags & INPUT_AIM) != 0;
+}
+
+
+// Everything needed to set a match up before its first tick
+struct ReplayHeader
+{
+	unsigned int seed = 0;
+	unsigned int tickRate = 0;
+	unsigned int pointsToWin = 0;
+	unsigned int playerCount = 0;
+};
+
+// How a round starts and how long it lasts
+struct ReplayRound
+{
+	std::vector<unsigned char> powerups;
+	unsigned int tickCount = 0;
+	unsigned int checksum = 0;
+};
+
+// Where a keyframe is in the replay, and where its blob is in the file
+struct ReplayKeyframe
+{
+	unsigned long long tick = 0;
+	unsigned int round = 0;
+	unsigned int roundTick = 0;
+	unsigned long long offset = 0;
+	unsigned int size = 0;
+};
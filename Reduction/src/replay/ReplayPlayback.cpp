@@ -0,0 +1,149 @@
+#include "ReplayPlayback.h"
+
+#include "utils/Log.h"
+
+
+ReplayPlayback::ReplayPlayback(Simulation& simulation)
+	: m_Simulation(simulation)
+{
+}
+
+
+bool ReplayPlayback::open(const std::string& path)
+{
+	if (!m_Reader.open(path))
+	{
+		return false;
+	}
+
+	const ReplayHeader& header = m_Reader.getHeader();
+
+	if (header.tickRate != m_Simulation.getClock().getTickRate())
+	{
+		error("Replay was recorded at ", header.tickRate, " ticks per second, the simulation runs at ", m_Simulation.getClock().getTickRate(), ".");
+		return false;
+	}
+
+	// Same starting point as when the match was recorded
+	m_Simulation.seed(header.seed);
+	m_Simulation.initPlayers(header.playerCount);
+
+	m_InRound = false;
+	m_Finished = false;
+	m_RoundsPlayed = 0;
+	m_TicksPlayed = 0;
+	m_Desyncs = 0;
+
+	return true;
+}
+
+
+void ReplayPlayback::startRound()
+{
+	// Game resets players between rounds, but not before the first
+	if (m_RoundsPlayed > 0)
+	{
+		m_Simulation.resetPlayers();
+	}
+
+	std::vector<Player*>& players = m_Simulation.getPlayers();
+
+	for (unsigned int i = 0; i < players.size() && i < m_Round.powerups.size(); i++)
+	{
+		unsigned char powerups = m_Round.powerups[i];
+		players[i]->setPowerups((powerups & POWERUP_SPEED) != 0, (powerups & POWERUP_ACCURACY) != 0, (powerups & POWERUP_DAMAGE) != 0, (powerups & POWERUP_COOLDOWN) != 0);
+	}
+
+	m_Simulation.resetWall();
+	m_InRound = true;
+}
+
+void ReplayPlayback::endRound()
+{
+	unsigned int checksum = m_Simulation.getChecksum();
+
+	if (checksum != m_Round.checksum)
+	{
+		warn("Replay desynced in round ", m_RoundsPlayed + 1, " (checksum ", checksum, ", recorded ", m_Round.checksum, ").");
+		m_Desyncs += 1;
+	}
+
+	m_Simulation.awardRound();
+
+	m_RoundsPlayed += 1;
+	m_InRound = false;
+}
+
+
+bool ReplayPlayback::step()
+{
+	while (!m_Finished)
+	{
+		if (!m_InRound)
+		{
+			if (!m_Reader.nextRound(m_Round))
+			{
+				m_Finished = true;
+				break;
+			}
+
+			startRound();
+		}
+
+		const std::vector<PlayerInput>* inputs = m_Reader.nextTick();
+
+		if (inputs)
+		{
+			m_Simulation.step(*inputs);
+			m_TicksPlayed += 1;
+
+			return true;
+		}
+
+		endRound();
+	}
+
+	return false;
+}
+
+bool ReplayPlayback::seek(unsigned long long tick)
+{
+	const std::vector<ReplayKeyframe>& keyframes = m_Reader.getKeyframes();
+
+	if (keyframes.empty())
+	{
+		return false;
+	}
+
+	// Keyframes are evenly spaced, so the one to start from is found without searching
+	unsigned long long index = tick / m_Reader.getKeyframeInterval();
+
+	if (index >= keyframes.size())
+	{
+		index = keyframes.size() - 1;
+	}
+
+	const ReplayKeyframe& keyframe = keyframes[(size_t) index];
+	const unsigned char* snapshot;
+	size_t snapshotSize;
+
+	if (!m_Reader.seekKeyframe((unsigned int) index, m_Round, snapshot, snapshotSize) || !m_Simulation.loadState(snapshot, snapshotSize))
+	{
+		error("Replay keyframe ", index, " is damaged, cannot seek.");
+
+		m_Finished = true;
+		return false;
+	}
+
+	m_InRound = true;
+	m_Finished = false;
+	m_RoundsPlayed = keyframe.round;
+	m_TicksPlayed = keyframe.tick;
+
+	// Fewer than an interval's worth of ticks are left to play
+	while (m_TicksPlayed < tick && step())
+	{
+	}
+
+	return true;
+}
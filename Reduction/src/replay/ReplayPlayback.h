@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "ReplayReader.h"
+#include "sim/Simulation.h"
+
+
+// Feeds a replay into a simulation one tick at a time, setting up rounds the way Game does
+class ReplayPlayback
+{
+private:
+	ReplayReader m_Reader;
+	Simulation& m_Simulation;
+
+	ReplayRound m_Round;
+	bool m_InRound = false;
+	bool m_Finished = false;
+
+	unsigned int m_RoundsPlayed = 0;
+	unsigned long long m_TicksPlayed = 0;
+	// Rounds whose end state didn't match the recording
+	unsigned int m_Desyncs = 0;
+
+private:
+	// Resets the players and wall and applies the round's powerups
+	void startRound();
+	// Checks the round ended the same as when recorded, and scores it
+	void endRound();
+
+public:
+	explicit ReplayPlayback(Simulation& simulation);
+
+	// Loads a replay and sets the simulation up for its first round (false on failure)
+	bool open(const std::string& path);
+
+	// Plays one tick, moving through rounds as needed (false once the replay is over)
+	bool step();
+	// Jumps to a replay tick by restoring the keyframe before it and playing the rest
+	// (false if the replay has no keyframes or the keyframe is damaged)
+	bool seek(unsigned long long tick);
+
+	const ReplayHeader& getHeader() const { return m_Reader.getHeader(); }
+	bool isFinished() const { return m_Finished; }
+	bool canSeek() const { return !m_Reader.getKeyframes().empty(); }
+	unsigned int getRoundsPlayed() const { return m_RoundsPlayed; }
+	unsigned long long getTicksPlayed() const { return m_TicksPlayed; }
+	unsigned int getDesyncs() const { return m_Desyncs; }
+};
@@ -0,0 +1,358 @@
+#include "ReplayReader.h"
+
+#include <cstring>
+
+#include "utils/ByteIO.h"
+#include "utils/Varint.h"
+#include "utils/Log.h"
+
+
+bool ReplayReader::open(const std::string& path)
+{
+	m_Data = nullptr;
+	m_Size = 0;
+	m_Offset = 0;
+	m_KeyframeInterval = 0;
+	m_RoundOffsets.clear();
+	m_Keyframes.clear();
+
+	if (!m_File.open(path))
+	{
+		error("Could not open replay file (filepath: ", path, ").");
+		return false;
+	}
+
+	m_Data = m_File.getData();
+	m_Size = m_File.getSize();
+
+	if (m_Size < 6 || std::memcmp(m_Data, REPLAY_MAGIC, 4) != 0)
+	{
+		error("Not a replay file (filepath: ", path, ").");
+		return false;
+	}
+
+	unsigned int version = m_Data[4];
+
+	if (version < REPLAY_MIN_VERSION || version > REPLAY_VERSION)
+	{
+		error("Replay file is version ", version, ", expected ", (unsigned int) REPLAY_MIN_VERSION, " to ", (unsigned int) REPLAY_VERSION, " (filepath: ", path, ").");
+		return false;
+	}
+
+	m_Offset = 5;
+
+	unsigned long long seed;
+	unsigned long long tickRate;
+	unsigned long long pointsToWin;
+
+	if (!readVarint(m_Data, m_Size, m_Offset, seed) ||
+		!readVarint(m_Data, m_Size, m_Offset, tickRate) ||
+		!readVarint(m_Data, m_Size, m_Offset, pointsToWin) ||
+		m_Offset >= m_Size)
+	{
+		error("Replay header is truncated (filepath: ", path, ").");
+		return false;
+	}
+
+	m_Header.seed = (unsigned int) seed;
+	m_Header.tickRate = (unsigned int) tickRate;
+	m_Header.pointsToWin = (unsigned int) pointsToWin;
+	m_Header.playerCount = m_Data[m_Offset++];
+
+	if (m_Header.playerCount == 0 || m_Header.playerCount > REPLAY_MAX_PLAYERS || m_Header.tickRate == 0)
+	{
+		error("Replay header is invalid (filepath: ", path, ").");
+		return false;
+	}
+
+	// A damaged index only loses seeking, the rounds can still be played
+	if (!readIndex())
+	{
+		warn("Replay keyframe index is damaged, seeking is disabled (filepath: ", path, ").");
+
+		m_KeyframeInterval = 0;
+		m_RoundOffsets.clear();
+		m_Keyframes.clear();
+	}
+
+	m_RoundTicks = 0;
+	m_TicksRead = 0;
+
+	return true;
+}
+
+bool ReplayReader::readIndex()
+{
+	if (m_Size < 12 || std::memcmp(m_Data + m_Size - 4, REPLAY_INDEX_MAGIC, 4) != 0)
+	{
+		return false;
+	}
+
+	size_t offset = m_Size - 12;
+	unsigned long long indexOffset;
+	unsigned int roundCount;
+
+	if (!readFixed(m_Data, m_Size, offset, indexOffset) || indexOffset >= m_Size - 12)
+	{
+		return false;
+	}
+
+	offset = (size_t) indexOffset;
+
+	if (!readFixed(m_Data, m_Size, offset, m_KeyframeInterval) || !readFixed(m_Data, m_Size, offset, roundCount) || m_KeyframeInterval == 0)
+	{
+		return false;
+	}
+
+	for (unsigned int i = 0; i < roundCount; i++)
+	{
+		unsigned long long roundOffset;
+
+		if (!readFixed(m_Data, m_Size, offset, roundOffset) || roundOffset >= m_Size)
+		{
+			return false;
+		}
+
+		m_RoundOffsets.push_back(roundOffset);
+	}
+
+	unsigned int keyframeCount;
+
+	if (!readFixed(m_Data, m_Size, offset, keyframeCount))
+	{
+		return false;
+	}
+
+	for (unsigned int i = 0; i < keyframeCount; i++)
+	{
+		ReplayKeyframe keyframe;
+
+		if (!readFixed(m_Data, m_Size, offset, keyframe.tick) || !readFixed(m_Data, m_Size, offset, keyframe.round) ||
+			!readFixed(m_Data, m_Size, offset, keyframe.roundTick) || !readFixed(m_Data, m_Size, offset, keyframe.offset) ||
+			!readFixed(m_Data, m_Size, offset, keyframe.size))
+		{
+			return false;
+		}
+
+		// Lookups go straight to tick / interval, so every keyframe must be where it is expected
+		if (keyframe.tick != (unsigned long long) i * m_KeyframeInterval || keyframe.round >= roundCount ||
+			keyframe.offset > m_Size || keyframe.size > m_Size - keyframe.offset)
+		{
+			return false;
+		}
+
+		m_Keyframes.push_back(keyframe);
+	}
+
+	return true;
+}
+
+
+bool ReplayReader::nextRound(ReplayRound& round)
+{
+	if (m_Offset >= m_Size || m_Data[m_Offset] != REPLAY_ROUND_TAG)
+	{
+		return false;
+	}
+
+	m_Offset += 1;
+
+	if (m_Offset + m_Header.playerCount > m_Size)
+	{
+		error("Replay round is truncated.");
+		return false;
+	}
+
+	round.powerups.assign(m_Data + m_Offset, m_Data + m_Offset + m_Header.playerCount);
+	m_Offset += m_Header.playerCount;
+
+	unsigned long long tickCount;
+	unsigned long long streamLength;
+
+	if (!readVarint(m_Data, m_Size, m_Offset, tickCount) ||
+		!readVarint(m_Data, m_Size, m_Offset, streamLength) ||
+		m_Offset + streamLength + 4 > m_Size)
+	{
+		error("Replay round is truncated.");
+		return false;
+	}
+
+	round.tickCount = (unsigned int) tickCount;
+
+	m_StreamStart = m_Offset;
+	m_StreamOffset = m_Offset;
+	m_StreamEnd = m_Offset + (size_t) streamLength;
+
+	round.checksum = 0;
+
+	for (unsigned int byte = 0; byte < 4; byte++)
+	{
+		round.checksum |= (unsigned int) m_Data[m_StreamEnd + byte] << (byte * 8);
+	}
+
+	// The next round starts after the checksum, however much of this one is read
+	m_Offset = m_StreamEnd + 4;
+
+	m_RoundTicks = round.tickCount;
+	m_TicksRead = 0;
+	m_UnchangedTicksLeft = 0;
+	m_ExpectingRun = true;
+	m_Inputs.assign(m_Header.playerCount, PlayerInput {});
+
+	return true;
+}
+
+bool ReplayReader::readChange()
+{
+	unsigned long long changedMask;
+
+	if (!readVarint(m_Data, m_StreamEnd, m_StreamOffset, changedMask))
+	{
+		return false;
+	}
+
+	for (unsigned int i = 0; i < m_Header.playerCount; i++)
+	{
+		if ((changedMask & (1ull << i)) == 0)
+		{
+			continue;
+		}
+
+		if (m_StreamOffset >= m_StreamEnd)
+		{
+			return false;
+		}
+
+		PlayerInput& input = m_Inputs[i];
+		unsigned char flags = m_Data[m_StreamOffset++];
+
+		unpackInputFlags(flags, input);
+
+		if (input.hasAimTarget)
+		{
+			unsigned long long deltaX;
+			unsigned long long deltaY;
+
+			if (!readVarint(m_Data, m_StreamEnd, m_StreamOffset, deltaX) ||
+				!readVarint(m_Data, m_StreamEnd, m_StreamOffset, deltaY))
+			{
+				return false;
+			}
+
+			input.aimX += (int) zigzagDecode(deltaX);
+			input.aimY += (int) zigzagDecode(deltaY);
+		}
+	}
+
+	return true;
+}
+
+const std::vector<PlayerInput>* ReplayReader::nextTick()
+{
+	while (m_TicksRead < m_RoundTicks)
+	{
+		if (m_UnchangedTicksLeft > 0)
+		{
+			m_UnchangedTicksLeft -= 1;
+			m_TicksRead += 1;
+
+			return &m_Inputs;
+		}
+
+		if (m_ExpectingRun)
+		{
+			if (!readVarint(m_Data, m_StreamEnd, m_StreamOffset, m_UnchangedTicksLeft))
+			{
+				error("Replay tick stream is truncated.");
+				return nullptr;
+			}
+
+			m_ExpectingRun = false;
+			continue;
+		}
+
+		if (!readChange())
+		{
+			error("Replay tick stream is truncated.");
+			return nullptr;
+		}
+
+		m_ExpectingRun = true;
+		m_TicksRead += 1;
+
+		return &m_Inputs;
+	}
+
+	return nullptr;
+}
+
+bool ReplayReader::seekKeyframe(unsigned int index, ReplayRound& round, const unsigned char*& snapshot, size_t& snapshotSize)
+{
+	if (index >= m_Keyframes.size())
+	{
+		return false;
+	}
+
+	const ReplayKeyframe& keyframe = m_Keyframes[index];
+
+	m_Offset = (size_t) m_RoundOffsets[keyframe.round];
+
+	if (!nextRound(round) || keyframe.roundTick >= m_RoundTicks)
+	{
+		return false;
+	}
+
+	const unsigned char* data = m_Data + keyframe.offset;
+	size_t size = keyframe.size;
+	size_t offset = 0;
+
+	unsigned int streamOffset;
+	unsigned long long runTicksPlayed;
+
+	if (!readFixed(data, size, offset, streamOffset) || !readFixed(data, size, offset, runTicksPlayed) ||
+		streamOffset > m_StreamEnd - m_StreamStart)
+	{
+		return false;
+	}
+
+	for (PlayerInput& input : m_Inputs)
+	{
+		unsigned int aimX;
+		unsigned int aimY;
+
+		if (offset >= size)
+		{
+			return false;
+		}
+
+		unsigned char flags = data[offset++];
+
+		if (!readFixed(data, size, offset, aimX) || !readFixed(data, size, offset, aimY))
+		{
+			return false;
+		}
+
+		unpackInputFlags(flags, input);
+		input.aimX = (int) aimX;
+		input.aimY = (int) aimY;
+	}
+
+	// The keyframe is part way through the run starting at streamOffset
+	m_StreamOffset = m_StreamStart + streamOffset;
+
+	unsigned long long runTicks;
+
+	if (!readVarint(m_Data, m_StreamEnd, m_StreamOffset, runTicks) || runTicks < runTicksPlayed)
+	{
+		return false;
+	}
+
+	m_UnchangedTicksLeft = runTicks - runTicksPlayed;
+	m_ExpectingRun = false;
+	m_TicksRead = keyframe.roundTick;
+
+	snapshot = data + offset;
+	snapshotSize = size - offset;
+
+	return true;
+}
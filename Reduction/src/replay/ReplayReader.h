@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "ReplayFormat.h"
+#include "utils/MappedFile.h"
+
+
+// Reads a replay file back one round and one tick at a time
+class ReplayReader
+{
+private:
+	// The file is mapped rather than loaded, so opening a long replay to seek in it is cheap
+	MappedFile m_File;
+	const unsigned char* m_Data = nullptr;
+	size_t m_Size = 0;
+	size_t m_Offset = 0;
+
+	ReplayHeader m_Header;
+
+	// Keyframe index from the end of the file (empty if it is damaged)
+	unsigned int m_KeyframeInterval = 0;
+	std::vector<unsigned long long> m_RoundOffsets;
+	std::vector<ReplayKeyframe> m_Keyframes;
+
+	// Tick stream of the current round
+	size_t m_StreamStart = 0;
+	size_t m_StreamOffset = 0;
+	size_t m_StreamEnd = 0;
+	unsigned int m_RoundTicks = 0;
+	unsigned int m_TicksRead = 0;
+	unsigned long long m_UnchangedTicksLeft = 0;
+	bool m_ExpectingRun = true;
+	std::vector<PlayerInput> m_Inputs;
+
+private:
+	// Reads the keyframe index from the end of the file (false if it is damaged)
+	bool readIndex();
+	// Reads one change from the tick stream into m_Inputs
+	bool readChange();
+
+public:
+	// Maps the file and reads its header and index (false if it is missing or not a replay)
+	bool open(const std::string& path);
+
+	// Moves to the next round (false at the end of the replay or on bad data)
+	bool nextRound(ReplayRound& round);
+	// Gets the inputs for the next tick of the round (nullptr once the round is over)
+	const std::vector<PlayerInput>* nextTick();
+
+	// Moves to a keyframe's round and tick, returning the simulation snapshot stored with it
+	// (false if the keyframe is damaged)
+	bool seekKeyframe(unsigned int index, ReplayRound& round, const unsigned char*& snapshot, size_t& snapshotSize);
+
+	const ReplayHeader& getHeader() const { return m_Header; }
+	size_t getSize() const { return m_Size; }
+	bool hasIndex() const { return m_KeyframeInterval != 0; }
+	unsigned int getKeyframeInterval() const { return m_KeyframeInterval; }
+	const std::vector<ReplayKeyframe>& getKeyframes() const { return m_Keyframes; }
+};
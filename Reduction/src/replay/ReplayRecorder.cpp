@@ -0,0 +1,270 @@
+#include "ReplayRecorder.h"
+
+#include <fstream>
+
+#include "utils/ByteIO.h"
+#include "utils/Varint.h"
+#include "utils/Settings.h"
+#include "utils/Log.h"
+
+
+void ReplayRecorder::begin(const ReplayHeader& header)
+{
+	if (header.playerCount > REPLAY_MAX_PLAYERS)
+	{
+		error("Cannot record a replay with ", header.playerCount, " players.");
+		cancel();
+
+		return;
+	}
+
+	m_Recording = true;
+	m_InRound = false;
+	m_Header = header;
+	m_RoundCount = 0;
+	m_EndedTicks = 0;
+	m_RoundOffsets.clear();
+	m_Keyframes.clear();
+	m_KeyframeData.clear();
+
+	m_Data.assign(REPLAY_MAGIC, REPLAY_MAGIC + 4);
+	m_Data.push_back(REPLAY_VERSION);
+	writeVarint(m_Data, header.seed);
+	writeVarint(m_Data, header.tickRate);
+	writeVarint(m_Data, header.pointsToWin);
+	m_Data.push_back((unsigned char) header.playerCount);
+}
+
+void ReplayRecorder::beginRound(const Simulation& simulation)
+{
+	if (!m_Recording)
+	{
+		return;
+	}
+
+	m_InRound = true;
+	m_RoundPowerups.clear();
+
+	for (const Player* player : simulation.getPlayers())
+	{
+		unsigned char powerups = 0;
+		powerups |= player->hasSpeedPowerup() ? POWERUP_SPEED : 0;
+		powerups |= player->hasAccuracyPowerup() ? POWERUP_ACCURACY : 0;
+		powerups |= player->hasDamagePowerup() ? POWERUP_DAMAGE : 0;
+		powerups |= player->hasCooldownPowerup() ? POWERUP_COOLDOWN : 0;
+
+		m_RoundPowerups.push_back(powerups);
+	}
+
+	m_Stream.clear();
+	m_RoundTicks = 0;
+	m_UnchangedTicks = 0;
+	m_PreviousInputs.assign(m_Header.playerCount, PlayerInput {});
+	m_RoundKeyframes.clear();
+	m_RoundKeyframeData.clear();
+
+	// Keyframes hold the reader position, each player's last input and the world
+	unsigned int keyframes = REPLAY_RESERVED_ROUND_TICKS / REPLAY_KEYFRAME_INTERVAL + 1;
+	size_t keyframeSize = sizeof(unsigned int) + sizeof(unsigned long long) + m_Header.playerCount * (1 + 2 * sizeof(unsigned int)) + simulation.getMaxStateSize();
+
+	m_Stream.reserve(REPLAY_RESERVED_ROUND_TICKS * REPLAY_RESERVED_BYTES_PER_TICK);
+	m_RoundKeyframes.reserve(keyframes);
+	m_RoundKeyframeData.reserve(keyframes * keyframeSize);
+}
+
+void ReplayRecorder::addKeyframe(const Simulation& simulation)
+{
+	ReplayKeyframe keyframe;
+	keyframe.tick = m_EndedTicks + m_RoundTicks;
+	keyframe.round = m_RoundCount;
+	keyframe.roundTick = m_RoundTicks;
+	keyframe.offset = m_RoundKeyframeData.size();
+
+	// The run being read starts where the stream ends, as it hasn't been written yet
+	writeFixed(m_RoundKeyframeData, (unsigned int) m_Stream.size());
+	writeFixed(m_RoundKeyframeData, m_UnchangedTicks);
+
+	for (const PlayerInput& input : m_PreviousInputs)
+	{
+		m_RoundKeyframeData.push_back(packInputFlags(input));
+		writeFixed(m_RoundKeyframeData, (unsigned int) input.aimX);
+		writeFixed(m_RoundKeyframeData, (unsigned int) input.aimY);
+	}
+
+	simulation.saveState(m_RoundKeyframeData);
+
+	keyframe.size = (unsigned int) (m_RoundKeyframeData.size() - keyframe.offset);
+	m_RoundKeyframes.push_back(keyframe);
+}
+
+void ReplayRecorder::recordTick(const std::vector<PlayerInput>& inputs, const Simulation& simulation)
+{
+	if (!m_InRound)
+	{
+		return;
+	}
+
+	if ((m_EndedTicks + m_RoundTicks) % REPLAY_KEYFRAME_INTERVAL == 0)
+	{
+		addKeyframe(simulation);
+	}
+
+	unsigned long long changedMask = 0;
+
+	for (unsigned int i = 0; i < m_Header.playerCount && i < inputs.size(); i++)
+	{
+		const PlayerInput& previous = m_PreviousInputs[i];
+		const PlayerInput& input = inputs[i];
+
+		// The aim position only counts while aiming
+		bool aimChanged = input.hasAimTarget && (input.aimX != previous.aimX || input.aimY != previous.aimY);
+
+		if (packInputFlags(input) != packInputFlags(previous) || aimChanged)
+		{
+			changedMask |= 1ull << i;
+		}
+	}
+
+	m_RoundTicks += 1;
+
+	if (changedMask == 0)
+	{
+		m_UnchangedTicks += 1;
+		return;
+	}
+
+	writeVarint(m_Stream, m_UnchangedTicks);
+	writeVarint(m_Stream, changedMask);
+	m_UnchangedTicks = 0;
+
+	for (unsigned int i = 0; i < m_Header.playerCount; i++)
+	{
+		if ((changedMask & (1ull << i)) == 0)
+		{
+			continue;
+		}
+
+		PlayerInput& previous = m_PreviousInputs[i];
+		const PlayerInput& input = inputs[i];
+		unsigned char flags = packInputFlags(input);
+
+		m_Stream.push_back(flags);
+
+		if (input.hasAimTarget)
+		{
+			writeVarint(m_Stream, zigzagEncode((long long) input.aimX - previous.aimX));
+			writeVarint(m_Stream, zigzagEncode((long long) input.aimY - previous.aimY));
+
+			previous.aimX = input.aimX;
+			previous.aimY = input.aimY;
+		}
+
+		unpackInputFlags(flags, previous);
+	}
+}
+
+void ReplayRecorder::endRound(unsigned int checksum)
+{
+	if (!m_InRound)
+	{
+		return;
+	}
+
+	// Trailing run of unchanged ticks
+	writeVarint(m_Stream, m_UnchangedTicks);
+
+	m_RoundOffsets.push_back(m_Data.size());
+	m_Data.push_back(REPLAY_ROUND_TAG);
+	m_Data.insert(m_Data.end(), m_RoundPowerups.begin(), m_RoundPowerups.end());
+	writeVarint(m_Data, m_RoundTicks);
+	writeVarint(m_Data, m_Stream.size());
+	m_Data.insert(m_Data.end(), m_Stream.begin(), m_Stream.end());
+
+	for (unsigned int byte = 0; byte < 4; byte++)
+	{
+		m_Data.push_back((unsigned char) (checksum >> (byte * 8)));
+	}
+
+	// The round is kept, so its keyframes are too
+	for (ReplayKeyframe keyframe : m_RoundKeyframes)
+	{
+		keyframe.offset += m_KeyframeData.size();
+		m_Keyframes.push_back(keyframe);
+	}
+
+	m_KeyframeData.insert(m_KeyframeData.end(), m_RoundKeyframeData.begin(), m_RoundKeyframeData.end());
+
+	m_InRound = false;
+	m_RoundCount += 1;
+	m_EndedTicks += m_RoundTicks;
+}
+
+
+bool ReplayRecorder::finish(const std::string& path)
+{
+	if (!m_Recording)
+	{
+		return false;
+	}
+
+	if (m_InRound)
+	{
+		warn("Finished a replay in the middle of a round, the round is dropped.");
+	}
+
+	m_Data.push_back(REPLAY_END_TAG);
+	m_Recording = false;
+	m_InRound = false;
+
+	unsigned long long keyframesOffset = m_Data.size();
+	m_Data.insert(m_Data.end(), m_KeyframeData.begin(), m_KeyframeData.end());
+
+	unsigned long long indexOffset = m_Data.size();
+	writeFixed(m_Data, REPLAY_KEYFRAME_INTERVAL);
+	writeFixed(m_Data, (unsigned int) m_RoundOffsets.size());
+
+	for (unsigned long long roundOffset : m_RoundOffsets)
+	{
+		writeFixed(m_Data, roundOffset);
+	}
+
+	writeFixed(m_Data, (unsigned int) m_Keyframes.size());
+
+	for (const ReplayKeyframe& keyframe : m_Keyframes)
+	{
+		writeFixed(m_Data, keyframe.tick);
+		writeFixed(m_Data, keyframe.round);
+		writeFixed(m_Data, keyframe.roundTick);
+		writeFixed(m_Data, keyframesOffset + keyframe.offset);
+		writeFixed(m_Data, keyframe.size);
+	}
+
+	writeFixed(m_Data, indexOffset);
+	m_Data.insert(m_Data.end(), REPLAY_INDEX_MAGIC, REPLAY_INDEX_MAGIC + 4);
+
+	std::ofstream file(path, std::ios::binary);
+
+	if (!file)
+	{
+		error("Could not open replay file for writing (filepath: ", path, ").");
+		return false;
+	}
+
+	file.write((const char*) m_Data.data(), m_Data.size());
+	info("Wrote ", m_Data.size(), " byte replay to ", path);
+
+	return (bool) file;
+}
+
+void ReplayRecorder::cancel()
+{
+	m_Recording = false;
+	m_InRound = false;
+	m_Data.clear();
+	m_Stream.clear();
+	m_RoundOffsets.clear();
+	m_Keyframes.clear();
+	m_KeyframeData.clear();
+	m_RoundKeyframes.clear();
+	m_RoundKeyframeData.clear();
+}
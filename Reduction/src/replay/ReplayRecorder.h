@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "ReplayFormat.h"
+#include "sim/Simulation.h"
+
+
+// Builds a replay in memory as a match is played, then writes it out in one go
+class ReplayRecorder
+{
+private:
+	bool m_Recording = false;
+	bool m_InRound = false;
+
+	// The whole file so far, and the current round's tick stream
+	std::vector<unsigned char> m_Data;
+	std::vector<unsigned char> m_Stream;
+
+	ReplayHeader m_Header;
+	unsigned int m_RoundCount = 0;
+	// Replay ticks in the rounds already ended
+	unsigned long long m_EndedTicks = 0;
+
+	// File offset of each ended round, and the keyframes of those rounds (blob offsets are into m_KeyframeData)
+	std::vector<unsigned long long> m_RoundOffsets;
+	std::vector<ReplayKeyframe> m_Keyframes;
+	std::vector<unsigned char> m_KeyframeData;
+
+	// Current round
+	std::vector<unsigned char> m_RoundPowerups;
+	unsigned int m_RoundTicks = 0;
+	unsigned long long m_UnchangedTicks = 0;
+	std::vector<PlayerInput> m_PreviousInputs;
+	// Keyframes of the current round, kept apart until it ends so a dropped round leaves none behind
+	std::vector<ReplayKeyframe> m_RoundKeyframes;
+	std::vector<unsigned char> m_RoundKeyframeData;
+
+private:
+	// Stores the reader position and the simulation before the coming tick
+	void addKeyframe(const Simulation& simulation);
+
+public:
+	// Starts a new replay, dropping anything not yet written
+	void begin(const ReplayHeader& header);
+	// Starts a round with the players' chosen powerups, reserving room for a round of
+	// REPLAY_RESERVED_ROUND_TICKS
+	void beginRound(const Simulation& simulation);
+	// Adds the inputs given to one simulation step, called before the simulation is stepped
+	void recordTick(const std::vector<PlayerInput>& inputs, const Simulation& simulation);
+	// Ends the round, storing a checksum of the world to catch desyncs on playback
+	void endRound(unsigned int checksum);
+
+	// Writes the replay to path and stops recording (false if the file could not be written)
+	bool finish(const std::string& path);
+	// Stops recording without writing anything
+	void cancel();
+
+	bool isRecording() const { return m_Recording; }
+	bool isInRound() const { return m_InRound; }
+	unsigned int getRoundCount() const { return m_RoundCount; }
+	const ReplayHeader& getHeader() const { return m_Header; }
+};
@@ -0,0 +1,154 @@
+#include "DedicatedServer.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "ServerMessages.h"
+#include "net/NetMessages.h"
+#include "utils/ByteIO.h"
+
+
+// Room for an hour of frames before the history has to grow
+constexpr size_t SERVER_RESERVED_FRAMES = SERVER_TICK_RATE * 3600;
+
+
+DedicatedServer::DedicatedServer(const ServerConfig& config)
+	: m_Config(config), m_Pool(config.threadCount)
+{
+	m_ThreadTotals.resize(m_Pool.getThreadCount());
+	// Room for any datagram a peer might send, so a stray one is refused rather than failing the read
+	m_ReceiveBuffer.resize(NET_MAX_MESSAGE_SIZE);
+	m_FrameTimes.reserve(SERVER_RESERVED_FRAMES);
+}
+
+DedicatedServer::~DedicatedServer()
+{
+	for (ServerMatch* match : m_Matches)
+	{
+		delete match;
+	}
+}
+
+
+bool DedicatedServer::start()
+{
+	if (!m_Socket.open(m_Config.port))
+	{
+		return false;
+	}
+
+	m_Matches.reserve(m_Config.matchCount);
+
+	for (unsigned int i = 0; i < m_Config.matchCount; i++)
+	{
+		m_Matches.push_back(new ServerMatch(i, m_Config.playerCount, m_Config.pointsToWin, m_Config.seed + i));
+	}
+
+	m_NextFrame = Clock::now();
+
+	return true;
+}
+
+
+void DedicatedServer::update()
+{
+	std::this_thread::sleep_until(m_NextFrame);
+
+	Clock::time_point frameStart = Clock::now();
+
+	// Falls back into step rather than rushing to catch up after a long stall
+	m_NextFrame = std::max(m_NextFrame + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / SERVER_TICK_RATE)), frameStart);
+
+	receiveMessages();
+
+	m_Pool.parallelFor((unsigned int) m_Matches.size(), [this](unsigned int index, unsigned int threadIndex)
+	{
+		Clock::time_point start = Clock::now();
+
+		m_Matches[index]->tick(m_Socket);
+
+		ThreadTotals& totals = m_ThreadTotals[threadIndex];
+		totals.matchTicks += 1;
+		totals.matchTickTime += std::chrono::duration<double>(Clock::now() - start).count();
+	});
+
+	std::chrono::duration<double, std::milli> frameTime = Clock::now() - frameStart;
+
+	m_FrameTimes.push_back((float) frameTime.count());
+	m_Stats.frames += 1;
+	m_Stats.overruns += (unsigned long long) (frameTime.count() > 1000.0 / SERVER_TICK_RATE);
+}
+
+
+void DedicatedServer::receiveMessages()
+{
+	NetAddress from;
+	int size;
+
+	while ((size = m_Socket.receive(m_ReceiveBuffer.data(), m_ReceiveBuffer.size(), from)) >= 0)
+	{
+		m_Stats.packetsReceived += 1;
+
+		size_t offset = 1;
+		unsigned int matchIndex;
+
+		bool handled = readFixed(m_ReceiveBuffer.data(), (size_t) size, offset, matchIndex) && matchIndex < m_Matches.size() &&
+			m_Matches[matchIndex]->handleInput(from, m_ReceiveBuffer.data(), (size_t) size);
+
+		m_Stats.packetsRefused += (unsigned long long) !handled;
+	}
+}
+
+
+ServerStats DedicatedServer::getStats() const
+{
+	ServerStats stats = m_Stats;
+
+	for (const ThreadTotals& totals : m_ThreadTotals)
+	{
+		stats.matchTicks += totals.matchTicks;
+		stats.matchTickTime += totals.matchTickTime;
+	}
+
+	return stats;
+}
+
+double DedicatedServer::getFrameTimePercentile(double percentile) const
+{
+	if (m_FrameTimes.empty())
+	{
+		return 0.0;
+	}
+
+	std::vector<float> sorted = m_FrameTimes;
+	size_t index = std::min((size_t) (percentile * sorted.size()), sorted.size() - 1);
+	std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+
+	return sorted[index];
+}
+
+
+size_t DedicatedServer::getMatchMemoryUsage() const
+{
+	size_t largest = 0;
+
+	for (const ServerMatch* match : m_Matches)
+	{
+		largest = std::max(largest, match->getMemoryUsage());
+	}
+
+	return largest;
+}
+
+size_t DedicatedServer::getTotalMemoryUsage() const
+{
+	size_t total = sizeof(DedicatedServer) + m_Matches.capacity() * sizeof(ServerMatch*) +
+		m_ThreadTotals.capacity() * sizeof(ThreadTotals) + m_ReceiveBuffer.capacity() + m_FrameTimes.capacity() * sizeof(float);
+
+	for (const ServerMatch* match : m_Matches)
+	{
+		total += match->getMemoryUsage();
+	}
+
+	return total;
+}
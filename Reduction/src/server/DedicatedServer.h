@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include "ServerMatch.h"
+#include "net/UdpSocket.h"
+#include "utils/Settings.h"
+#include "utils/ThreadPool.h"
+
+
+// How a dedicated server is set up
+struct ServerConfig
+{
+	unsigned short port = 27700;
+	unsigned int matchCount = 64;
+	unsigned int playerCount = 2;
+	unsigned int pointsToWin = 5;
+	// Threads ticking matches, including the one calling update() (0 uses every core)
+	unsigned int threadCount = 0;
+	unsigned int seed = 0;
+};
+
+// Totals since the server started
+struct ServerStats
+{
+	unsigned long long frames = 0;
+	// Frames whose work took longer than a tick
+	unsigned long long overruns = 0;
+	unsigned long long matchTicks = 0;
+	// Time spent inside match ticks, summed over every thread (seconds)
+	double matchTickTime = 0.0;
+	unsigned long long packetsReceived = 0;
+	unsigned long long packetsRefused = 0;
+};
+
+
+// Hosts many independent matches on one UDP port: each frame reads every waiting input, then
+// ticks all the matches across a thread pool, each match sending its own clients their state
+class DedicatedServer
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Per-thread totals, each on its own cache line so workers don't contend
+	struct alignas(64) ThreadTotals
+	{
+		unsigned long long matchTicks = 0;
+		double matchTickTime = 0.0;
+	};
+
+private:
+	ServerConfig m_Config;
+
+	UdpSocket m_Socket;
+	ThreadPool m_Pool;
+	std::vector<ServerMatch*> m_Matches;
+	std::vector<ThreadTotals> m_ThreadTotals;
+
+	std::vector<unsigned char> m_ReceiveBuffer;
+
+	// Work time of every frame so far (milliseconds)
+	std::vector<float> m_FrameTimes;
+	ServerStats m_Stats;
+
+	Clock::time_point m_NextFrame;
+
+private:
+	// Reads every waiting message and hands it to its match
+	void receiveMessages();
+
+public:
+	explicit DedicatedServer(const ServerConfig& config);
+	~DedicatedServer();
+
+	DedicatedServer(const DedicatedServer&) = delete;
+	DedicatedServer& operator=(const DedicatedServer&) = delete;
+
+	// Creates the matches and starts listening (false if the port can't be used)
+	bool start();
+
+	// Waits for the next frame, then plays one tick of every match
+	void update();
+
+	// Total stats, with the per-thread totals folded in
+	ServerStats getStats() const;
+	// Percentile (0 to 1) of the frame work times so far (milliseconds)
+	double getFrameTimePercentile(double percentile) const;
+
+	// Bytes of the biggest match, and of every match together
+	size_t getMatchMemoryUsage() const;
+	size_t getTotalMemoryUsage() const;
+
+	unsigned int getThreadCount() const { return m_Pool.getThreadCount(); }
+	const std::vector<ServerMatch*>& getMatches() const { return m_Matches; }
+	const ServerConfig& getConfig() const { return m_Config; }
+};
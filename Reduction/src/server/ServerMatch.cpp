@@ -0,0 +1,198 @@
+#include "ServerMatch.h"
+
+#include "ServerMessages.h"
+#include "replay/ReplayFormat.h"
+#include "sim/ScriptedInput.h"
+#include "utils/ByteIO.h"
+
+
+ServerMatch::ServerMatch(unsigned int index, unsigned int playerCount, unsigned int pointsToWin, unsigned int seed)
+	: m_Index(index), m_PointsToWin(pointsToWin), m_Simulation(SERVER_BULLET_CAPACITY, SERVER_TICK_RATE),
+	m_Clients(playerCount), m_Inputs(playerCount)
+{
+	m_Simulation.seed(seed);
+	m_Simulation.initPlayers(playerCount);
+
+	m_StateMessage.reserve(SERVER_MAX_STATE_SIZE);
+}
+
+
+bool ServerMatch::handleInput(const NetAddress& from, const unsigned char* data, size_t size)
+{
+	size_t offset = 0;
+
+	unsigned char type;
+	unsigned int matchIndex;
+	unsigned char slot;
+	unsigned int sequence;
+	unsigned char hasAck;
+	unsigned short ack;
+	unsigned char flags;
+
+	if (!readFixed(data, size, offset, type) || type != SERVER_INPUT_MESSAGE ||
+		!readFixed(data, size, offset, matchIndex) || matchIndex != m_Index ||
+		!readFixed(data, size, offset, slot) || slot >= m_Clients.size() ||
+		!readFixed(data, size, offset, sequence) || !readFixed(data, size, offset, hasAck) ||
+		!readFixed(data, size, offset, ack) || !readFixed(data, size, offset, flags))
+	{
+		return false;
+	}
+
+	PlayerInput input;
+	unpackInputFlags(flags, input);
+
+	if (input.hasAimTarget)
+	{
+		unsigned short aimX, aimY;
+
+		if (!readFixed(data, size, offset, aimX) || !readFixed(data, size, offset, aimY))
+		{
+			return false;
+		}
+
+		input.aimX = aimX;
+		input.aimY = aimY;
+	}
+
+	ServerClient& client = m_Clients[slot];
+
+	// A slot belongs to whoever claimed it until they go quiet
+	if (client.isConnected && client.address != from)
+	{
+		return false;
+	}
+
+	if (!client.isConnected)
+	{
+		client.isConnected = true;
+		client.address = from;
+		client.sequence = 0;
+		client.encoder.reset();
+	}
+
+	// Acks are taken even from inputs that arrive out of order
+	if (hasAck)
+	{
+		client.encoder.acknowledge(ack);
+	}
+
+	if (sequence <= client.sequence)
+	{
+		// A newer input has already been played
+		return true;
+	}
+
+	client.input = input;
+	client.sequence = sequence;
+	client.lastHeardTick = m_Simulation.getClock().getTick();
+
+	return true;
+}
+
+
+void ServerMatch::tick(UdpSocket& socket)
+{
+	unsigned long long tick = m_Simulation.getClock().getTick();
+	unsigned long long timeoutTicks = m_Simulation.getClock().ticksFromMilliseconds(SERVER_CLIENT_TIMEOUT);
+
+	for (unsigned int slot = 0; slot < m_Clients.size(); slot++)
+	{
+		ServerClient& client = m_Clients[slot];
+
+		if (client.isConnected && tick - client.lastHeardTick > timeoutTicks)
+		{
+			client.isConnected = false;
+		}
+
+		m_Inputs[slot] = client.isConnected ? client.input : scriptChaseInput(m_Simulation, slot);
+	}
+
+	m_Simulation.step(m_Inputs);
+	m_MatchFlow.update(m_Simulation, m_Simulation.getClock().getTick(), m_PointsToWin);
+
+	bool hasClients = getConnectedClients() > 0;
+
+	if ((hasClients || m_Relay) && m_Simulation.getClock().getTick() % SERVER_STATE_INTERVAL == 0)
+	{
+		quantizeSimulation(m_Simulation, m_Snapshot);
+
+		if (m_Relay)
+		{
+			m_Relay->publish(m_Snapshot, getRoundState(), getWinner());
+		}
+
+		for (ServerClient& client : m_Clients)
+		{
+			if (client.isConnected)
+			{
+				buildState(client);
+				socket.send(client.address, m_StateMessage.data(), m_StateMessage.size());
+
+				m_StatesSent += 1;
+				m_StateBytesSent += m_StateMessage.size();
+			}
+		}
+	}
+
+	// Starts a new match once the winner has had the round-over time (the clock carries on,
+	// so client timeouts are unaffected)
+	if (m_MatchFlow.matchWinner >= 0 && m_Simulation.getClock().getTick() - m_MatchFlow.roundOverTick >= m_Simulation.getClock().ticksFromMilliseconds(ONLINE_ROUND_OVER_TIME))
+	{
+		m_Simulation.resetPlayers(true);
+		m_Simulation.resetWall();
+		m_MatchFlow = MatchFlow {};
+		m_MatchesPlayed += 1;
+	}
+}
+
+
+unsigned char ServerMatch::getRoundState() const
+{
+	return m_MatchFlow.matchWinner >= 0 ? 2 : (m_MatchFlow.isRoundOver ? 1 : 0);
+}
+
+unsigned char ServerMatch::getWinner() const
+{
+	int winner = m_MatchFlow.matchWinner >= 0 ? m_MatchFlow.matchWinner : m_MatchFlow.roundWinner;
+
+	return (unsigned char) (getRoundState() != 0 ? winner + 1 : 0);
+}
+
+void ServerMatch::buildState(ServerClient& client)
+{
+	m_StateMessage.clear();
+	m_StateMessage.push_back(SERVER_STATE_MESSAGE);
+	writeFixed(m_StateMessage, m_Index);
+	m_StateMessage.push_back(getRoundState());
+	m_StateMessage.push_back(getWinner());
+
+	client.encoder.encode(m_Snapshot, m_StateMessage);
+}
+
+
+size_t ServerMatch::getMemoryUsage() const
+{
+	size_t usage = sizeof(ServerMatch) + m_Simulation.getMemoryUsage() +
+		m_Clients.capacity() * sizeof(ServerClient) + m_Inputs.capacity() * sizeof(PlayerInput) +
+		m_Snapshot.players.capacity() * sizeof(QuantizedPlayer) + m_Snapshot.bullets.capacity() * sizeof(QuantizedBullet) +
+		m_StateMessage.capacity();
+
+	for (const ServerClient& client : m_Clients)
+	{
+		usage += client.encoder.getMemoryUsage();
+	}
+
+	return usage;
+}
+
+unsigned int ServerMatch::getConnectedClients() const
+{
+	unsigned int count = 0;
+
+	for (const ServerClient& client : m_Clients)
+	{
+		count += (unsigned int) client.isConnected;
+	}
+
+	return count;
+}
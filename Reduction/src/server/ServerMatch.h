@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+
+#include "net/SnapshotCodec.h"
+#include "net/StateSnapshot.h"
+#include "net/UdpSocket.h"
+#include "server/SpectatorRelay.h"
+#include "sim/MatchFlow.h"
+#include "sim/Simulation.h"
+#include "utils/Settings.h"
+
+
+// Player slot of a hosted match, controlled by a client or, while nobody holds it, a bot
+struct ServerClient
+{
+	bool isConnected = false;
+	NetAddress address;
+	// Newest input received and the sequence it was sent with
+	PlayerInput input;
+	unsigned int sequence = 0;
+	// Tick the last input arrived on
+	unsigned long long lastHeardTick = 0;
+	// Encodes each state against the last one this client acknowledged
+	SnapshotEncoder encoder;
+};
+
+
+// One match on a dedicated server, playing the online rules (no powerups, rounds restart on a
+// timer) and starting a new match as soon as one is won
+class ServerMatch
+{
+private:
+	unsigned int m_Index;
+	unsigned int m_PointsToWin;
+
+	Simulation m_Simulation;
+	MatchFlow m_MatchFlow;
+	unsigned long long m_MatchesPlayed = 0;
+
+	std::vector<ServerClient> m_Clients;
+	std::vector<PlayerInput> m_Inputs;
+
+	// Quantized once a state, then delta encoded for each client
+	StateSnapshot m_Snapshot;
+	std::vector<unsigned char> m_StateMessage;
+
+	unsigned long long m_StatesSent = 0;
+	unsigned long long m_StateBytesSent = 0;
+
+	// Also publishes every state to spectators when set
+	SpectatorRelay* m_Relay = nullptr;
+
+private:
+	// Round state and winner bytes of a state message
+	unsigned char getRoundState() const;
+	unsigned char getWinner() const;
+	// Writes the state message for one client into m_StateMessage
+	void buildState(ServerClient& client);
+
+public:
+	ServerMatch(unsigned int index, unsigned int playerCount, unsigned int pointsToWin, unsigned int seed);
+
+	ServerMatch(const ServerMatch&) = delete;
+	ServerMatch& operator=(const ServerMatch&) = delete;
+
+	// Takes an input message addressed to this match (false if it was refused)
+	bool handleInput(const NetAddress& from, const unsigned char* data, size_t size);
+
+	// Plays one tick and sends the state to the clients when it is due (the socket may be shared
+	// by other threads, sending on one socket from several threads is safe)
+	void tick(UdpSocket& socket);
+
+	// Publishes every state to a relay too (it isn't owned, and is only used while ticking)
+	void setRelay(SpectatorRelay* relay) { m_Relay = relay; }
+
+	// Bytes the match takes up, including everything it allocated
+	size_t getMemoryUsage() const;
+
+	unsigned int getIndex() const { return m_Index; }
+	unsigned int getConnectedClients() const;
+	unsigned long long getMatchesPlayed() const { return m_MatchesPlayed; }
+	unsigned long long getStatesSent() const { return m_StatesSent; }
+	unsigned long long getStateBytesSent() const { return m_StateBytesSent; }
+	const Simulation& getSimulation() const { return m_Simulation; }
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "net/SnapshotCodec.h"
+#include "utils/Settings.h"
+
+
+// Messages between a dedicated server and its clients. Both start with a type byte and the
+// index of the match on the server, so one port serves every match.
+//
+// Input message, sent by a client every tick it plays:
+//   type byte, 4 byte match index, player slot byte, 4 byte sequence,
+//   state ack byte (1 if the next field holds one), 2 byte sequence of the newest state decoded,
+//   replay input flags byte and, if it aims, 2 byte aim x and y
+// The first input from an address claims a free slot. The newest input (by sequence) is played
+// every tick until another arrives, so a lost input just repeats the last one.
+//
+// State message, sent to a match's clients every SERVER_STATE_INTERVAL ticks:
+//   type byte, 4 byte match index, round state byte (0 playing, 1 round over, 2 match over),
+//   winner byte (slot + 1, 0 for nobody), then a SnapshotEncoder message delta encoded against
+//   the newest state that client acknowledged
+//
+// Watch message, sent by a spectator to join a match's relay and then every RELAY_ACK_INTERVAL:
+//   type byte, 4 byte match index, state ack byte, 2 byte sequence of the newest state decoded
+//
+// Spectator state message, the same for every viewer: laid out as a state message, but delta
+// encoded against the previous state, with a full keyframe every RELAY_KEYFRAME_INTERVAL states
+// Fixed width fields are little endian.
+
+constexpr unsigned char SERVER_INPUT_MESSAGE = 2;
+constexpr unsigned char SERVER_STATE_MESSAGE = 3;
+constexpr unsigned char SPECTATOR_WATCH_MESSAGE = 4;
+constexpr unsigned char SPECTATOR_STATE_MESSAGE = 5;
+
+constexpr unsigned int SERVER_INPUT_MESSAGE_SIZE = 18;
+constexpr unsigned int SERVER_STATE_HEADER_SIZE = 7;
+constexpr unsigned int SPECTATOR_WATCH_MESSAGE_SIZE = 8;
+// Largest state message (three players and a full bullet pool)
+constexpr unsigned int SERVER_MAX_STATE_SIZE = SERVER_STATE_HEADER_SIZE + (unsigned int) getMaxSnapshotSize(3, SERVER_BULLET_CAPACITY);
@@ -0,0 +1,284 @@
+#include "SpectatorRelay.h"
+
+#include <algorithm>
+
+#include "ServerMessages.h"
+#include "net/NetMessages.h"
+#include "utils/ByteIO.h"
+
+
+// States the relay publishes a second
+constexpr double RELAY_STATES_PER_SECOND = (double) SERVER_TICK_RATE / SERVER_STATE_INTERVAL;
+
+static unsigned long long getAddressKey(const NetAddress& address)
+{
+	return (unsigned long long) address.ip << 16 | address.port;
+}
+
+
+SpectatorRelay::SpectatorRelay(unsigned int matchIndex, ThreadPool* pool)
+	: m_MatchIndex(matchIndex), m_Pool(pool), m_Packets(SERVER_MAX_STATE_SIZE)
+{
+	m_ThreadTotals.resize(pool ? pool->getThreadCount() : 1);
+	m_ReceiveBuffer.resize(NET_MAX_MESSAGE_SIZE);
+}
+
+SpectatorRelay::~SpectatorRelay()
+{
+	// Queues hold packets, which must go back to the pool before it is destroyed
+	for (Viewer* viewer : m_Viewers)
+	{
+		delete viewer;
+	}
+}
+
+
+bool SpectatorRelay::start(unsigned short port)
+{
+	return m_Socket.open(port);
+}
+
+
+void SpectatorRelay::receive()
+{
+	NetAddress from;
+	int size;
+
+	while ((size = m_Socket.receive(m_ReceiveBuffer.data(), m_ReceiveBuffer.size(), from)) >= 0)
+	{
+		handleWatch(from, m_ReceiveBuffer.data(), (size_t) size);
+	}
+}
+
+void SpectatorRelay::handleWatch(const NetAddress& from, const unsigned char* data, size_t size)
+{
+	size_t offset = 0;
+
+	unsigned char type;
+	unsigned int matchIndex;
+	unsigned char hasAck;
+	unsigned short ack;
+
+	if (!readFixed(data, size, offset, type) || type != SPECTATOR_WATCH_MESSAGE ||
+		!readFixed(data, size, offset, matchIndex) || matchIndex != m_MatchIndex ||
+		!readFixed(data, size, offset, hasAck) || !readFixed(data, size, offset, ack))
+	{
+		return;
+	}
+
+	unsigned long long key = getAddressKey(from);
+	auto found = m_ViewerIndices.find(key);
+	Viewer* viewer;
+
+	if (found == m_ViewerIndices.end())
+	{
+		viewer = new Viewer();
+		viewer->address = from;
+
+		m_ViewerIndices[key] = (unsigned int) m_Viewers.size();
+		m_Viewers.push_back(viewer);
+		m_Stats.viewersJoined += 1;
+	}
+
+	else
+	{
+		viewer = m_Viewers[found->second];
+	}
+
+	viewer->lastHeardSequence = m_Sequence;
+
+	if (hasAck)
+	{
+		viewer->hasAck = true;
+		viewer->ack = ack;
+	}
+}
+
+
+void SpectatorRelay::publish(const StateSnapshot& snapshot, unsigned char roundState, unsigned char winner)
+{
+	bool isKeyframe = m_StatesSinceKeyframe == 0;
+	m_StatesSinceKeyframe = (m_StatesSinceKeyframe + 1) % RELAY_KEYFRAME_INTERVAL;
+
+	// Keyframes have no baseline, everything else is a delta against the state before
+	if (isKeyframe)
+	{
+		m_Encoder.reset();
+	}
+
+	SharedPacket packet = m_Packets.acquire();
+	std::vector<unsigned char>& message = packet.getBuffer();
+
+	message.push_back(SPECTATOR_STATE_MESSAGE);
+	writeFixed(message, m_MatchIndex);
+	message.push_back(roundState);
+	message.push_back(winner);
+
+	unsigned short sequence = m_Encoder.encode(snapshot, message);
+	m_Encoder.acknowledge(sequence);
+
+	m_Sequence += 1;
+	m_Stats.statesPublished += 1;
+
+	for (Viewer* viewer : m_Viewers)
+	{
+		if (isKeyframe)
+		{
+			viewer->isWaitingForKeyframe = false;
+			viewer->hasOverflowed = false;
+			viewer->isKeyframesOnly = viewer->hasAck && (unsigned short) (sequence - viewer->ack) > RELAY_MAX_LAG;
+		}
+
+		if (viewer->isWaitingForKeyframe)
+		{
+			(viewer->hasOverflowed ? m_Stats.statesHeldForResync : m_Stats.statesHeldForJoin) += 1;
+			continue;
+		}
+
+		if (viewer->isKeyframesOnly && !isKeyframe)
+		{
+			m_Stats.statesHeldForLag += 1;
+			continue;
+		}
+
+		if (viewer->queueCount == RELAY_QUEUE_PACKETS)
+		{
+			// The socket hasn't taken this viewer's states for a while, so the deltas queued are
+			// useless by now. It starts again from the next keyframe.
+			for (SharedPacket& queued : viewer->queue)
+			{
+				queued.reset();
+			}
+
+			viewer->queueCount = 0;
+			viewer->isWaitingForKeyframe = true;
+			viewer->hasOverflowed = true;
+			m_Stats.queueOverflows += 1;
+			m_Stats.statesHeldForResync += 1;
+			continue;
+		}
+
+		viewer->queue[(viewer->queueStart + viewer->queueCount) % RELAY_QUEUE_PACKETS] = packet;
+		viewer->queueCount += 1;
+	}
+}
+
+
+void SpectatorRelay::flush()
+{
+	unsigned int viewerCount = (unsigned int) m_Viewers.size();
+
+	if (m_Pool && viewerCount > 0)
+	{
+		// A few ranges per thread, so a thread held up by the socket doesn't hold up the rest
+		unsigned int rangeCount = m_Pool->getThreadCount() * 4;
+		unsigned int rangeSize = (viewerCount + rangeCount - 1) / rangeCount;
+
+		m_Pool->parallelFor(rangeCount, [&](unsigned int range, unsigned int threadIndex)
+		{
+			unsigned int end = std::min(viewerCount, (range + 1) * rangeSize);
+
+			for (unsigned int i = range * rangeSize; i < end; i++)
+			{
+				sendQueue(*m_Viewers[i], m_ThreadTotals[threadIndex]);
+			}
+		});
+	}
+
+	else
+	{
+		for (Viewer* viewer : m_Viewers)
+		{
+			sendQueue(*viewer, m_ThreadTotals[0]);
+		}
+	}
+
+	unsigned int timeoutStates = (unsigned int) (RELAY_VIEWER_TIMEOUT / 1000.0 * RELAY_STATES_PER_SECOND);
+
+	for (unsigned int i = 0; i < m_Viewers.size();)
+	{
+		if (m_Sequence - m_Viewers[i]->lastHeardSequence > timeoutStates)
+		{
+			removeViewer(i);
+			m_Stats.viewersTimedOut += 1;
+		}
+
+		else
+		{
+			i++;
+		}
+	}
+}
+
+void SpectatorRelay::sendQueue(Viewer& viewer, ThreadTotals& totals)
+{
+	while (viewer.queueCount > 0)
+	{
+		SharedPacket& packet = viewer.queue[viewer.queueStart];
+		bool isStalled = (int) (viewer.stalledUntilSequence - m_Sequence) > 0;
+
+		if (isStalled || !m_Socket.send(viewer.address, packet.getData(), packet.getSize()))
+		{
+			// Left queued to try again next flush
+			totals.sendFailures += 1;
+			return;
+		}
+
+		totals.packetsSent += 1;
+		totals.bytesSent += packet.getSize();
+
+		packet.reset();
+		viewer.queueStart = (viewer.queueStart + 1) % RELAY_QUEUE_PACKETS;
+		viewer.queueCount -= 1;
+	}
+}
+
+void SpectatorRelay::stallViewer(const NetAddress& address, unsigned int states)
+{
+	auto found = m_ViewerIndices.find(getAddressKey(address));
+
+	if (found != m_ViewerIndices.end())
+	{
+		m_Viewers[found->second]->stalledUntilSequence = m_Sequence + states;
+	}
+}
+
+void SpectatorRelay::removeViewer(unsigned int index)
+{
+	Viewer* viewer = m_Viewers[index];
+	m_ViewerIndices.erase(getAddressKey(viewer->address));
+	delete viewer;
+
+	// Swaps the last viewer into the gap
+	if (index + 1 < m_Viewers.size())
+	{
+		m_Viewers[index] = m_Viewers.back();
+		m_ViewerIndices[getAddressKey(m_Viewers[index]->address)] = index;
+	}
+
+	m_Viewers.pop_back();
+}
+
+
+RelayStats SpectatorRelay::getStats() const
+{
+	RelayStats stats = m_Stats;
+
+	for (const ThreadTotals& totals : m_ThreadTotals)
+	{
+		stats.packetsSent += totals.packetsSent;
+		stats.bytesSent += totals.bytesSent;
+		stats.sendFailures += totals.sendFailures;
+	}
+
+	return stats;
+}
+
+size_t SpectatorRelay::getMemoryUsage() const
+{
+	// Hash map nodes hold the entry and a next pointer, and buckets are a pointer each
+	size_t mapUsage = m_ViewerIndices.bucket_count() * sizeof(void*) + m_ViewerIndices.size() * (sizeof(std::pair<const unsigned long long, unsigned int>) + sizeof(void*));
+
+	return sizeof(SpectatorRelay) + m_Viewers.capacity() * sizeof(Viewer*) + m_Viewers.size() * sizeof(Viewer) + mapUsage +
+		m_Encoder.getMemoryUsage() + m_Packets.getMemoryUsage() + m_ReceiveBuffer.capacity() + m_ThreadTotals.capacity() * sizeof(ThreadTotals);
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "net/SharedPacket.h"
+#include "net/SnapshotCodec.h"
+#include "net/StateSnapshot.h"
+#include "net/UdpSocket.h"
+#include "utils/Settings.h"
+#include "utils/ThreadPool.h"
+
+
+// Totals since the relay started
+struct RelayStats
+{
+	unsigned long long statesPublished = 0;
+	unsigned long long viewersJoined = 0;
+	unsigned long long viewersTimedOut = 0;
+	// Times a viewer's queue filled up and it was skipped ahead to the next keyframe
+	unsigned long long queueOverflows = 0;
+	// States held back from viewers that just joined, until their first keyframe
+	unsigned long long statesHeldForJoin = 0;
+	// States dropped from viewers whose queue overflowed, until the keyframe they resync on
+	unsigned long long statesHeldForResync = 0;
+	// States held back from viewers whose acknowledgements lag, which only get keyframes
+	unsigned long long statesHeldForLag = 0;
+	unsigned long long packetsSent = 0;
+	unsigned long long bytesSent = 0;
+	unsigned long long sendFailures = 0;
+};
+
+
+// Relays one match to any number of spectators. Each state is encoded once into a pooled buffer
+// and every viewer's queue takes a reference to it, so fanning out copies nothing. Queues are
+// sent across a thread pool. Viewers that fall behind are held to keyframes until they catch up.
+class SpectatorRelay
+{
+	struct Viewer
+	{
+		NetAddress address;
+		// Relay sequence when the viewer was last heard from, and the newest state it decoded
+		unsigned int lastHeardSequence = 0;
+		bool hasAck = false;
+		unsigned short ack = 0;
+
+		// Nothing but keyframes until the next one (just joined, or its queue overflowed)
+		bool isWaitingForKeyframe = true;
+		bool hasOverflowed = false;
+		// Only keyframes, decided on each keyframe by how far behind it is
+		bool isKeyframesOnly = false;
+
+		// States waiting to be sent, oldest first
+		SharedPacket queue[RELAY_QUEUE_PACKETS];
+		unsigned int queueStart = 0;
+		unsigned int queueCount = 0;
+
+		// Sends are refused until this relay sequence (see stallViewer)
+		unsigned int stalledUntilSequence = 0;
+	};
+
+	// Per-thread send totals, each on its own cache line
+	struct alignas(64) ThreadTotals
+	{
+		unsigned long long packetsSent = 0;
+		unsigned long long bytesSent = 0;
+		unsigned long long sendFailures = 0;
+	};
+
+private:
+	unsigned int m_MatchIndex;
+
+	UdpSocket m_Socket;
+	// Sends on the calling thread when there is no pool
+	ThreadPool* m_Pool;
+
+	std::vector<Viewer*> m_Viewers;
+	// Index in m_Viewers by address
+	std::unordered_map<unsigned long long, unsigned int> m_ViewerIndices;
+
+	SnapshotEncoder m_Encoder;
+	PacketPool m_Packets;
+	unsigned int m_Sequence = 0;
+	unsigned int m_StatesSinceKeyframe = 0;
+
+	std::vector<unsigned char> m_ReceiveBuffer;
+	std::vector<ThreadTotals> m_ThreadTotals;
+	RelayStats m_Stats;
+
+private:
+	void handleWatch(const NetAddress& from, const unsigned char* data, size_t size);
+	// Sends what the socket will take from one viewer's queue
+	void sendQueue(Viewer& viewer, ThreadTotals& totals);
+	void removeViewer(unsigned int index);
+
+public:
+	SpectatorRelay(unsigned int matchIndex, ThreadPool* pool = nullptr);
+	~SpectatorRelay();
+
+	SpectatorRelay(const SpectatorRelay&) = delete;
+	SpectatorRelay& operator=(const SpectatorRelay&) = delete;
+
+	// Starts listening for viewers (false if the port can't be used)
+	bool start(unsigned short port);
+
+	// Reads every waiting watch message, adding new viewers
+	void receive();
+	// Encodes a state once and queues it for every viewer it suits (round state and winner are
+	// as in a state message)
+	void publish(const StateSnapshot& snapshot, unsigned char roundState, unsigned char winner);
+	// Sends the queued states and drops viewers that have gone quiet
+	void flush();
+
+	// Refuses sends to a viewer for the next few states, as if the socket wouldn't take them
+	// (sends on localhost are never refused, so this is how a load test backs a viewer up)
+	void stallViewer(const NetAddress& address, unsigned int states);
+
+	// Totals, with the per-thread ones folded in
+	RelayStats getStats() const;
+	// Bytes the relay has allocated, including every viewer
+	size_t getMemoryUsage() const;
+
+	unsigned int getViewerCount() const { return (unsigned int) m_Viewers.size(); }
+	size_t getPacketBufferCount() const { return m_Packets.getBufferCount(); }
+};
@@ -0,0 +1,33 @@
+#include "BarrierGrid.h"
+
+#include "utils/Settings.h"
+
+
+BarrierGrid::BarrierGrid(const std::vector<Barrier>& barriers)
+	: m_Grid(SCREEN_WIDTH, SCREEN_HEIGHT, COLLISION_GRID_CELL_SIZE, (unsigned int) barriers.size() * 8)
+{
+	// Barriers never move, so the grid is only built once
+	for (const Barrier& barrier : barriers)
+	{
+		m_Rects.push_back(barrier.getHorizontalRect());
+		m_Grid.insert((unsigned int) m_Rects.size() - 1, m_Rects.back());
+
+		m_Rects.push_back(barrier.getVerticalRect());
+		m_Grid.insert((unsigned int) m_Rects.size() - 1, m_Rects.back());
+	}
+
+	m_Grid.build();
+}
+
+
+bool BarrierGrid::intersects(const Rect& rect) const
+{
+	bool found = false;
+
+	m_Grid.query(rect, [&](unsigned int index)
+	{
+		found = found || hasIntersection(m_Rects[index], rect);
+	});
+
+	return found;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "SpatialGrid.h"
+#include "entities/Barrier.h"
+
+
+// Barrier rects bucketed into a grid, so overlap tests only look at nearby barriers
+class BarrierGrid
+{
+private:
+	std::vector<Rect> m_Rects;
+	SpatialGrid m_Grid;
+
+public:
+	explicit BarrierGrid(const std::vector<Barrier>& barriers);
+
+	// Whether the rect overlaps any barrier
+	bool intersects(const Rect& rect) const;
+
+	// Bytes allocated on the heap
+	size_t getMemoryUsage() const { return m_Rects.capacity() * sizeof(Rect) + m_Grid.getMemoryUsage(); }
+};
@@ -0,0 +1,165 @@
+#include "BotController.h"
+
+#include "utils/MathUtils.h"
+#include "utils/Settings.h"
+
+
+// Signed turn from one angle to another, between -180 and 180 degrees
+static double getAngleDifference(double from, double to)
+{
+	double difference = std::fmod(to - from, 360.0);
+
+	if (difference > 180.0)
+	{
+		difference -= 360.0;
+	}
+
+	else if (difference < -180.0)
+	{
+		difference += 360.0;
+	}
+
+	return difference;
+}
+
+// Time until a bullet fired now from the origin meets a target moving in a straight line
+// (0 when it can never catch up, so the shot goes at where the target is)
+static double getInterceptTime(double deltaX, double deltaY, double velX, double velY)
+{
+	double a = velX * velX + velY * velY - BULLET_SPEED * BULLET_SPEED;
+	double b = 2.0 * (deltaX * velX + deltaY * velY);
+	double c = deltaX * deltaX + deltaY * deltaY;
+
+	// Target as fast as a bullet, so there's only one root
+	if (std::abs(a) < 1e-6)
+	{
+		return b < 0.0 ? -c / b : 0.0;
+	}
+
+	double discriminant = b * b - 4.0 * a * c;
+
+	if (discriminant < 0.0)
+	{
+		return 0.0;
+	}
+
+	double root = std::sqrt(discriminant);
+	double early = (-b - root) / (2.0 * a);
+	double late = (-b + root) / (2.0 * a);
+
+	if (early > late)
+	{
+		std::swap(early, late);
+	}
+
+	return early > 0.0 ? early : (late > 0.0 ? late : 0.0);
+}
+
+
+PlayerInput DefaultBot::decide(const Simulation& simulation, unsigned int playerIndex)
+{
+	const std::vector<Player*>& players = simulation.getPlayers();
+	const Player* self = players[playerIndex];
+
+	PlayerInput input;
+
+	if (!self->isAlive())
+	{
+		return input;
+	}
+
+	double centerX = self->getPosX() + self->getRect().w / 2;
+	double centerY = self->getPosY() + self->getRect().h / 2;
+
+	// Nearest living opponent, looking at no more than BOT_MAX_TARGETS of them
+	const Player* target = nullptr;
+	double targetDistanceSquared = 0.0;
+	unsigned int candidates = std::min((unsigned int) players.size() - 1, BOT_MAX_TARGETS);
+
+	for (unsigned int offset = 1; offset <= candidates; offset++)
+	{
+		const Player* candidate = players[(playerIndex + offset) % players.size()];
+
+		if (!candidate->isAlive())
+		{
+			continue;
+		}
+
+		double deltaX = candidate->getPosX() - self->getPosX();
+		double deltaY = candidate->getPosY() - self->getPosY();
+		double distanceSquared = deltaX * deltaX + deltaY * deltaY;
+
+		if (!target || distanceSquared < targetDistanceSquared)
+		{
+			target = candidate;
+			targetDistanceSquared = distanceSquared;
+		}
+	}
+
+	double aimDirection = self->getDirection();
+	double targetDistance = 0.0;
+
+	if (target)
+	{
+		double deltaX = target->getPosX() + target->getRect().w / 2 - centerX;
+		double deltaY = target->getPosY() + target->getRect().h / 2 - centerY;
+		double velX = std::cos(toRadians(target->getDirection())) * target->getVelocity();
+		double velY = std::sin(toRadians(target->getDirection())) * target->getVelocity();
+
+		// Leads the target by where it will be when the bullet gets there
+		double time = getInterceptTime(deltaX, deltaY, velX, velY);
+
+		aimDirection = toDegrees(std::atan2(deltaY + velY * time, deltaX + velX * time));
+		targetDistance = std::sqrt(deltaX * deltaX + deltaY * deltaY);
+	}
+
+	// Players can only move the way they face, so keeping inside the wall wins over aiming
+	double wallRadius = SCREEN_HEIGHT * simulation.getWallScale() / 2;
+	double safeRadius = wallRadius - BOT_WALL_MARGIN - self->getVelocity() / 3;
+
+	double fromWallCenterX = centerX - SCREEN_WIDTH / 2;
+	double fromWallCenterY = centerY - SCREEN_HEIGHT / 2;
+	bool isNearWall = fromWallCenterX * fromWallCenterX + fromWallCenterY * fromWallCenterY > safeRadius * safeRadius;
+
+	double heading = isNearWall ? toDegrees(std::atan2(-fromWallCenterY, -fromWallCenterX)) : aimDirection;
+	double headingError = getAngleDifference(self->getDirection(), heading);
+
+	// Turns unless the next step would overshoot
+	double turnPerTick = PLAYER_ROTATION_SPEED * simulation.getClock().getTickTime();
+
+	if (headingError > turnPerTick / 2)
+	{
+		input.rotation = 1;
+	}
+
+	else if (headingError < -turnPerTick / 2)
+	{
+		input.rotation = -1;
+	}
+
+	if (isNearWall)
+	{
+		// Brakes while turning around, then heads for the middle
+		input.thrust = std::abs(headingError) < 45.0 ? 1 : -1;
+	}
+
+	else if (target)
+	{
+		if (targetDistance > BOT_PREFERRED_RANGE && std::abs(headingError) < 30.0)
+		{
+			input.thrust = 1;
+		}
+
+		else if (targetDistance < BOT_PREFERRED_RANGE / 2)
+		{
+			input.thrust = -1;
+		}
+	}
+
+	if (target && targetDistance < BOT_FIRE_RANGE)
+	{
+		input.shoot = std::abs(getAngleDifference(self->getDirection(), aimDirection)) < BOT_AIM_TOLERANCE;
+	}
+
+	return input;
+}
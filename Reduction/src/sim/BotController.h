@@ -0,0 +1,24 @@
+#pragma once
+
+#include "PlayerInput.h"
+#include "Simulation.h"
+
+
+// Plays a slot in place of a person, turning the world into the same input a keyboard would give
+class BotController
+{
+public:
+	virtual ~BotController() = default;
+
+	// Input for a player's next step (runs every tick, so the work must be bounded)
+	virtual PlayerInput decide(const Simulation& simulation, unsigned int playerIndex) = 0;
+};
+
+
+// Fights the nearest opponent: turns to where its shots will meet them, closes to a comfortable
+// range and heads back in before the wall reaches it
+class DefaultBot : public BotController
+{
+public:
+	PlayerInput decide(const Simulation& simulation, unsigned int playerIndex) override;
+};
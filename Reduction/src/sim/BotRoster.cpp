@@ -0,0 +1,70 @@
+#include "BotRoster.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "utils/Profiler.h"
+#include "utils/Settings.h"
+
+
+BotRoster::~BotRoster()
+{
+	for (BotController* bot : m_Bots)
+	{
+		delete bot;
+	}
+}
+
+
+void BotRoster::setBot(unsigned int slot, BotController* bot)
+{
+	if (slot >= m_Bots.size())
+	{
+		m_Bots.resize(slot + 1, nullptr);
+	}
+
+	m_BotCount += (unsigned int) (bot != nullptr) - (unsigned int) (m_Bots[slot] != nullptr);
+
+	delete m_Bots[slot];
+	m_Bots[slot] = bot;
+}
+
+void BotRoster::fill(unsigned int playerCount)
+{
+	for (unsigned int slot = 0; slot < playerCount; slot++)
+	{
+		setBot(slot, new DefaultBot());
+	}
+}
+
+
+void BotRoster::decide(const Simulation& simulation, std::vector<PlayerInput>& inputs)
+{
+	if (m_BotCount == 0)
+	{
+		return;
+	}
+
+	ProfileScope profileScope(ProfilePhase::Bots);
+	auto start = std::chrono::steady_clock::now();
+
+	unsigned int decisions = 0;
+	unsigned int slots = std::min((unsigned int) m_Bots.size(), (unsigned int) inputs.size());
+
+	for (unsigned int slot = 0; slot < slots; slot++)
+	{
+		if (m_Bots[slot])
+		{
+			inputs[slot] = m_Bots[slot]->decide(simulation, slot);
+			decisions += 1;
+		}
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	m_Stats.ticks += 1;
+	m_Stats.decisions += decisions;
+	m_Stats.totalTime += elapsed.count();
+	m_Stats.maxTickTime = std::max(m_Stats.maxTickTime, elapsed.count());
+	m_Stats.ticksOverBudget += (unsigned long long) (elapsed.count() * 1e6 > decisions * BOT_DECISION_BUDGET);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+
+#include "BotController.h"
+
+
+// Time spent deciding, since the roster was created or the stats reset
+struct BotStats
+{
+	unsigned long long ticks = 0;
+	unsigned long long decisions = 0;
+	// Seconds over every tick, and the slowest tick
+	double totalTime = 0.0;
+	double maxTickTime = 0.0;
+	// Ticks whose decisions took longer than BOT_DECISION_BUDGET each
+	unsigned long long ticksOverBudget = 0;
+};
+
+
+// The bots playing a match, by slot. Every tick they fill in their own slots' inputs, and the time
+// they take is measured so many of them can be run in batch simulations.
+class BotRoster
+{
+private:
+	// Owned, null for slots played by people
+	std::vector<BotController*> m_Bots;
+	unsigned int m_BotCount = 0;
+
+	BotStats m_Stats;
+
+public:
+	BotRoster() = default;
+	~BotRoster();
+
+	BotRoster(const BotRoster&) = delete;
+	BotRoster& operator=(const BotRoster&) = delete;
+
+	// Hands a slot to a bot (taking ownership), or back to a person with nullptr
+	void setBot(unsigned int slot, BotController* bot);
+	// Puts a default bot in every slot up to playerCount
+	void fill(unsigned int playerCount);
+
+	// Overwrites the inputs of every slot a bot plays (slots past the end of inputs are skipped)
+	void decide(const Simulation& simulation, std::vector<PlayerInput>& inputs);
+
+	bool isBot(unsigned int slot) const { return slot < m_Bots.size() && m_Bots[slot]; }
+	bool isEmpty() const { return m_BotCount == 0; }
+
+	const BotStats& getStats() const { return m_Stats; }
+	void resetStats() { m_Stats = BotStats(); }
+};
@@ -0,0 +1,32 @@
+#include "MatchFlow.h"
+
+
+void MatchFlow::update(Simulation& simulation, unsigned long long ticksPlayed, unsigned int pointsToWin)
+{
+	if (matchWinner >= 0)
+	{
+		return;
+	}
+
+	if (!isRoundOver)
+	{
+		if (simulation.isRoundOver())
+		{
+			isRoundOver = true;
+			roundOverTick = ticksPlayed;
+			roundWinner = simulation.awardRound();
+
+			if (roundWinner >= 0 && simulation.getPlayers()[roundWinner]->getPoints() >= pointsToWin)
+			{
+				matchWinner = roundWinner;
+			}
+		}
+	}
+
+	else if (ticksPlayed - roundOverTick >= simulation.getClock().ticksFromMilliseconds(ONLINE_ROUND_OVER_TIME))
+	{
+		simulation.resetPlayers();
+		simulation.resetWall();
+		isRoundOver = false;
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Simulation.h"
+
+
+// Rounds of a match played without menus (online and on a server). Rounds end and restart on
+// tick counts rather than button presses, so everyone playing the same ticks agrees on them.
+struct MatchFlow
+{
+	// Tick the current round ended on
+	unsigned long long roundOverTick = 0;
+	bool isRoundOver = false;
+	// Winner of the last round and of the match (-1 for nobody yet)
+	int roundWinner = -1;
+	int matchWinner = -1;
+
+	// Scores and restarts rounds, call after each step (ticks played includes that step)
+	void update(Simulation& simulation, unsigned long long ticksPlayed, unsigned int pointsToWin);
+};
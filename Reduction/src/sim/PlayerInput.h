@@ -0,0 +1,18 @@
+#pragma once
+
+
+// What one player is doing during a simulation step
+struct PlayerInput
+{
+	// -1 rotates anticlockwise, 1 rotates clockwise
+	int rotation = 0;
+	// 1 accelerates, -1 brakes
+	int thrust = 0;
+	// Fires a bullet if the cooldown has passed
+	bool shoot = false;
+
+	// Cursor-controlled players turn to face a point instead of rotating
+	bool hasAimTarget = false;
+	int aimX = 0;
+	int aimY = 0;
+};
@@ -0,0 +1,41 @@
+#include "RenderState.h"
+
+
+void RenderState::capture(const Simulation& simulation)
+{
+	const BulletPool& pool = simulation.getBullets();
+
+	if (bullets.capacity() < pool.getCapacity())
+	{
+		bullets.reserve(pool.getCapacity());
+	}
+
+	tick = simulation.getClock().getTick();
+
+	players.clear();
+
+	for (const Player* player : simulation.getPlayers())
+	{
+		players.push_back(*player);
+	}
+
+	bullets.resize(pool.size());
+
+	for (unsigned int i = 0; i < pool.size(); i++)
+	{
+		bullets[i] = BulletFrame { pool.getPosX(i), pool.getPosY(i), pool.getPrevPosX(i), pool.getPrevPosY(i) };
+	}
+
+	wallScale = simulation.getWallScale();
+	previousWallScale = simulation.getInterpolatedWallScale(0.0);
+
+	isRoundOver = simulation.isRoundOver();
+	publishTime = std::chrono::steady_clock::now();
+}
+
+Rect RenderState::getInterpolatedBulletRect(unsigned int index, double alpha) const
+{
+	const BulletFrame& bullet = bullets[index];
+
+	return Rect { (int) (bullet.prevPosX + (bullet.posX - bullet.prevPosX) * alpha), (int) (bullet.prevPosY + (bullet.posY - bullet.prevPosY) * alpha), BULLET_WIDTH, BULLET_HEIGHT };
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include "Simulation.h"
+#include "utils/Rect.h"
+
+
+// Where a bullet is now and was a step before
+struct BulletFrame
+{
+	double posX, posY;
+	double prevPosX, prevPosY;
+};
+
+
+// Copy of what the renderer needs from the simulation after one step, so it can be drawn while
+// later steps run on another thread
+struct RenderState
+{
+	unsigned long long tick = 0;
+	// Copies of the players, which the sprites draw from as they would the originals
+	std::vector<Player> players;
+	std::vector<BulletFrame> bullets;
+
+	double wallScale = 1.0;
+	double previousWallScale = 1.0;
+
+	bool isRoundOver = false;
+
+	// When the step finished, so the renderer knows how far it is towards the next one
+	std::chrono::steady_clock::time_point publishTime;
+
+	// Overwrites this with the simulation's current state (allocation-free after the first call
+	// with the same players and bullet capacity)
+	void capture(const Simulation& simulation);
+
+	// Bullet and wall blended between the last two steps (alpha from 0 to 1)
+	Rect getInterpolatedBulletRect(unsigned int index, double alpha) const;
+	double getInterpolatedWallScale(double alpha) const { return previousWallScale + (wallScale - previousWallScale) * alpha; }
+};
@@ -0,0 +1,31 @@
+#include "ScriptedInput.h"
+
+
+PlayerInput scriptChaseInput(const Simulation& simulation, unsigned int playerIndex)
+{
+	const std::vector<Player*>& players = simulation.getPlayers();
+	const Player* target = nullptr;
+
+	for (unsigned int offset = 1; offset < players.size() && !target; offset++)
+	{
+		const Player* candidate = players[(playerIndex + offset) % players.size()];
+
+		if (candidate->isAlive())
+		{
+			target = candidate;
+		}
+	}
+
+	PlayerInput input;
+
+	if (target)
+	{
+		input.hasAimTarget = true;
+		input.aimX = target->getRect().x;
+		input.aimY = target->getRect().y;
+		input.thrust = 1;
+		input.shoot = true;
+	}
+
+	return input;
+}
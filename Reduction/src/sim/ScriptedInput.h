@@ -0,0 +1,8 @@
+#pragma once
+
+#include "PlayerInput.h"
+#include "Simulation.h"
+
+
+// Input for a player with nobody controlling it: chases and fires at the next living player
+PlayerInput scriptChaseInput(const Simulation& simulation, unsigned int playerIndex);
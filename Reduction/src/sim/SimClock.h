@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cmath>
+
+
+// Counts simulation ticks, so gameplay timing never depends on the wall clock
+class SimClock
+{
+private:
+	unsigned int m_TickRate;
+	unsigned long long m_Tick = 0;
+
+public:
+	explicit SimClock(unsigned int tickRate)
+		: m_TickRate(tickRate)
+	{
+	}
+
+	// Moves on by one tick
+	void advance() { m_Tick += 1; }
+	// Goes back to tick 0
+	void reset() { m_Tick = 0; }
+	// Jumps straight to a tick (restoring a snapshot)
+	void setTick(unsigned long long tick) { m_Tick = tick; }
+
+	// Ticks since the clock started
+	unsigned long long getTick() const { return m_Tick; }
+
+	unsigned int getTickRate() const { return m_TickRate; }
+	// Length of a tick in seconds
+	double getTickTime() const { return 1.0 / m_TickRate; }
+	// Time since the clock started, in seconds
+	double getSeconds() const { return m_Tick * getTickTime(); }
+
+	// Whole ticks needed for a duration to pass (rounded up)
+	unsigned long long ticksFromMilliseconds(double milliseconds) const
+	{
+		// Leeway stops exact durations rounding up a tick from floating point error
+		return (unsigned long long) std::ceil(milliseconds * m_TickRate / 1000.0 - 1e-9);
+	}
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+
+// Flat copy of a simulation's state, sized once so saving and restoring never allocate
+class SimSnapshot
+{
+private:
+	std::vector<unsigned char> m_Data;
+
+public:
+	// Capacity should come from Simulation::getMaxStateSize()
+	explicit SimSnapshot(size_t capacity = 0)
+	{
+		m_Data.reserve(capacity);
+	}
+
+	// Buffer Simulation writes into (cleared first, so stays within its capacity)
+	std::vector<unsigned char>& getBuffer() { return m_Data; }
+
+	const unsigned char* getData() const { return m_Data.data(); }
+	size_t getSize() const { return m_Data.size(); }
+	size_t getCapacity() const { return m_Data.capacity(); }
+	bool isEmpty() const { return m_Data.empty(); }
+};
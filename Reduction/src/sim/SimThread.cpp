@@ -0,0 +1,155 @@
+#include "SimThread.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "utils/Profiler.h"
+
+
+SimThread::SimThread(Simulation& simulation, BotRoster& bots, ReplayRecorder& recorder)
+	: m_Simulation(simulation), m_Bots(bots), m_Recorder(recorder)
+{
+}
+
+SimThread::~SimThread()
+{
+	stop();
+}
+
+
+void SimThread::start(unsigned int playerCount)
+{
+	stop();
+
+	m_TickTime = m_Simulation.getClock().getTickTime();
+	m_Inputs.assign(playerCount, PlayerInput {});
+	m_SentInputs.assign(playerCount, PlayerInput {});
+	m_Stats = SimThreadStats();
+
+	// Every buffer starts as the current world, sized so the thread never allocates
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		m_States.getBuffer(i).capture(m_Simulation);
+	}
+
+	// Input left over from the last round is dropped
+	InputChange change;
+
+	while (m_InputChanges.pop(change))
+	{
+	}
+
+	m_Stopping = false;
+	m_Thread = std::thread(&SimThread::threadLoop, this);
+}
+
+void SimThread::stop()
+{
+	if (m_Thread.joinable())
+	{
+		m_Stopping = true;
+		m_Thread.join();
+	}
+}
+
+
+void SimThread::threadLoop()
+{
+	using Clock = std::chrono::steady_clock;
+
+	Clock::duration tickTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_TickTime));
+	Clock::duration maxCatchUp = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(MAX_SIM_CATCH_UP_TIME));
+
+	Clock::time_point nextTick = Clock::now() + tickTime;
+
+	// Collision and bot time is still shown in the frame profile
+	Profiler::registerSimThread();
+
+	while (!m_Stopping)
+	{
+		std::this_thread::sleep_until(nextTick);
+
+		Clock::time_point start = Clock::now();
+
+		// A long stall is skipped rather than caught up on all at once
+		if (start - nextTick > maxCatchUp)
+		{
+			nextTick = start;
+		}
+
+		std::chrono::duration<double, std::milli> lateness = start - nextTick;
+		m_Stats.ticks += 1;
+		m_Stats.lateTicks += (unsigned long long) (lateness.count() > SIM_LATE_TICK_TIME);
+		m_Stats.totalLateness += lateness.count();
+		m_Stats.maxLateness = std::max(m_Stats.maxLateness, lateness.count());
+
+		takeInputChanges();
+
+		m_Bots.decide(m_Simulation, m_Inputs);
+		m_Recorder.recordTick(m_Inputs, m_Simulation);
+		m_Simulation.step(m_Inputs);
+
+		for (PlayerInput& input : m_Inputs)
+		{
+			input.shoot = false;
+		}
+
+		m_States.getBack().capture(m_Simulation);
+		m_States.publish();
+
+		std::chrono::duration<double, std::milli> stepTime = Clock::now() - start;
+		m_Stats.maxStepTime = std::max(m_Stats.maxStepTime, stepTime.count());
+
+		// The last state says the round is over, and stays up until the thread is stopped
+		if (m_Simulation.isRoundOver())
+		{
+			break;
+		}
+
+		nextTick += tickTime;
+	}
+}
+
+void SimThread::takeInputChanges()
+{
+	InputChange change;
+
+	while (m_InputChanges.pop(change))
+	{
+		if (change.slot < m_Inputs.size())
+		{
+			bool shoot = m_Inputs[change.slot].shoot;
+
+			m_Inputs[change.slot] = change.input;
+			m_Inputs[change.slot].shoot = change.input.shoot || shoot;
+		}
+	}
+}
+
+
+void SimThread::sendInputs(std::vector<PlayerInput>& inputs)
+{
+	unsigned int slots = std::min((unsigned int) inputs.size(), (unsigned int) m_SentInputs.size());
+
+	for (unsigned int slot = 0; slot < slots; slot++)
+	{
+		PlayerInput& input = inputs[slot];
+		const PlayerInput& sent = m_SentInputs[slot];
+
+		bool isChanged = input.shoot || input.rotation != sent.rotation || input.thrust != sent.thrust || input.hasAimTarget != sent.hasAimTarget ||
+			(input.hasAimTarget && (input.aimX != sent.aimX || input.aimY != sent.aimY));
+
+		if (isChanged && m_InputChanges.push(InputChange { slot, input }))
+		{
+			m_SentInputs[slot] = input;
+			input.shoot = false;
+		}
+	}
+}
+
+double SimThread::getAlpha(const RenderState& state) const
+{
+	std::chrono::duration<double> sincePublish = std::chrono::steady_clock::now() - state.publishTime;
+
+	return std::min(1.0, sincePublish.count() / m_TickTime);
+}
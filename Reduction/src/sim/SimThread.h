@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "BotRoster.h"
+#include "PlayerInput.h"
+#include "RenderState.h"
+#include "Simulation.h"
+#include "replay/ReplayRecorder.h"
+#include "utils/Settings.h"
+#include "utils/SpscQueue.h"
+#include "utils/TripleBuffer.h"
+
+
+// Tick timing on the simulation thread over one run
+struct SimThreadStats
+{
+	unsigned long long ticks = 0;
+	// Ticks that started more than SIM_LATE_TICK_TIME after they were due
+	unsigned long long lateTicks = 0;
+	// Total and worst lateness, and the slowest step (milliseconds)
+	double totalLateness = 0.0;
+	double maxLateness = 0.0;
+	double maxStepTime = 0.0;
+};
+
+
+// Plays a round on its own thread at the fixed tick rate, so a slow frame on the render thread
+// never holds the simulation up. Inputs come in through a lock-free queue and each step goes out
+// as a RenderState through a lock-free triple buffer. While it runs, the simulation, bots and
+// recorder belong to the thread and must not be touched from outside.
+class SimThread
+{
+	// A slot's whole input as it was on the render thread
+	struct InputChange
+	{
+		unsigned int slot;
+		PlayerInput input;
+	};
+
+private:
+	Simulation& m_Simulation;
+	BotRoster& m_Bots;
+	ReplayRecorder& m_Recorder;
+
+	std::thread m_Thread;
+	std::atomic<bool> m_Stopping { false };
+
+	SpscQueue<InputChange, SIM_INPUT_QUEUE_SIZE> m_InputChanges;
+	TripleBuffer<RenderState> m_States;
+
+	// Seconds per step (the clock's tick changes on the thread, this never does)
+	double m_TickTime = 0.0;
+
+	// Only used on the simulation thread
+	std::vector<PlayerInput> m_Inputs;
+	SimThreadStats m_Stats;
+
+	// Only used on the render thread: input as last queued, so only changes are sent
+	std::vector<PlayerInput> m_SentInputs;
+
+private:
+	void threadLoop();
+	// Applies the queued input changes (a shot stays pressed until a step has used it)
+	void takeInputChanges();
+
+public:
+	SimThread(Simulation& simulation, BotRoster& bots, ReplayRecorder& recorder);
+	~SimThread();
+
+	SimThread(const SimThread&) = delete;
+	SimThread& operator=(const SimThread&) = delete;
+
+	// Starts stepping from the simulation as it is now, returns straight away
+	void start(unsigned int playerCount);
+	// Waits for the thread to finish its current step and end
+	void stop();
+
+	// Render thread: queues the inputs that changed since they were last sent. A shot is cleared
+	// once it is queued, and anything that doesn't fit in the queue is tried again next call.
+	void sendInputs(std::vector<PlayerInput>& inputs);
+
+	// Render thread: the newest state published (stays the same until the next call)
+	const RenderState& getLatestState()
+	{
+		m_States.update();
+		return m_States.getFront();
+	}
+
+	// Render thread: how far from a state towards the next step now is (0 to 1)
+	double getAlpha(const RenderState& state) const;
+
+	bool isRunning() const { return m_Thread.joinable(); }
+	// Only valid once stopped
+	const SimThreadStats& getStats() const { return m_Stats; }
+};
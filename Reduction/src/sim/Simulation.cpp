@@ -0,0 +1,443 @@
+#include "Simulation.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <type_traits>
+
+#include "utils/Settings.h"
+#include "utils/ByteIO.h"
+#include "utils/MathUtils.h"
+#include "utils/Profiler.h"
+
+
+// Barriers are in a square around the center of the screen
+static std::vector<Barrier> createBarriers()
+{
+	std::vector<Barrier> barriers;
+	barriers.push_back(Barrier { SCREEN_WIDTH / 2 - BARRIER_DISTANCE_FROM_CENTER, SCREEN_HEIGHT / 2 - BARRIER_DISTANCE_FROM_CENTER });
+	barriers.push_back(Barrier { SCREEN_WIDTH / 2 + BARRIER_DISTANCE_FROM_CENTER, SCREEN_HEIGHT / 2 - BARRIER_DISTANCE_FROM_CENTER });
+	barriers.push_back(Barrier { SCREEN_WIDTH / 2 + BARRIER_DISTANCE_FROM_CENTER, SCREEN_HEIGHT / 2 + BARRIER_DISTANCE_FROM_CENTER });
+	barriers.push_back(Barrier { SCREEN_WIDTH / 2 - BARRIER_DISTANCE_FROM_CENTER, SCREEN_HEIGHT / 2 + BARRIER_DISTANCE_FROM_CENTER });
+
+	return barriers;
+}
+
+
+Simulation::Simulation(unsigned int bulletCapacity, unsigned int tickRate)
+	: m_Bullets(bulletCapacity),
+	m_Barriers(createBarriers()),
+	m_BarrierGrid(m_Barriers),
+	m_BulletGrid(SCREEN_WIDTH, SCREEN_HEIGHT, COLLISION_GRID_CELL_SIZE, bulletCapacity),
+	m_Clock(tickRate)
+{
+	m_CollisionCandidates.reserve(bulletCapacity);
+}
+
+Simulation::~Simulation()
+{
+	// Deletes players
+	for (Player* player : m_Players)
+	{
+		delete player;
+	}
+}
+
+
+void Simulation::initPlayers(unsigned int numberOfPlayers)
+{
+	// Removes old players if they exist
+	for (Player* player : m_Players)
+	{
+		delete player;
+	}
+
+	m_Players.clear();
+	m_Bullets.clear();
+	m_Clock.reset();
+
+	// Initialises the players
+	m_Players.push_back(new Player(PlayerColour::Red, RED_PLAYER_START_X, RED_PLAYER_START_Y, RED_PLAYER_START_DIRECTION));
+	m_Players.push_back(new Player(PlayerColour::Blue, BLUE_PLAYER_START_X, BLUE_PLAYER_START_Y, BLUE_PLAYER_START_DIRECTION));
+
+	if (numberOfPlayers == 3)
+	{
+		m_Players.push_back(new Player(PlayerColour::Grey, GREY_PLAYER_START_X, GREY_PLAYER_START_Y, GREY_PLAYER_START_DIRECTION));
+	}
+
+	resetRandomStreams();
+}
+
+void Simulation::seed(unsigned int seed)
+{
+	m_Seed = seed;
+	resetRandomStreams();
+}
+
+void Simulation::resetRandomStreams()
+{
+	CounterRng matchRng(m_Seed);
+	m_PlayerRngs.clear();
+
+	for (unsigned int playerIndex = 0; playerIndex < m_Players.size(); playerIndex++)
+	{
+		m_PlayerRngs.push_back(matchRng.split(playerIndex));
+	}
+}
+
+
+void Simulation::step(const std::vector<PlayerInput>& inputs)
+{
+	double dt = m_Clock.getTickTime();
+
+	// Keeps where everything was, so rendering can interpolate
+	for (Player* player : m_Players)
+	{
+		player->savePreviousState();
+	}
+
+	// Updates players
+	for (unsigned int playerIndex = 0; playerIndex < m_Players.size(); playerIndex++)
+	{
+		Player* player = m_Players[playerIndex];
+
+		if (player->isAlive())
+		{
+			if (playerIndex < inputs.size())
+			{
+				applyInput(playerIndex, inputs[playerIndex]);
+			}
+
+			player->update(dt, m_WallScale, m_BarrierGrid);
+		}
+	}
+
+	m_Bullets.update(dt, m_BarrierGrid);
+
+	updateCollisions();
+
+	// Removes every bullet that died this step in one pass
+	m_Bullets.compact();
+
+	m_Clock.advance();
+
+	// Updates wall from the round's tick count, so it closes the same at any tick rate
+	m_PreviousWallScale = m_WallScale;
+	m_WallScale = 1.0 + WALL_SPEED * (m_Clock.getTick() - m_WallStartTick) * dt;
+
+	if (m_WallScale < WALL_MINIMUM_SCALE)
+	{
+		m_WallScale = WALL_MINIMUM_SCALE;
+	}
+}
+
+void Simulation::applyInput(unsigned int playerIndex, const PlayerInput& input)
+{
+	Player* player = m_Players[playerIndex];
+
+	if (input.hasAimTarget)
+	{
+		int deltaX = input.aimX - player->getRect().x;
+		int deltaY = input.aimY - player->getRect().y;
+
+		if (deltaX * deltaX + deltaY * deltaY > 100)
+		{
+			player->setRotation(toDegrees(std::atan2(deltaY, deltaX)));
+		}
+
+		else
+		{
+			player->setVelocity(0.0);
+		}
+	}
+
+	else
+	{
+		player->setRotationSpeed(input.rotation * PLAYER_ROTATION_SPEED);
+	}
+
+	if (input.thrust > 0)
+	{
+		player->setAcceleration(PLAYER_ACCELERATION);
+	}
+
+	else if (input.thrust < 0)
+	{
+		player->setAcceleration(-PLAYER_ACCELERATION * 2 / 3);
+	}
+
+	else
+	{
+		player->setAcceleration(0.0);
+	}
+
+	if (input.shoot)
+	{
+		player->spawnBullet(m_Bullets, playerIndex, m_Clock, m_PlayerRngs[playerIndex]);
+	}
+}
+
+void Simulation::updateCollisions()
+{
+	ProfileScope profileScope(ProfilePhase::Collision);
+
+	m_Bullets.fillGrid(m_BulletGrid);
+
+	for (unsigned int playerIndex = 0; playerIndex < m_Players.size(); playerIndex++)
+	{
+		Player* player = m_Players[playerIndex];
+
+		if (!player->isAlive())
+		{
+			continue;
+		}
+
+		// Bullets are bucketed by their top-left corner, so the search area is
+		// widened by a bullet's size (and a knockback, as hits move the player)
+		Rect startRect = player->getRect();
+		Rect searchRect = startRect;
+		searchRect.x -= BULLET_WIDTH + (int) BULLET_KNOCKBACK;
+		searchRect.y -= BULLET_HEIGHT + (int) BULLET_KNOCKBACK;
+		searchRect.w += BULLET_WIDTH + 2 * (int) BULLET_KNOCKBACK;
+		searchRect.h += BULLET_HEIGHT + 2 * (int) BULLET_KNOCKBACK;
+
+		m_CollisionCandidates.clear();
+		m_BulletGrid.query(searchRect, [&](unsigned int bulletIndex)
+		{
+			m_CollisionCandidates.push_back(bulletIndex);
+		});
+
+		// Hits are taken in pool order, as each knockback changes which bullets the later ones
+		// overlap
+		std::sort(m_CollisionCandidates.begin(), m_CollisionCandidates.end());
+
+		for (unsigned int bulletIndex : m_CollisionCandidates)
+		{
+			if (!collideBullet(*player, playerIndex, bulletIndex))
+			{
+				continue;
+			}
+
+			const Rect& rect = player->getRect();
+
+			// Knocked further than the search area allows for (several hits in one step), so the
+			// rest of the pool is checked in full
+			if (std::abs(rect.x - startRect.x) > (int) BULLET_KNOCKBACK || std::abs(rect.y - startRect.y) > (int) BULLET_KNOCKBACK)
+			{
+				for (unsigned int laterIndex = bulletIndex + 1; laterIndex < m_Bullets.size(); laterIndex++)
+				{
+					collideBullet(*player, playerIndex, laterIndex);
+				}
+
+				break;
+			}
+		}
+	}
+}
+
+bool Simulation::collideBullet(Player& player, unsigned int playerIndex, unsigned int bulletIndex)
+{
+	if (!m_Bullets.isAlive(bulletIndex) || m_Bullets.getOwner(bulletIndex) == playerIndex)
+	{
+		return false;
+	}
+
+	if (!hasIntersection(player.getRect(), m_Bullets.getRect(bulletIndex)))
+	{
+		return false;
+	}
+
+	player.takeHit(m_Bullets.getVelX(bulletIndex) / BULLET_SPEED, m_Bullets.getVelY(bulletIndex) / BULLET_SPEED, m_Bullets.getDamage(bulletIndex));
+	m_Bullets.kill(bulletIndex);
+
+	return true;
+}
+
+
+void Simulation::resetPlayers(bool completeReset)
+{
+	for (Player* player : m_Players)
+	{
+		player->reset(completeReset);
+	}
+
+	m_Bullets.clear();
+}
+
+void Simulation::resetWall()
+{
+	m_WallScale = 1.0;
+	m_PreviousWallScale = 1.0;
+	m_WallStartTick = m_Clock.getTick();
+}
+
+void Simulation::closeWall()
+{
+	// The scale is worked out from when the wall started closing, so that is moved back (the
+	// clock jumps on if the match is younger, which only lets cooldowns run out early)
+	unsigned long long closeTicks = m_Clock.ticksFromMilliseconds((1.0 - WALL_MINIMUM_SCALE) / -WALL_SPEED * 1000);
+
+	if (m_Clock.getTick() < closeTicks)
+	{
+		m_Clock.setTick(closeTicks);
+	}
+
+	m_WallStartTick = m_Clock.getTick() - closeTicks;
+	m_WallScale = WALL_MINIMUM_SCALE;
+	m_PreviousWallScale = WALL_MINIMUM_SCALE;
+}
+
+bool Simulation::isRoundOver() const
+{
+	unsigned int playersAlive = 0;
+
+	for (const Player* player : m_Players)
+	{
+		playersAlive += (unsigned int) player->isAlive();
+	}
+
+	return playersAlive <= 1;
+}
+
+int Simulation::awardRound()
+{
+	for (unsigned int i = 0; i < m_Players.size(); i++)
+	{
+		if (m_Players[i]->isAlive())
+		{
+			m_Players[i]->addPoint();
+			return (int) i;
+		}
+	}
+
+	return -1;
+}
+
+
+// Players and their random streams are copied as raw bytes, so they must stay plain data
+static_assert(std::is_trivially_copyable<Player>::value, "Player is saved in snapshots as raw bytes");
+static_assert(std::is_trivially_copyable<CounterRng>::value, "CounterRng is saved in snapshots as raw bytes");
+
+void Simulation::saveState(std::vector<unsigned char>& out) const
+{
+	writePod(out, m_Clock.getTick());
+	writePod(out, m_WallScale);
+	writePod(out, m_PreviousWallScale);
+	writePod(out, m_WallStartTick);
+
+	unsigned int playerCount = (unsigned int) m_Players.size();
+	writePod(out, playerCount);
+
+	for (unsigned int playerIndex = 0; playerIndex < playerCount; playerIndex++)
+	{
+		writePod(out, *m_Players[playerIndex]);
+		writePod(out, m_PlayerRngs[playerIndex]);
+	}
+
+	m_Bullets.saveState(out);
+}
+
+bool Simulation::loadState(const unsigned char* data, size_t size)
+{
+	size_t offset = 0;
+	unsigned long long tick;
+	unsigned int playerCount;
+
+	if (!readPod(data, size, offset, tick) || !readPod(data, size, offset, m_WallScale)
+		|| !readPod(data, size, offset, m_PreviousWallScale) || !readPod(data, size, offset, m_WallStartTick)
+		|| !readPod(data, size, offset, playerCount) || playerCount != m_Players.size())
+	{
+		return false;
+	}
+
+	for (unsigned int playerIndex = 0; playerIndex < playerCount; playerIndex++)
+	{
+		if (!readPod(data, size, offset, *m_Players[playerIndex]) || !readPod(data, size, offset, m_PlayerRngs[playerIndex]))
+		{
+			return false;
+		}
+	}
+
+	if (!m_Bullets.loadState(data, size, offset))
+	{
+		return false;
+	}
+
+	m_Clock.setTick(tick);
+
+	return true;
+}
+
+size_t Simulation::getMaxStateSize() const
+{
+	size_t size = sizeof(unsigned long long) + 2 * sizeof(double) + sizeof(m_WallStartTick);
+	size += sizeof(unsigned int);
+	size += m_Players.size() * (sizeof(Player) + sizeof(CounterRng));
+
+	return size + m_Bullets.getMaxStateSize();
+}
+
+size_t Simulation::getMemoryUsage() const
+{
+	size_t usage = m_Players.capacity() * sizeof(Player*) + m_Players.size() * sizeof(Player);
+	usage += m_Barriers.capacity() * sizeof(Barrier);
+
+	usage += m_CollisionCandidates.capacity() * sizeof(unsigned int);
+
+	return usage + m_Bullets.getMemoryUsage() + m_BarrierGrid.getMemoryUsage() + m_BulletGrid.getMemoryUsage();
+}
+
+void Simulation::saveSnapshot(SimSnapshot& snapshot) const
+{
+	std::vector<unsigned char>& buffer = snapshot.getBuffer();
+	buffer.clear();
+
+	saveState(buffer);
+}
+
+bool Simulation::restoreSnapshot(const SimSnapshot& snapshot)
+{
+	return loadState(snapshot.getData(), snapshot.getSize());
+}
+
+
+// FNV-1a over raw bytes
+static void hashBytes(unsigned int& hash, const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*) data;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+}
+
+unsigned int Simulation::getChecksum() const
+{
+	unsigned int hash = 2166136261u;
+
+	for (const Player* player : m_Players)
+	{
+		double direction = player->getDirection();
+		double velocity = player->getVelocity();
+		int lifeLeft = player->getLifeLeft();
+		const Rect& rect = player->getRect();
+
+		hashBytes(hash, &direction, sizeof(direction));
+		hashBytes(hash, &velocity, sizeof(velocity));
+		hashBytes(hash, &lifeLeft, sizeof(lifeLeft));
+		hashBytes(hash, &rect, sizeof(rect));
+	}
+
+	unsigned int bulletCount = m_Bullets.size();
+	hashBytes(hash, &bulletCount, sizeof(bulletCount));
+
+	for (unsigned int i = 0; i < m_Bullets.size(); i++)
+	{
+		Rect rect = m_Bullets.getRect(i);
+		hashBytes(hash, &rect, sizeof(rect));
+	}
+
+	hashBytes(hash, &m_WallScale, sizeof(m_WallScale));
+
+	return hash;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vector>
+
+#include "PlayerInput.h"
+#include "BarrierGrid.h"
+#include "SpatialGrid.h"
+#include "SimClock.h"
+#include "SimSnapshot.h"
+#include "entities/Player.h"
+#include "entities/BulletPool.h"
+#include "entities/Barrier.h"
+#include "utils/CounterRng.h"
+
+
+// Gameplay rules and state, with no dependency on a window or renderer
+class Simulation
+{
+private:
+	std::vector<Player*> m_Players;
+	BulletPool m_Bullets;
+	std::vector<Barrier> m_Barriers;
+
+	// Broadphase lookups: barriers are bucketed once, bullets every step
+	BarrierGrid m_BarrierGrid;
+	SpatialGrid m_BulletGrid;
+	// Bullets near the player being checked, in pool order (reserved for the whole pool)
+	std::vector<unsigned int> m_CollisionCandidates;
+
+	// Every gameplay timer counts these ticks
+	SimClock m_Clock;
+	// Seed of the match, and a stream of it for each player's bullet spread (owned rather than
+	// global, so several simulations can run side by side)
+	unsigned int m_Seed = 0;
+	std::vector<CounterRng> m_PlayerRngs;
+
+	// Scale of the combat area (1 is the full screen height)
+	double m_WallScale = 1.0;
+	double m_PreviousWallScale = 1.0;
+	// Tick the wall started closing in on
+	unsigned long long m_WallStartTick = 0;
+
+private:
+	// Applies one player's input before it moves
+	void applyInput(unsigned int playerIndex, const PlayerInput& input);
+	// Checks for collisions between players and bullets
+	void updateCollisions();
+	// Hits a player with a bullet if they overlap, returns whether it did
+	bool collideBullet(Player& player, unsigned int playerIndex, unsigned int bulletIndex);
+	// Restarts every player's random stream from the seed
+	void resetRandomStreams();
+
+public:
+	explicit Simulation(unsigned int bulletCapacity = BULLET_POOL_CAPACITY, unsigned int tickRate = SIM_TICK_RATE);
+	~Simulation();
+
+	Simulation(const Simulation&) = delete;
+	Simulation& operator=(const Simulation&) = delete;
+
+	// Creates the players for a new game
+	void initPlayers(unsigned int numberOfPlayers);
+	// Restarts the random sequence (replays and online peers share a seed to stay in step)
+	void seed(unsigned int seed);
+
+	// Advances the world by one tick of the clock (one input per player)
+	void step(const std::vector<PlayerInput>& inputs);
+
+	// Resets the players (points are kept unless completeReset)
+	void resetPlayers(bool completeReset = false);
+	// Opens the wall back out
+	void resetWall();
+	// Closes the wall in as far as it goes, as if the round had run long (benchmark scenes)
+	void closeWall();
+
+	// Whether at most one player is left alive
+	bool isRoundOver() const;
+	// Gives the last player standing a point, returns their index (-1 if no-one survived)
+	int awardRound();
+
+	// Appends everything step() depends on, including the random sequence, to a snapshot
+	// (barriers are left out, as they never change)
+	void saveState(std::vector<unsigned char>& out) const;
+	// Restores a snapshot taken with the same number of players, returns false if it doesn't fit
+	bool loadState(const unsigned char* data, size_t size);
+	// Most bytes saveState() can write for the current players
+	size_t getMaxStateSize() const;
+
+	// Overwrites a snapshot with the current state (no allocation once it has getMaxStateSize() capacity)
+	void saveSnapshot(SimSnapshot& snapshot) const;
+	// Puts the world back as it was when the snapshot was saved
+	bool restoreSnapshot(const SimSnapshot& snapshot);
+
+	// Bytes allocated on the heap (add sizeof(Simulation) for the whole footprint)
+	size_t getMemoryUsage() const;
+
+	// Hash of the players, bullets and wall, to check two runs stayed in step
+	unsigned int getChecksum() const;
+
+	std::vector<Player*>& getPlayers() { return m_Players; }
+	const std::vector<Player*>& getPlayers() const { return m_Players; }
+	BulletPool& getBullets() { return m_Bullets; }
+	const BulletPool& getBullets() const { return m_Bullets; }
+	const std::vector<Barrier>& getBarriers() const { return m_Barriers; }
+	const BarrierGrid& getBarrierGrid() const { return m_BarrierGrid; }
+	const SimClock& getClock() const { return m_Clock; }
+	double getWallScale() const { return m_WallScale; }
+	// Wall scale blended between the last two steps (alpha from 0 to 1)
+	double getInterpolatedWallScale(double alpha) const { return m_PreviousWallScale + (m_WallScale - m_PreviousWallScale) * alpha; }
+};
@@ -0,0 +1,96 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+
+
+SpatialGrid::SpatialGrid(int width, int height, int cellSize, unsigned int expectedEntries)
+	: m_CellSize(cellSize),
+	m_Columns((width + cellSize - 1) / cellSize),
+	m_Rows((height + cellSize - 1) / cellSize)
+{
+	m_EntryCells.reserve(expectedEntries);
+	m_EntryItems.reserve(expectedEntries);
+	m_Items.reserve(expectedEntries);
+	m_CellStart.assign(m_Columns * m_Rows + 1, 0);
+}
+
+
+void SpatialGrid::clear()
+{
+	m_EntryCells.clear();
+	m_EntryItems.clear();
+}
+
+void SpatialGrid::insert(unsigned int item, const Rect& rect)
+{
+	int firstColumn = getColumn(rect.x);
+	int lastColumn = getColumn(rect.x + rect.w - 1);
+	int firstRow = getRow(rect.y);
+	int lastRow = getRow(rect.y + rect.h - 1);
+
+	for (int row = firstRow; row <= lastRow; row++)
+	{
+		for (int column = firstColumn; column <= lastColumn; column++)
+		{
+			m_EntryCells.push_back(row * m_Columns + column);
+			m_EntryItems.push_back(item);
+		}
+	}
+}
+
+void SpatialGrid::insertPoint(unsigned int item, int x, int y)
+{
+	m_EntryCells.push_back(getRow(y) * m_Columns + getColumn(x));
+	m_EntryItems.push_back(item);
+}
+
+void SpatialGrid::build()
+{
+	// Counting sort: count per cell, prefix sum into start offsets, then place
+	std::fill(m_CellStart.begin(), m_CellStart.end(), 0);
+
+	for (unsigned int cell : m_EntryCells)
+	{
+		m_CellStart[cell + 1] += 1;
+	}
+
+	for (unsigned int cell = 1; cell < m_CellStart.size(); cell++)
+	{
+		m_CellStart[cell] += m_CellStart[cell - 1];
+	}
+
+	m_Items.resize(m_EntryItems.size());
+
+	// Fills each cell from the back, using its end offset as a cursor
+	for (unsigned int i = (unsigned int) m_EntryCells.size(); i > 0; i--)
+	{
+		unsigned int cell = m_EntryCells[i - 1];
+		m_Items[m_CellStart[cell + 1] - 1] = m_EntryItems[i - 1];
+		m_CellStart[cell + 1] -= 1;
+	}
+
+	// Each cursor now sits at the start of its cell, one slot along from where it belongs
+	for (unsigned int cell = 0; cell + 1 < m_CellStart.size(); cell++)
+	{
+		m_CellStart[cell] = m_CellStart[cell + 1];
+	}
+
+	m_CellStart.back() = (unsigned int) m_Items.size();
+}
+
+int SpatialGrid::getColumn(int x) const
+{
+	int column = x < 0 ? 0 : x / m_CellSize;
+	return column < m_Columns ? column : m_Columns - 1;
+}
+
+int SpatialGrid::getRow(int y) const
+{
+	int row = y < 0 ? 0 : y / m_CellSize;
+	return row < m_Rows ? row : m_Rows - 1;
+}
+
+size_t SpatialGrid::getMemoryUsage() const
+{
+	return (m_EntryCells.capacity() + m_EntryItems.capacity() + m_CellStart.capacity() + m_Items.capacity()) * sizeof(unsigned int);
+}
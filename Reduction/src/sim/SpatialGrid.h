@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "utils/Rect.h"
+
+
+// Uniform grid that buckets item indices by the cells they cover.
+// Anything outside the grid is clamped into the edge cells.
+class SpatialGrid
+{
+private:
+	int m_CellSize;
+	int m_Columns;
+	int m_Rows;
+
+	// Entries added since the last clear(), as (cell, item) pairs
+	std::vector<unsigned int> m_EntryCells;
+	std::vector<unsigned int> m_EntryItems;
+
+	// After build(), items sorted by cell: cell c owns m_Items[m_CellStart[c]] to m_Items[m_CellStart[c + 1]]
+	std::vector<unsigned int> m_CellStart;
+	std::vector<unsigned int> m_Items;
+
+private:
+	int getColumn(int x) const;
+	int getRow(int y) const;
+
+public:
+	// expectedEntries is reserved up front so steady-state rebuilds don't allocate
+	SpatialGrid(int width, int height, int cellSize, unsigned int expectedEntries);
+
+	// Removes every entry
+	void clear();
+
+	// Adds an item to every cell the rect overlaps
+	void insert(unsigned int item, const Rect& rect);
+	// Adds an item to the single cell containing a point
+	void insertPoint(unsigned int item, int x, int y);
+
+	// Sorts the entries into cells, must be called before querying
+	void build();
+
+	// Bytes allocated on the heap
+	size_t getMemoryUsage() const;
+
+	// Calls callback(item) for every entry in the cells the rect overlaps.
+	// Items inserted as rects can be reported more than once.
+	template<typename Callback>
+	void query(const Rect& rect, Callback&& callback) const
+	{
+		int firstColumn = getColumn(rect.x);
+		int lastColumn = getColumn(rect.x + rect.w - 1);
+		int firstRow = getRow(rect.y);
+		int lastRow = getRow(rect.y + rect.h - 1);
+
+		for (int row = firstRow; row <= lastRow; row++)
+		{
+			for (int column = firstColumn; column <= lastColumn; column++)
+			{
+				unsigned int cell = row * m_Columns + column;
+
+				for (unsigned int i = m_CellStart[cell]; i < m_CellStart[cell + 1]; i++)
+				{
+					callback(m_Items[i]);
+				}
+			}
+		}
+	}
+};
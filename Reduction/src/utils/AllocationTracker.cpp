@@ -0,0 +1,108 @@
+#include "AllocationTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+// Relaxed, as only the totals matter (any thread may allocate)
+static std::atomic<unsigned long long> s_Allocations { 0 };
+static std::atomic<unsigned long long> s_Bytes { 0 };
+
+// Plain data, so it needs no constructor before the thread's first allocation
+static thread_local AllocationCounts t_ThreadCounts;
+
+
+AllocationCounts AllocationTracker::getCounts()
+{
+	AllocationCounts counts;
+	counts.allocations = s_Allocations.load(std::memory_order_relaxed);
+	counts.bytes = s_Bytes.load(std::memory_order_relaxed);
+
+	return counts;
+}
+
+AllocationCounts AllocationTracker::getThreadCounts()
+{
+	return t_ThreadCounts;
+}
+
+void AllocationTracker::count(size_t size)
+{
+	s_Allocations.fetch_add(1, std::memory_order_relaxed);
+	s_Bytes.fetch_add(size, std::memory_order_relaxed);
+
+	t_ThreadCounts.allocations += 1;
+	t_ThreadCounts.bytes += size;
+}
+
+void* AllocationTracker::allocate(size_t size)
+{
+	count(size);
+
+	// malloc(0) may return null, which new must not
+	return std::malloc(size > 0 ? size : 1);
+}
+
+void AllocationTracker::release(void* pointer)
+{
+	std::free(pointer);
+}
+
+
+void* operator new(size_t size)
+{
+	void* pointer = AllocationTracker::allocate(size);
+
+	if (!pointer)
+	{
+		throw std::bad_alloc();
+	}
+
+	return pointer;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return AllocationTracker::allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return AllocationTracker::allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	AllocationTracker::release(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	AllocationTracker::release(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	AllocationTracker::release(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+	AllocationTracker::release(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	AllocationTracker::release(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	AllocationTracker::release(pointer);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+
+// Allocations made since the program (or a thread) started
+struct AllocationCounts
+{
+	unsigned long long allocations = 0;
+	unsigned long long bytes = 0;
+
+	AllocationCounts operator-(const AllocationCounts& other) const { return AllocationCounts { allocations - other.allocations, bytes - other.bytes }; }
+};
+
+
+// Counts every allocation made through the global operator new (the counting operators are
+// defined in AllocationTracker.cpp, so only programs built with it count anything), and any
+// reported from other allocators such as SDL's
+class AllocationTracker
+{
+public:
+	// Allocations by every thread, and by the calling thread alone
+	static AllocationCounts getCounts();
+	static AllocationCounts getThreadCounts();
+
+	// Counts an allocation made elsewhere
+	static void count(size_t size);
+
+	// Used by the replacement operators
+	static void* allocate(size_t size);
+	static void release(void* pointer);
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+
+// Appends the raw bytes of plain data (only for data read back by the same build and platform)
+inline void writeBytes(std::vector<unsigned char>& out, const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*) data;
+	out.insert(out.end(), bytes, bytes + size);
+}
+
+template<typename T>
+inline void writePod(std::vector<unsigned char>& out, const T& value)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be written as bytes");
+	writeBytes(out, &value, sizeof(T));
+}
+
+// Copies bytes out at offset, moving offset past them (false if the data ends first)
+inline bool readBytes(const unsigned char* data, size_t size, size_t& offset, void* out, size_t count)
+{
+	if (offset > size || count > size - offset)
+	{
+		return false;
+	}
+
+	std::memcpy(out, data + offset, count);
+	offset += count;
+
+	return true;
+}
+
+template<typename T>
+inline bool readPod(const unsigned char* data, size_t size, size_t& offset, T& value)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be read as bytes");
+	return readBytes(data, size, offset, &value, sizeof(T));
+}
+
+
+// Appends an unsigned integer as sizeof(T) little endian bytes, whatever the platform
+template<typename T>
+inline void writeFixed(std::vector<unsigned char>& out, T value)
+{
+	static_assert(std::is_unsigned<T>::value, "Fixed width fields are unsigned");
+
+	for (size_t byte = 0; byte < sizeof(T); byte++)
+	{
+		out.push_back((unsigned char) (value >> (byte * 8)));
+	}
+}
+
+template<typename T>
+inline bool readFixed(const unsigned char* data, size_t size, size_t& offset, T& value)
+{
+	static_assert(std::is_unsigned<T>::value, "Fixed width fields are unsigned");
+
+	if (offset > size || sizeof(T) > size - offset)
+	{
+		return false;
+	}
+
+	value = 0;
+
+	for (size_t byte = 0; byte < sizeof(T); byte++)
+	{
+		value |= (T) data[offset + byte] << (byte * 8);
+	}
+
+	offset += sizeof(T);
+
+	return true;
+}
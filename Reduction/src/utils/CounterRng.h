@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstddef>
+
+
+// Counter-based random numbers (Philox4x32-10). Each block of four words is a pure function of a
+// key and the block's position, so a stream can be jumped to any point, copied as a few plain
+// bytes, and split into independent streams (per match, per player) without any shared state.
+class CounterRng
+{
+	static constexpr unsigned int MULTIPLIER_0 = 0xD2511F53;
+	static constexpr unsigned int MULTIPLIER_1 = 0xCD9E8D57;
+	static constexpr unsigned int KEY_STEP_0 = 0x9E3779B9;
+	static constexpr unsigned int KEY_STEP_1 = 0xBB67AE85;
+	// Blocks generated together by the batched calls
+	static constexpr unsigned int BATCH_BLOCKS = 8;
+
+private:
+	unsigned int m_Key[2] = {};
+	// Next block to generate
+	unsigned long long m_Position = 0;
+
+	// Block being used, and how many of its words have been taken
+	unsigned int m_Block[4] = {};
+	unsigned int m_Used = 4;
+
+private:
+	static void multiply(unsigned int a, unsigned int b, unsigned int& high, unsigned int& low)
+	{
+		unsigned long long product = (unsigned long long) a * b;
+		high = (unsigned int) (product >> 32);
+		low = (unsigned int) product;
+	}
+
+	unsigned long long nextPair()
+	{
+		if (m_Used > 2)
+		{
+			generateBlock(m_Position++, m_Block);
+			m_Used = 0;
+		}
+
+		unsigned long long value = (unsigned long long) m_Block[m_Used] << 32 | m_Block[m_Used + 1];
+		m_Used += 2;
+
+		return value;
+	}
+
+public:
+	CounterRng() = default;
+	explicit CounterRng(unsigned long long seed)
+	{
+		m_Key[0] = (unsigned int) seed;
+		m_Key[1] = (unsigned int) (seed >> 32);
+	}
+
+	// The four words of a block, from its position and the key
+	static void generateBlock(unsigned long long position, const unsigned int key[2], unsigned int out[4])
+	{
+		unsigned int counter[4] = { (unsigned int) position, (unsigned int) (position >> 32), 0, 0 };
+		unsigned int key0 = key[0];
+		unsigned int key1 = key[1];
+
+		for (unsigned int round = 0; round < 10; round++)
+		{
+			unsigned int high0, low0, high1, low1;
+			multiply(MULTIPLIER_0, counter[0], high0, low0);
+			multiply(MULTIPLIER_1, counter[2], high1, low1);
+
+			counter[0] = high1 ^ counter[1] ^ key0;
+			counter[1] = low1;
+			counter[2] = high0 ^ counter[3] ^ key1;
+			counter[3] = low0;
+
+			key0 += KEY_STEP_0;
+			key1 += KEY_STEP_1;
+		}
+
+		out[0] = counter[0];
+		out[1] = counter[1];
+		out[2] = counter[2];
+		out[3] = counter[3];
+	}
+
+	// BATCH_BLOCKS consecutive blocks, worked on side by side so the rounds' multiplies overlap
+	// (and can be vectorised)
+	static void generateBlocks(unsigned long long position, const unsigned int key[2], unsigned int out[][4])
+	{
+		unsigned int counter[4][BATCH_BLOCKS];
+
+		for (unsigned int block = 0; block < BATCH_BLOCKS; block++)
+		{
+			counter[0][block] = (unsigned int) (position + block);
+			counter[1][block] = (unsigned int) ((position + block) >> 32);
+			counter[2][block] = 0;
+			counter[3][block] = 0;
+		}
+
+		unsigned int key0 = key[0];
+		unsigned int key1 = key[1];
+
+		for (unsigned int round = 0; round < 10; round++)
+		{
+			for (unsigned int block = 0; block < BATCH_BLOCKS; block++)
+			{
+				unsigned long long product0 = (unsigned long long) MULTIPLIER_0 * counter[0][block];
+				unsigned long long product1 = (unsigned long long) MULTIPLIER_1 * counter[2][block];
+
+				counter[0][block] = (unsigned int) (product1 >> 32) ^ counter[1][block] ^ key0;
+				counter[1][block] = (unsigned int) product1;
+				counter[2][block] = (unsigned int) (product0 >> 32) ^ counter[3][block] ^ key1;
+				counter[3][block] = (unsigned int) product0;
+			}
+
+			key0 += KEY_STEP_0;
+			key1 += KEY_STEP_1;
+		}
+
+		for (unsigned int block = 0; block < BATCH_BLOCKS; block++)
+		{
+			for (unsigned int word = 0; word < 4; word++)
+			{
+				out[block][word] = counter[word][block];
+			}
+		}
+	}
+
+	void generateBlock(unsigned long long position, unsigned int out[4]) const { generateBlock(position, m_Key, out); }
+
+	// Independent stream, derived from this one's key and a stream number (the same number always
+	// gives the same stream, and streams can be split again)
+	CounterRng split(unsigned long long stream) const
+	{
+		// Keys come from the top of the counter space, which no stream reaches by counting
+		unsigned int block[4];
+		generateBlock(~stream, block);
+
+		CounterRng child;
+		child.m_Key[0] = block[0];
+		child.m_Key[1] = block[1];
+
+		return child;
+	}
+
+	// 32 random bits
+	unsigned int next()
+	{
+		if (m_Used == 4)
+		{
+			generateBlock(m_Position++, m_Block);
+			m_Used = 0;
+		}
+
+		return m_Block[m_Used++];
+	}
+
+	// Uniform in [0, 1), with all 53 bits of a double's precision
+	double nextDouble() { return (double) (long long) (nextPair() >> 11) * (1.0 / 9007199254740992.0); }
+	// Uniform in [min, max)
+	double nextDouble(double min, double max) { return min + (max - min) * nextDouble(); }
+	// Uniform in [min, max]
+	int nextInt(int min, int max)
+	{
+		unsigned long long range = (unsigned long long) ((long long) max - min) + 1;
+		return (int) (min + (long long) ((next() * range) >> 32));
+	}
+
+	// Same numbers as calling nextDouble(min, max) count times, but whole blocks at a time
+	void fillDoubles(double* out, size_t count, double min, double max)
+	{
+		size_t i = 0;
+
+		// Uses up what's left of the current block first, so the sequence doesn't change
+		for (; i < count && m_Used < 4; i++)
+		{
+			out[i] = nextDouble(min, max);
+		}
+
+		double scale = (max - min) * (1.0 / 9007199254740992.0);
+		unsigned int blocks[BATCH_BLOCKS][4];
+
+		for (; i + 2 * BATCH_BLOCKS <= count; i += 2 * BATCH_BLOCKS)
+		{
+			generateBlocks(m_Position, m_Key, blocks);
+			m_Position += BATCH_BLOCKS;
+
+			for (unsigned int block = 0; block < BATCH_BLOCKS; block++)
+			{
+				out[i + block * 2] = min + (double) (long long) (((unsigned long long) blocks[block][0] << 32 | blocks[block][1]) >> 11) * scale;
+				out[i + block * 2 + 1] = min + (double) (long long) (((unsigned long long) blocks[block][2] << 32 | blocks[block][3]) >> 11) * scale;
+			}
+		}
+
+		for (; i + 2 <= count; i += 2)
+		{
+			generateBlock(m_Position++, m_Key, blocks[0]);
+
+			out[i] = min + (double) (long long) (((unsigned long long) blocks[0][0] << 32 | blocks[0][1]) >> 11) * scale;
+			out[i + 1] = min + (double) (long long) (((unsigned long long) blocks[0][2] << 32 | blocks[0][3]) >> 11) * scale;
+		}
+
+		if (i < count)
+		{
+			out[i] = nextDouble(min, max);
+		}
+	}
+
+	// Moves to a block of the stream (0 is the start)
+	void seek(unsigned long long position)
+	{
+		m_Position = position;
+		m_Used = 4;
+	}
+
+	unsigned long long getPosition() const { return m_Position; }
+};
@@ -0,0 +1,168 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "Winmm.lib")
+#else
+#include <time.h>
+#endif
+
+
+double PacingStats::getAverageFrameTime() const
+{
+	return frames > 0 ? frameTimeSum / frames : 0.0;
+}
+
+double PacingStats::getJitter() const
+{
+	if (frames == 0)
+	{
+		return 0.0;
+	}
+
+	double average = getAverageFrameTime();
+	double variance = frameTimeSquaredSum / frames - average * average;
+
+	return std::sqrt(std::max(variance, 0.0));
+}
+
+double PacingStats::getCpuPercent() const
+{
+	return wallTime > 0.0 ? cpuTime / wallTime * 100 : 0.0;
+}
+
+
+FramePacer::FramePacer(const PacingConfig& config)
+	: m_Config(config)
+{
+	double frameRate = std::max(m_Config.frameRate, 1.0);
+	m_FrameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / frameRate));
+	m_SpinTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(std::max(m_Config.spinTime, 0.0)));
+
+#ifdef _WIN32
+	// Sleeps otherwise wake on the default 15.6 ms timer tick, longer than a whole frame
+	if (m_Config.mode == PacingMode::Limited)
+	{
+		timeBeginPeriod(1);
+	}
+#endif
+
+	m_LastFrameEnd = Clock::now();
+	m_NextFrame = m_LastFrameEnd + m_FrameTime;
+	m_LastCpuTime = getProcessCpuTime();
+}
+
+FramePacer::~FramePacer()
+{
+#ifdef _WIN32
+	if (m_Config.mode == PacingMode::Limited)
+	{
+		timeEndPeriod(1);
+	}
+#endif
+}
+
+
+void FramePacer::waitUntil(Clock::time_point deadline)
+{
+	Clock::time_point wakeTime = deadline - m_SpinTime;
+
+	if (Clock::now() < wakeTime)
+	{
+		std::this_thread::sleep_until(wakeTime);
+	}
+
+	while (Clock::now() < deadline)
+	{
+		std::this_thread::yield();
+	}
+}
+
+void FramePacer::endFrame(bool isIdle)
+{
+	if (m_Config.mode == PacingMode::Limited)
+	{
+		Clock::time_point now = Clock::now();
+
+		// Frames that ran long (or waited on events) start a new schedule rather than hurrying to catch up
+		if (now > m_NextFrame + m_FrameTime)
+		{
+			m_NextFrame = now;
+		}
+
+		else
+		{
+			waitUntil(m_NextFrame);
+		}
+
+		m_NextFrame += m_FrameTime;
+	}
+
+	Clock::time_point frameEnd = Clock::now();
+	double cpuTime = getProcessCpuTime();
+
+	std::chrono::duration<double, std::milli> frameTime = frameEnd - m_LastFrameEnd;
+	PacingStats& stats = isIdle ? m_IdleStats : m_ActiveStats;
+
+	stats.frames++;
+	stats.wallTime += frameTime.count();
+	stats.cpuTime += cpuTime - m_LastCpuTime;
+	stats.frameTimeSum += frameTime.count();
+	stats.frameTimeSquaredSum += frameTime.count() * frameTime.count();
+	stats.maxFrameTime = std::max(stats.maxFrameTime, frameTime.count());
+
+	m_LastFrameEnd = frameEnd;
+	m_LastCpuTime = cpuTime;
+}
+
+
+double FramePacer::getProcessCpuTime()
+{
+#ifdef _WIN32
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+
+	if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+	{
+		return 0.0;
+	}
+
+	// Both are counts of 100 ns
+	unsigned long long kernel = ((unsigned long long) kernelTime.dwHighDateTime << 32) | kernelTime.dwLowDateTime;
+	unsigned long long user = ((unsigned long long) userTime.dwHighDateTime << 32) | userTime.dwLowDateTime;
+
+	return (kernel + user) / 10000.0;
+#else
+	timespec time;
+
+	if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time) != 0)
+	{
+		return 0.0;
+	}
+
+	return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+#endif
+}
+
+const char* FramePacer::getModeName(PacingMode mode)
+{
+	switch (mode)
+	{
+	case PacingMode::Unlimited:
+		return "unlimited";
+
+	case PacingMode::Limited:
+		return "limited";
+
+	case PacingMode::VSync:
+		return "vsync";
+	}
+
+	return "unknown";
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+
+#include "utils/Settings.h"
+
+
+// How the main loop decides when to start the next frame
+enum class PacingMode
+{
+	// Starts the next frame straight away
+	Unlimited,
+	// Waits for the target frame rate, sleeping most of the wait and spinning the rest
+	Limited,
+	// Presents wait for the display (chosen when the renderer is created)
+	VSync,
+};
+
+struct PacingConfig
+{
+	PacingMode mode = PacingMode::Limited;
+	// Frames per second in Limited mode
+	double frameRate = FRAME_RATE_LIMIT;
+	// Last part of each wait that is spun instead of slept (milliseconds), 0 only sleeps
+	// and a whole frame only spins
+	double spinTime = FRAME_PACER_SPIN_TIME;
+};
+
+// Frames of one kind and what they cost (times in milliseconds)
+struct PacingStats
+{
+	unsigned long long frames = 0;
+	// Wall clock and process CPU time the frames took, waits included
+	double wallTime = 0.0;
+	double cpuTime = 0.0;
+	// Spread of the frame lengths
+	double frameTimeSum = 0.0;
+	double frameTimeSquaredSum = 0.0;
+	double maxFrameTime = 0.0;
+
+	double getAverageFrameTime() const;
+	// Standard deviation of the frame lengths
+	double getJitter() const;
+	// Share of one core the process used while these frames ran (100 is a whole core)
+	double getCpuPercent() const;
+};
+
+
+class FramePacer
+{
+	// Monotonic, like the profiler's
+	using Clock = std::chrono::steady_clock;
+
+private:
+	PacingConfig m_Config;
+	Clock::duration m_FrameTime;
+	Clock::duration m_SpinTime;
+
+	// When the next frame is due in Limited mode
+	Clock::time_point m_NextFrame;
+
+	// End of the last frame, and the process CPU time then
+	Clock::time_point m_LastFrameEnd;
+	double m_LastCpuTime;
+
+	PacingStats m_ActiveStats;
+	PacingStats m_IdleStats;
+
+private:
+	// Sleeps until shortly before the deadline, then spins until it
+	void waitUntil(Clock::time_point deadline);
+
+public:
+	explicit FramePacer(const PacingConfig& config);
+	~FramePacer();
+
+	FramePacer(const FramePacer&) = delete;
+	FramePacer& operator=(const FramePacer&) = delete;
+
+	// Call after presenting: waits until the next frame is due (Limited mode), then counts the
+	// frame as active or idle (idle frames spent most of their time waiting on events)
+	void endFrame(bool isIdle);
+
+	const PacingConfig& getConfig() const { return m_Config; }
+	const PacingStats& getActiveStats() const { return m_ActiveStats; }
+	const PacingStats& getIdleStats() const { return m_IdleStats; }
+
+	// CPU time used by every thread of the process so far (milliseconds)
+	static double getProcessCpuTime();
+	// Name of a mode, as used in logs
+	static const char* getModeName(PacingMode mode);
+};
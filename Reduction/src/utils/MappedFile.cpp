@@ -0,0 +1,153 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path)
+{
+	close();
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	m_File = file;
+
+	LARGE_INTEGER size;
+
+	if (!GetFileSizeEx(file, &size))
+	{
+		close();
+		return false;
+	}
+
+	m_Size = (size_t) size.QuadPart;
+
+	// Empty files can't be mapped, but are still valid to open
+	if (m_Size == 0)
+	{
+		return true;
+	}
+
+	m_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (!m_Mapping)
+	{
+		close();
+		return false;
+	}
+
+	m_Data = (const unsigned char*) MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (!m_Data)
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_Data)
+	{
+		UnmapViewOfFile(m_Data);
+	}
+
+	if (m_Mapping)
+	{
+		CloseHandle(m_Mapping);
+	}
+
+	if (m_File)
+	{
+		CloseHandle(m_File);
+	}
+
+	m_Data = nullptr;
+	m_Mapping = nullptr;
+	m_File = nullptr;
+	m_Size = 0;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path)
+{
+	close();
+
+	m_File = ::open(path.c_str(), O_RDONLY);
+
+	if (m_File < 0)
+	{
+		return false;
+	}
+
+	struct stat status;
+
+	if (fstat(m_File, &status) != 0)
+	{
+		close();
+		return false;
+	}
+
+	m_Size = (size_t) status.st_size;
+
+	// Empty files can't be mapped, but are still valid to open
+	if (m_Size == 0)
+	{
+		return true;
+	}
+
+	void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_File, 0);
+
+	if (data == MAP_FAILED)
+	{
+		close();
+		return false;
+	}
+
+	m_Data = (const unsigned char*) data;
+
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_Data)
+	{
+		munmap((void*) m_Data, m_Size);
+	}
+
+	if (m_File >= 0)
+	{
+		::close(m_File);
+	}
+
+	m_Data = nullptr;
+	m_File = -1;
+	m_Size = 0;
+}
+
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+
+// Read-only view of a whole file, paged in by the OS as it is touched
+class MappedFile
+{
+private:
+	const unsigned char* m_Data = nullptr;
+	size_t m_Size = 0;
+
+#ifdef _WIN32
+	void* m_File = nullptr;
+	void* m_Mapping = nullptr;
+#else
+	int m_File = -1;
+#endif
+
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Maps a file, closing any file already mapped (false if it could not be opened)
+	bool open(const std::string& path);
+	void close();
+
+	const unsigned char* getData() const { return m_Data; }
+	size_t getSize() const { return m_Size; }
+};
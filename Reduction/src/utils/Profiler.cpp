@@ -0,0 +1,252 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "utils/Settings.h"
+#include "utils/Log.h"
+
+
+std::vector<Profiler::FrameSample> Profiler::s_Frames;
+Profiler::FrameSample Profiler::s_CurrentFrame = {};
+Profiler::Clock::time_point Profiler::s_FrameStart;
+AllocationCounts Profiler::s_FrameStartAllocations;
+thread_local bool Profiler::s_IsFrameThread = false;
+thread_local bool Profiler::s_IsSimThread = false;
+std::atomic<unsigned long long> Profiler::s_SimPhaseTime[PHASE_COUNT] = {};
+std::atomic<unsigned long long> Profiler::s_SimPhaseAllocations[PHASE_COUNT] = {};
+std::atomic<unsigned long long> Profiler::s_SimPhaseBytes[PHASE_COUNT] = {};
+std::vector<float> Profiler::s_SortScratch;
+
+
+void Profiler::init()
+{
+	s_IsFrameThread = true;
+
+	s_Frames.reserve(PROFILER_RESERVED_FRAMES);
+	s_SortScratch.reserve(PROFILER_WINDOW_FRAMES);
+}
+
+void Profiler::registerSimThread()
+{
+	s_IsSimThread = true;
+}
+
+
+void Profiler::beginFrame()
+{
+	s_CurrentFrame = {};
+	s_FrameStart = Clock::now();
+	s_FrameStartAllocations = AllocationTracker::getCounts();
+}
+
+void Profiler::endFrame()
+{
+	std::chrono::duration<double, std::milli> elapsed = Clock::now() - s_FrameStart;
+	s_CurrentFrame.total = (float) elapsed.count();
+
+	AllocationCounts allocations = AllocationTracker::getCounts() - s_FrameStartAllocations;
+	s_CurrentFrame.allocations = (unsigned int) allocations.allocations;
+	s_CurrentFrame.bytes = (unsigned int) allocations.bytes;
+
+	// Simulation thread ticks are counted in the frame they finish during
+	for (unsigned int phase = 0; phase < PHASE_COUNT; phase++)
+	{
+		s_CurrentFrame.phases[phase] += (float) (s_SimPhaseTime[phase].exchange(0, std::memory_order_relaxed) / 1e6);
+		s_CurrentFrame.phaseAllocations[phase] += (unsigned int) s_SimPhaseAllocations[phase].exchange(0, std::memory_order_relaxed);
+		s_CurrentFrame.phaseBytes[phase] += (unsigned int) s_SimPhaseBytes[phase].exchange(0, std::memory_order_relaxed);
+	}
+
+	s_Frames.push_back(s_CurrentFrame);
+}
+
+void Profiler::reserveFrames()
+{
+	if (s_Frames.capacity() - s_Frames.size() < PROFILER_RESERVED_FRAMES)
+	{
+		s_Frames.reserve(s_Frames.size() + PROFILER_RESERVED_FRAMES);
+	}
+}
+
+
+void Profiler::addTime(ProfilePhase phase, double milliseconds)
+{
+	if (s_IsSimThread)
+	{
+		s_SimPhaseTime[(unsigned int) phase].fetch_add((unsigned long long) (milliseconds * 1e6), std::memory_order_relaxed);
+		return;
+	}
+
+	if (!s_IsFrameThread)
+	{
+		return;
+	}
+
+	s_CurrentFrame.phases[(unsigned int) phase] += (float) milliseconds;
+}
+
+void Profiler::addAllocations(ProfilePhase phase, const AllocationCounts& counts)
+{
+	if (s_IsSimThread)
+	{
+		s_SimPhaseAllocations[(unsigned int) phase].fetch_add(counts.allocations, std::memory_order_relaxed);
+		s_SimPhaseBytes[(unsigned int) phase].fetch_add(counts.bytes, std::memory_order_relaxed);
+		return;
+	}
+
+	if (!s_IsFrameThread)
+	{
+		return;
+	}
+
+	s_CurrentFrame.phaseAllocations[(unsigned int) phase] += (unsigned int) counts.allocations;
+	s_CurrentFrame.phaseBytes[(unsigned int) phase] += (unsigned int) counts.bytes;
+}
+
+
+ProfileStats Profiler::calculateStats(unsigned int column)
+{
+	ProfileStats stats;
+
+	if (s_Frames.empty())
+	{
+		return stats;
+	}
+
+	// Only looks at the most recent frames
+	size_t first = s_Frames.size() > PROFILER_WINDOW_FRAMES ? s_Frames.size() - PROFILER_WINDOW_FRAMES : 0;
+	s_SortScratch.clear();
+
+	for (size_t i = first; i < s_Frames.size(); i++)
+	{
+		const FrameSample& frame = s_Frames[i];
+		float value = column < PHASE_COUNT ? frame.phases[column] : frame.total;
+
+		s_SortScratch.push_back(value);
+		stats.average += value;
+		stats.allocations += column < PHASE_COUNT ? frame.phaseAllocations[column] : frame.allocations;
+		stats.allocatedBytes += column < PHASE_COUNT ? frame.phaseBytes[column] : frame.bytes;
+	}
+
+	stats.average /= s_SortScratch.size();
+	stats.allocations /= s_SortScratch.size();
+	stats.allocatedBytes /= s_SortScratch.size();
+
+	// Nearest-rank percentile
+	size_t rank = (s_SortScratch.size() * 99 + 99) / 100 - 1;
+	std::nth_element(s_SortScratch.begin(), s_SortScratch.begin() + rank, s_SortScratch.end());
+	stats.p99 = s_SortScratch[rank];
+
+	return stats;
+}
+
+ProfileStats Profiler::getStats(ProfilePhase phase)
+{
+	return calculateStats((unsigned int) phase);
+}
+
+ProfileStats Profiler::getFrameStats()
+{
+	return calculateStats(PHASE_COUNT);
+}
+
+AllocationCounts Profiler::getLastAllocations(ProfilePhase phase)
+{
+	if (s_Frames.empty())
+	{
+		return AllocationCounts();
+	}
+
+	const FrameSample& frame = s_Frames.back();
+
+	return AllocationCounts { frame.phaseAllocations[(unsigned int) phase], frame.phaseBytes[(unsigned int) phase] };
+}
+
+AllocationCounts Profiler::getLastFrameAllocations()
+{
+	if (s_Frames.empty())
+	{
+		return AllocationCounts();
+	}
+
+	return AllocationCounts { s_Frames.back().allocations, s_Frames.back().bytes };
+}
+
+
+bool Profiler::writeCsv(const std::string& path)
+{
+	std::ofstream file(path);
+
+	if (!file)
+	{
+		error("Could not open profile CSV (filepath: ", path, ").");
+		return false;
+	}
+
+	file << "frame";
+
+	for (unsigned int phase = 0; phase < PHASE_COUNT; phase++)
+	{
+		file << ',' << getPhaseName((ProfilePhase) phase) << "_ms";
+	}
+
+	file << ",total_ms";
+
+	for (unsigned int phase = 0; phase < PHASE_COUNT; phase++)
+	{
+		file << ',' << getPhaseName((ProfilePhase) phase) << "_allocs," << getPhaseName((ProfilePhase) phase) << "_bytes";
+	}
+
+	file << ",total_allocs,total_bytes\n";
+
+	for (size_t frame = 0; frame < s_Frames.size(); frame++)
+	{
+		file << frame;
+
+		for (unsigned int phase = 0; phase < PHASE_COUNT; phase++)
+		{
+			file << ',' << s_Frames[frame].phases[phase];
+		}
+
+		file << ',' << s_Frames[frame].total;
+
+		for (unsigned int phase = 0; phase < PHASE_COUNT; phase++)
+		{
+			file << ',' << s_Frames[frame].phaseAllocations[phase] << ',' << s_Frames[frame].phaseBytes[phase];
+		}
+
+		file << ',' << s_Frames[frame].allocations << ',' << s_Frames[frame].bytes << '\n';
+	}
+
+	info("Wrote ", s_Frames.size(), " profiled frames to ", path);
+
+	return (bool) file;
+}
+
+
+const char* Profiler::getPhaseName(ProfilePhase phase)
+{
+	switch (phase)
+	{
+	case ProfilePhase::Events:
+		return "events";
+
+	case ProfilePhase::Update:
+		return "update";
+
+	case ProfilePhase::Bots:
+		return "bots";
+
+	case ProfilePhase::Collision:
+		return "collision";
+
+	case ProfilePhase::Draw:
+		return "draw";
+
+	case ProfilePhase::Present:
+		return "present";
+
+	default:
+		return "unknown";
+	}
+}
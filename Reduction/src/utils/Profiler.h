@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "utils/AllocationTracker.h"
+
+// Parts of a frame that are timed separately
+enum class ProfilePhase
+{
+	Events,
+	Update,
+	Bots,
+	Collision,
+	Draw,
+	Present,
+
+	Count,
+};
+
+// Average and 99th percentile of a phase over the recent frames (milliseconds), and its
+// average allocations a frame
+struct ProfileStats
+{
+	double average = 0.0;
+	double p99 = 0.0;
+	double allocations = 0.0;
+	double allocatedBytes = 0.0;
+};
+
+
+class Profiler
+{
+	// Monotonic, unlike the high resolution clock on some platforms
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr unsigned int PHASE_COUNT = (unsigned int) ProfilePhase::Count;
+
+	// Time spent in each phase during one frame (milliseconds), and the allocations made in it
+	// (the frame's total counts every thread, the phases only the frame and simulation threads')
+	struct FrameSample
+	{
+		float phases[PHASE_COUNT];
+		float total;
+		unsigned int phaseAllocations[PHASE_COUNT];
+		unsigned int phaseBytes[PHASE_COUNT];
+		unsigned int allocations;
+		unsigned int bytes;
+	};
+
+private:
+	// Every completed frame, in order
+	static std::vector<FrameSample> s_Frames;
+
+	// Frame currently being timed
+	static FrameSample s_CurrentFrame;
+	static Clock::time_point s_FrameStart;
+	static AllocationCounts s_FrameStartAllocations;
+
+	// Which profiled thread this is (time added from any other thread, such as a server's pool,
+	// isn't part of a frame so is left out)
+	static thread_local bool s_IsFrameThread;
+	static thread_local bool s_IsSimThread;
+
+	// Phases timed on the simulation thread since the last frame ended (nanoseconds), merged into
+	// the frame as it ends
+	static std::atomic<unsigned long long> s_SimPhaseTime[PHASE_COUNT];
+	static std::atomic<unsigned long long> s_SimPhaseAllocations[PHASE_COUNT];
+	static std::atomic<unsigned long long> s_SimPhaseBytes[PHASE_COUNT];
+
+	// Reused when sorting for percentiles
+	static std::vector<float> s_SortScratch;
+
+private:
+	// Calculates the stats of one column over the recent frames
+	static ProfileStats calculateStats(unsigned int column);
+
+public:
+	// Makes the calling thread the one that times frames (call once, before the first frame)
+	static void init();
+	// Makes the calling thread's phases count towards the frame that ends after them
+	static void registerSimThread();
+
+	// Starts timing a new frame
+	static void beginFrame();
+	// Stores the frame that was being timed
+	static void endFrame();
+	// Makes room for PROFILER_RESERVED_FRAMES more frames, so they are stored without the history
+	// growing (call somewhere a pause doesn't matter, such as the start of a round)
+	static void reserveFrames();
+
+	// Adds time to a phase of the current frame (phases can run several times a frame)
+	static void addTime(ProfilePhase phase, double milliseconds);
+	// Adds allocations to a phase of the current frame
+	static void addAllocations(ProfilePhase phase, const AllocationCounts& counts);
+
+	// Stats of a phase over the last PROFILER_WINDOW_FRAMES frames
+	static ProfileStats getStats(ProfilePhase phase);
+	// Stats of whole frames over the last PROFILER_WINDOW_FRAMES frames
+	static ProfileStats getFrameStats();
+
+	// Allocations during the last stored frame, in one phase or in the whole process
+	static AllocationCounts getLastAllocations(ProfilePhase phase);
+	static AllocationCounts getLastFrameAllocations();
+
+	// Writes one line per frame, returns false if the file could not be written
+	static bool writeCsv(const std::string& path);
+
+	// Name of a phase, as used in the overlay and CSV header
+	static const char* getPhaseName(ProfilePhase phase);
+
+	static Clock::time_point now() { return Clock::now(); }
+};
+
+
+// Adds the time and allocations until the end of the scope to a phase
+class ProfileScope
+{
+private:
+	ProfilePhase m_Phase;
+	std::chrono::steady_clock::time_point m_Start;
+	AllocationCounts m_StartAllocations;
+
+public:
+	explicit ProfileScope(ProfilePhase phase)
+		: m_Phase(phase), m_Start(Profiler::now()), m_StartAllocations(AllocationTracker::getThreadCounts())
+	{
+	}
+
+	~ProfileScope()
+	{
+		std::chrono::duration<double, std::milli> elapsed = Profiler::now() - m_Start;
+		Profiler::addTime(m_Phase, elapsed.count());
+		Profiler::addAllocations(m_Phase, AllocationTracker::getThreadCounts() - m_StartAllocations);
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+};
@@ -1,26 +1,20 @@
 #include "Random.h"
 
+#include <random>
 
-std::mt19937 Random::m_Rng;
+
+CounterRng Random::m_Rng;
 
 
 void Random::init()
 {
 	// Seeds the generator
-	m_Rng.seed(std::random_device()());
+	std::random_device device;
+	m_Rng = CounterRng((unsigned long long) device() << 32 | device());
 }
 
 
-int Random::randint(int min, int max)
-{
-	// Creates a distribution and returns a number from it
-	std::uniform_int_distribution<std::mt19937::result_type> dist(min, max);
-	return dist(m_Rng);
-}
-
-double Random::randdouble(double min, double max)
+void Random::seed(unsigned long long seed)
 {
-	// Creates a distribution and returns a number from it
-	std::uniform_real_distribution<> dist(min, max);
-	return dist(m_Rng);
+	m_Rng = CounterRng(seed);
 }
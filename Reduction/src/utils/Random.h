@@ -1,20 +1,25 @@
 #pragma once
 
-#include <random>
+#include "CounterRng.h"
 
 
 class Random
 {
 private:
 	// Random-number generator
-	static std::mt19937 m_Rng;
+	static CounterRng m_Rng;
 
 public:
 	// Initialises the random unit
 	static void init();
+	// Restarts the sequence from a known seed
+	static void seed(unsigned long long seed);
 
-	// Gets a random integer in the range [min, max)
-	static int randint(int min, int max);
+	// Gets a random integer in the range [min, max]
+	static int randint(int min, int max) { return m_Rng.nextInt(min, max); }
 	// Gets a random double in the range [min, max)
-	static double randdouble(double min, double max);
+	static double randdouble(double min, double max) { return m_Rng.nextDouble(min, max); }
+
+	// Fills an array with random doubles in the range [min, max)
+	static void fillDoubles(double* out, size_t count, double min, double max) { m_Rng.fillDoubles(out, count, min, max); }
 };
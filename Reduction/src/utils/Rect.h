@@ -0,0 +1,34 @@
+#pragma once
+
+
+// Axis-aligned rectangle, laid out the same as SDL_Rect
+struct Rect
+{
+	int x = 0;
+	int y = 0;
+	int w = 0;
+	int h = 0;
+};
+
+
+// Whether two rectangles overlap (same rules as SDL_HasIntersection)
+inline bool hasIntersection(const Rect& a, const Rect& b)
+{
+	if (a.w <= 0 || a.h <= 0 || b.w <= 0 || b.h <= 0)
+	{
+		return false;
+	}
+
+	int minX = a.x > b.x ? a.x : b.x;
+	int maxX = a.x + a.w < b.x + b.w ? a.x + a.w : b.x + b.w;
+
+	if (maxX <= minX)
+	{
+		return false;
+	}
+
+	int minY = a.y > b.y ? a.y : b.y;
+	int maxY = a.y + a.h < b.y + b.h ? a.y + a.h : b.y + b.h;
+
+	return maxY > minY;
+}
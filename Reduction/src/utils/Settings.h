@@ -3,8 +3,82 @@
 constexpr int SCREEN_WIDTH = 960;
 constexpr int SCREEN_HEIGHT = 540;
 
-constexpr double WALL_SPEED = -0.000025;
+// Simulation runs in fixed steps, independent of the frame rate
+constexpr int SIM_TICK_RATE = 120;
+constexpr double SIM_TICK_TIME = 1.0 / SIM_TICK_RATE;
+// Longest frame the simulation will catch up on (stops a stall snowballing)
+constexpr double MAX_SIM_CATCH_UP_TIME = 0.25;
+// Input changes that can wait for the simulation thread (a few frames' worth)
+constexpr unsigned int SIM_INPUT_QUEUE_SIZE = 64;
+// How late a tick on the simulation thread may start before it counts as late (milliseconds)
+constexpr double SIM_LATE_TICK_TIME = 2.0;
+// Frame rate the main loop is held to, unless vsync or no limit is asked for
+constexpr double FRAME_RATE_LIMIT = 144;
+// Last part of a frame wait spun rather than slept (milliseconds), covers how late a sleep can wake
+constexpr double FRAME_PACER_SPIN_TIME = 1.5;
+// Longest a menu waits for an event before redrawing anyway (milliseconds)
+constexpr int MENU_REDRAW_INTERVAL = 250;
+// Ticks between replay keyframes (seeking re-simulates fewer ticks than this)
+constexpr unsigned int REPLAY_KEYFRAME_INTERVAL = SIM_TICK_RATE * 5;
+// Round length the recorder makes room for when a round starts, so recording doesn't allocate
+// mid-round unless it runs longer (ticks), and the stream bytes reserved a tick
+constexpr unsigned int REPLAY_RESERVED_ROUND_TICKS = SIM_TICK_RATE * 180;
+constexpr unsigned int REPLAY_RESERVED_BYTES_PER_TICK = 2;
+// How far the arrow keys jump while watching a replay
+constexpr double REPLAY_SEEK_SECONDS = 10.0;
 
+// Online play: ticks a local input is held back before it is played (hides some latency without rollback)
+constexpr unsigned int ROLLBACK_INPUT_DELAY = 2;
+// Furthest a peer may run ahead of the inputs it has received (it waits rather than predict further)
+constexpr unsigned int ROLLBACK_MAX_TICKS = 16;
+// Ticks of inputs kept, must cover the rollback window plus inputs sent ahead by peers
+constexpr unsigned int ROLLBACK_INPUT_HISTORY = 128;
+// Most time a frame should spend re-simulating after a misprediction (milliseconds)
+constexpr double ROLLBACK_FRAME_BUDGET = 2.0;
+// Time between the end of an online or server round and the start of the next (milliseconds)
+constexpr double ONLINE_ROUND_OVER_TIME = 3000;
+
+// Dedicated server: ticks per second each hosted match plays
+constexpr unsigned int SERVER_TICK_RATE = 60;
+// Ticks between the states sent to a match's clients
+constexpr unsigned int SERVER_STATE_INTERVAL = 2;
+// Most bullets in play in a hosted match (kept small, it is most of a match's memory)
+constexpr unsigned int SERVER_BULLET_CAPACITY = 128;
+// Time without an input before a client's slot is handed back to a bot (milliseconds)
+constexpr double SERVER_CLIENT_TIMEOUT = 5000;
+// Recent states each connection keeps to delta encode against (a power of two, a client's
+// acknowledgement older than this many states gets a full state instead)
+constexpr unsigned int SNAPSHOT_HISTORY = 16;
+
+// Spectators: states between the full keyframes of a relayed match, which viewers join and recover on
+constexpr unsigned int RELAY_KEYFRAME_INTERVAL = 30;
+// States queued for a viewer the socket won't take before it is skipped ahead to the next keyframe
+constexpr unsigned int RELAY_QUEUE_PACKETS = 8;
+// States a viewer's acknowledgements may lag before it is only sent keyframes
+constexpr unsigned int RELAY_MAX_LAG = 60;
+// Time between a viewer's acknowledgements, and without one before it is dropped (milliseconds)
+constexpr double RELAY_ACK_INTERVAL = 250;
+constexpr double RELAY_VIEWER_TIMEOUT = 5000;
+
+// Change in wall scale per second
+constexpr double WALL_SPEED = -0.003;
+// Smallest the wall closes to
+constexpr double WALL_MINIMUM_SCALE = 0.3;
+
+// Distance bots try to keep from their target, and the furthest they fire from
+constexpr double BOT_PREFERRED_RANGE = 400;
+constexpr double BOT_FIRE_RANGE = 600;
+// How close to the wall bots let themselves get (plus a third of a second at their speed)
+constexpr double BOT_WALL_MARGIN = 50;
+// Angle off the intercept bots still fire at (degrees)
+constexpr double BOT_AIM_TOLERANCE = 10;
+// Most opponents a bot considers each tick, which bounds its decision time
+constexpr unsigned int BOT_MAX_TARGETS = 8;
+// Time a bot's decision is allowed to take (microseconds), ticks over it are counted
+constexpr double BOT_DECISION_BUDGET = 20;
+
+constexpr int PLAYER_WIDTH = 50;
+constexpr int PLAYER_HEIGHT = 32;
 constexpr double PLAYER_ROTATION_SPEED = 250;
 constexpr double MAX_PLAYER_SPEED = 400;
 constexpr double PLAYER_ACCELERATION = 200;
@@ -22,10 +96,14 @@ constexpr double GREY_PLAYER_START_X = SCREEN_WIDTH / 2;
 constexpr double GREY_PLAYER_START_Y = SCREEN_HEIGHT - 40;
 constexpr double GREY_PLAYER_START_DIRECTION = 180;
 
+constexpr int BULLET_WIDTH = 6;
+constexpr int BULLET_HEIGHT = 6;
 constexpr double BULLET_SPEED = 500;
 constexpr double BULLET_COOLDOWN = 250;
 constexpr double BULLET_DIRECTION_OFFSET_MAX = 10;
 constexpr double BULLET_KNOCKBACK = 10;
+// Most bullets in play at once (shared by all players)
+constexpr unsigned int BULLET_POOL_CAPACITY = 1024;
 
 constexpr unsigned int LIFE_BAR_FULL_WIDTH = 150;
 constexpr unsigned int LIFE_BAR_HEIGHT = 15;
@@ -46,4 +124,20 @@ constexpr unsigned int LONG_GAME_POINTS_TO_WIN = 7;
 
 constexpr int BARRIER_DISTANCE_FROM_CENTER = SCREEN_HEIGHT / 6;
 constexpr int BARRIER_LENGTH = 70;
-constexpr int BARRIER_WIDTH = 15;
\ No newline at end of file
+constexpr int BARRIER_WIDTH = 15;
+
+// Side length of the cells used for collision lookups
+constexpr int COLLISION_GRID_CELL_SIZE = 64;
+// Frames the profiler's averages and percentiles cover
+constexpr unsigned int PROFILER_WINDOW_FRAMES = 240;
+// Frames of profiler history allocated up front (ten minutes at 60 fps)
+constexpr unsigned int PROFILER_RESERVED_FRAMES = 36000;
+// Frames between refreshes of the profiler overlay text
+constexpr unsigned int PROFILER_OVERLAY_REFRESH_FRAMES = 30;
+
+// Gameplay frames at the start of a round that may allocate before --assert-no-alloc checks them
+// (sprites, glyphs and the simulation thread's buffers settle in these)
+constexpr unsigned int ALLOCATION_CHECK_GRACE_FRAMES = 30;
+
+// Side length of each font atlas texture
+constexpr int FONT_ATLAS_PAGE_SIZE = 512;
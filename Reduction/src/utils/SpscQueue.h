@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+
+
+// Fixed-size queue from one producer thread to one consumer thread, without locks
+template<typename T, unsigned int CAPACITY>
+class SpscQueue
+{
+	static_assert((CAPACITY & (CAPACITY - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+private:
+	T m_Items[CAPACITY];
+
+	// Next item to read (written by the consumer) and to write (written by the producer), on
+	// separate cache lines so the two sides don't fight over one
+	alignas(64) std::atomic<unsigned int> m_Head { 0 };
+	alignas(64) std::atomic<unsigned int> m_Tail { 0 };
+
+public:
+	// Producer: adds an item, returns false if the queue is full
+	bool push(const T& item)
+	{
+		unsigned int tail = m_Tail.load(std::memory_order_relaxed);
+
+		if (tail - m_Head.load(std::memory_order_acquire) == CAPACITY)
+		{
+			return false;
+		}
+
+		m_Items[tail % CAPACITY] = item;
+		m_Tail.store(tail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	// Consumer: takes the oldest item, returns false if the queue is empty
+	bool pop(T& item)
+	{
+		unsigned int head = m_Head.load(std::memory_order_relaxed);
+
+		if (head == m_Tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		item = m_Items[head % CAPACITY];
+		m_Head.store(head + 1, std::memory_order_release);
+
+		return true;
+	}
+};
@@ -0,0 +1,98 @@
+#include "ThreadPool.h"
+
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+	if (threadCount == 0)
+	{
+		threadCount = std::thread::hardware_concurrency();
+	}
+
+	// The calling thread is thread 0
+	for (unsigned int i = 1; i < threadCount; i++)
+	{
+		m_Threads.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stopping = true;
+	}
+
+	m_BatchStarted.notify_all();
+
+	for (std::thread& thread : m_Threads)
+	{
+		thread.join();
+	}
+}
+
+
+void ThreadPool::workerLoop(unsigned int threadIndex)
+{
+	unsigned long long generation = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_BatchStarted.wait(lock, [&] { return m_Stopping || m_Generation != generation; });
+
+			if (m_Stopping)
+			{
+				return;
+			}
+
+			generation = m_Generation;
+		}
+
+		runTasks(threadIndex);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_WorkersBusy -= 1;
+		}
+
+		m_BatchFinished.notify_one();
+	}
+}
+
+void ThreadPool::runTasks(unsigned int threadIndex)
+{
+	unsigned int index;
+
+	while ((index = m_NextIndex.fetch_add(1, std::memory_order_relaxed)) < m_Count)
+	{
+		m_Task(m_Context, index, threadIndex);
+	}
+}
+
+void ThreadPool::run(unsigned int count, TaskFunction task, void* context)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		m_Task = task;
+		m_Context = context;
+		m_Count = count;
+		m_NextIndex.store(0, std::memory_order_relaxed);
+		m_WorkersBusy = (unsigned int) m_Threads.size();
+		m_Generation += 1;
+	}
+
+	m_BatchStarted.notify_all();
+
+	runTasks(0);
+
+	// Workers still finishing their last task hold on to the context, so it must outlive them
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_BatchFinished.wait(lock, [&] { return m_WorkersBusy == 0; });
+}
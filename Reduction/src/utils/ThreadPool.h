@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Fixed set of threads that run one batch of indexed tasks at a time
+class ThreadPool
+{
+	using TaskFunction = void (*)(void* context, unsigned int index, unsigned int threadIndex);
+
+private:
+	std::vector<std::thread> m_Threads;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_BatchStarted;
+	std::condition_variable m_BatchFinished;
+
+	// Current batch (bumping the generation wakes the workers)
+	unsigned long long m_Generation = 0;
+	TaskFunction m_Task = nullptr;
+	void* m_Context = nullptr;
+	unsigned int m_Count = 0;
+	std::atomic<unsigned int> m_NextIndex { 0 };
+	unsigned int m_WorkersBusy = 0;
+
+	bool m_Stopping = false;
+
+private:
+	void workerLoop(unsigned int threadIndex);
+	// Takes indices until the batch runs out
+	void runTasks(unsigned int threadIndex);
+	void run(unsigned int count, TaskFunction task, void* context);
+
+public:
+	// threadCount includes the calling thread, which works on each batch too (0 uses every core)
+	explicit ThreadPool(unsigned int threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Calls task(index, threadIndex) for every index below count, returning once all are done.
+	// threadIndex is below getThreadCount(), so tasks can keep per-thread data without locking.
+	template<typename Task>
+	void parallelFor(unsigned int count, Task&& task)
+	{
+		run(count, [](void* context, unsigned int index, unsigned int threadIndex)
+		{
+			(*(Task*) context)(index, threadIndex);
+		}, (void*) &task);
+	}
+
+	unsigned int getThreadCount() const { return (unsigned int) m_Threads.size() + 1; }
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+
+
+// Hands values from one writer thread to one reader thread without locks. The writer fills the
+// back buffer and publishes it; the reader takes the newest published buffer whenever it likes.
+// Neither ever waits for the other, and a value is never changed while the reader holds it.
+template<typename T>
+class TripleBuffer
+{
+	static constexpr unsigned int INDEX_MASK = 3;
+	// Set on the middle index when it holds a value the reader hasn't taken yet
+	static constexpr unsigned int FRESH_BIT = 4;
+
+private:
+	T m_Buffers[3];
+
+	// Buffer passed between the two sides
+	std::atomic<unsigned int> m_Middle { 1 };
+	// Only touched by the writer and the reader respectively
+	unsigned int m_Back = 0;
+	unsigned int m_Front = 2;
+
+public:
+	// Writer: buffer to fill before publishing (holds whatever was in it last time it was used)
+	T& getBack() { return m_Buffers[m_Back]; }
+
+	// Writer: makes the back buffer the newest value, taking the middle one to fill next
+	void publish()
+	{
+		m_Back = m_Middle.exchange(m_Back | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	// Reader: takes the newest value if one was published since the last call, returns whether it did
+	bool update()
+	{
+		if ((m_Middle.load(std::memory_order_relaxed) & FRESH_BIT) == 0)
+		{
+			return false;
+		}
+
+		m_Front = m_Middle.exchange(m_Front, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+
+	// Reader: the value taken by the last update()
+	const T& getFront() const { return m_Buffers[m_Front]; }
+
+	// Any buffer, for setting all three up before the threads start
+	T& getBuffer(unsigned int index) { return m_Buffers[index]; }
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+
+// LEB128 style variable length integers: 7 bits a byte, high bit set on all but the last
+inline void writeVarint(std::vector<unsigned char>& out, unsigned long long value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back((unsigned char) (value | 0x80));
+		value >>= 7;
+	}
+
+	out.push_back((unsigned char) value);
+}
+
+// Reads a varint at offset, moving offset past it (false if the data ends first)
+inline bool readVarint(const unsigned char* data, size_t size, size_t& offset, unsigned long long& value)
+{
+	value = 0;
+
+	for (unsigned int shift = 0; shift < 64; shift += 7)
+	{
+		if (offset >= size)
+		{
+			return false;
+		}
+
+		unsigned char byte = data[offset++];
+		value |= (unsigned long long) (byte & 0x7F) << shift;
+
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Maps signed values to unsigned so small magnitudes stay small (0, -1, 1, -2 -> 0, 1, 2, 3)
+inline unsigned long long zigzagEncode(long long value)
+{
+	return ((unsigned long long) value << 1) ^ (unsigned long long) (value >> 63);
+}
+
+inline long long zigzagDecode(unsigned long long value)
+{
+	return (long long) (value >> 1) ^ -(long long) (value & 1);
+}
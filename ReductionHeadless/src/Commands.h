@@ -0,0 +1,49 @@
+#pragma once
+
+
+// Each command takes the arguments that follow its name and returns the exit code
+
+// Runs scripted matches as fast as possible
+int runSimulate(int argc, char* argv[]);
+
+// Plays bot matches between every pair of powerup loadouts across all cores, writing win rates to a CSV
+int runBalance(int argc, char* argv[]);
+
+// Plays a recorded match back as fast as possible
+int runReplay(int argc, char* argv[]);
+
+// Seeks to random ticks of a replay, checking each against playing it straight through
+int runReplaySeek(int argc, char* argv[]);
+
+// Plays an online match between peers on localhost through a latency and loss emulator
+int runNetplay(int argc, char* argv[]);
+
+// Checks gameplay rules that must hold however the simulation is run (tick rate, broadphase)
+int runRuleChecks(int argc, char* argv[]);
+
+// Times the bullet update against the old per-object version
+int runBulletBenchmark(int argc, char* argv[]);
+
+// Times saving and restoring the simulation, checking a restore brings back the same world
+int runSnapshotBenchmark(int argc, char* argv[]);
+
+// Times random numbers from the counter-based generator against the old global one, checking its streams
+int runRandomBenchmark(int argc, char* argv[]);
+
+// Compares tick timing with steps on the render loop against a simulation thread, while frames stall
+int runSimThreadBenchmark(int argc, char* argv[]);
+
+// Plays seeded gameplay scenes for a fixed number of ticks, reporting tick times and allocations as JSON
+int runSceneBenchmark(int argc, char* argv[]);
+
+// Compares frame pacing modes by frame time jitter and CPU use
+int runPacingBenchmark(int argc, char* argv[]);
+
+// Hosts many matches at once as a dedicated server, reporting the cost of each match
+int runServer(int argc, char* argv[]);
+
+// Relays a match to thousands of spectators on localhost, reporting the relay's cost per viewer
+int runSpectate(int argc, char* argv[]);
+
+// Measures the size and cost of delta encoding the state sent to clients, at 3 and 32 players
+int runStateCodecBenchmark(int argc, char* argv[]);
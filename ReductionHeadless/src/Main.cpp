@@ -0,0 +1,57 @@
+#include <cstring>
+#include <iostream>
+
+#include "Commands.h"
+
+
+struct Command
+{
+	const char* name;
+	const char* usage;
+	int (*run)(int argc, char* argv[]);
+};
+
+static const Command s_Commands[] = {
+	{ "simulate", "simulate [matches] [players] [replay file for the first match, or -] [bots: chase or default]", runSimulate },
+	{ "balance", "balance [matches per pairing] [csv file] [threads] [seed] [points to win]", runBalance },
+	{ "replay", "replay <file> [repeats]", runReplay },
+	{ "replay-seek", "replay-seek <file> [seeks]", runReplaySeek },
+	{ "netplay", "netplay [seconds] [players] [round trip ms] [loss %] [jitter ms]", runNetplay },
+	{ "server", "server [matches] [seconds] [threads] [loopback clients] [players]", runServer },
+	{ "spectate", "spectate [viewers] [seconds] [relay threads] [slow viewers %] [stalled viewers %]", runSpectate },
+	{ "check-rules", "check-rules", runRuleChecks },
+	{ "bench-bullets", "bench-bullets [bullets] [iterations]", runBulletBenchmark },
+	{ "bench-snapshot", "bench-snapshot [iterations]", runSnapshotBenchmark },
+	{ "bench-random", "bench-random [numbers]", runRandomBenchmark },
+	{ "bench-simthread", "bench-simthread [seconds] [hiccup ms]", runSimThreadBenchmark },
+	{ "bench-scenes", "bench-scenes [ticks] [scene or all] [json file or -] [capture for drawing: 0 or 1] [bots] [bullets]", runSceneBenchmark },
+	{ "bench-pacing", "bench-pacing [seconds per mode] [fps] [work ms]", runPacingBenchmark },
+	{ "bench-state", "bench-state [states] [bullets]", runStateCodecBenchmark },
+};
+
+
+int main(int argc, char* argv[])
+{
+	// Defaults to simulating when no command is given
+	if (argc < 2)
+	{
+		return runSimulate(0, nullptr);
+	}
+
+	for (const Command& command : s_Commands)
+	{
+		if (std::strcmp(argv[1], command.name) == 0)
+		{
+			return command.run(argc - 2, argv + 2);
+		}
+	}
+
+	std::cout << "Usage: ReductionHeadless <command> [arguments]\nCommands:\n";
+
+	for (const Command& command : s_Commands)
+	{
+		std::cout << "  " << command.usage << "\n";
+	}
+
+	return 1;
+}
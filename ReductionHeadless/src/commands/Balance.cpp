@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Commands.h"
+#include "replay/ReplayFormat.h"
+#include "sim/BotRoster.h"
+#include "sim/Simulation.h"
+#include "utils/CounterRng.h"
+#include "utils/Settings.h"
+#include "utils/ThreadPool.h"
+
+
+// Every set of the four powerups, and every pairing of two sets
+constexpr unsigned int BALANCE_LOADOUTS = 16;
+constexpr unsigned int BALANCE_PAIRINGS = BALANCE_LOADOUTS * BALANCE_LOADOUTS;
+// Matches of one pairing handed out to a thread at a time
+constexpr unsigned int BALANCE_CHUNK_MATCHES = 64;
+// Longest a match may run before it is called a draw (ten simulated minutes)
+constexpr unsigned int BALANCE_MAX_STEPS = SIM_TICK_RATE * 600;
+
+
+// Totals for one pairing (the first player has the first loadout)
+struct PairingTotals
+{
+	unsigned long long matches = 0;
+	unsigned long long firstWins = 0;
+	unsigned long long secondWins = 0;
+	unsigned long long rounds = 0;
+	unsigned long long steps = 0;
+	// Life each player lost to the other's bullets and to the wall, over every round
+	unsigned long long firstHitDamage = 0;
+	unsigned long long firstWallDamage = 0;
+	unsigned long long secondHitDamage = 0;
+	unsigned long long secondWallDamage = 0;
+};
+
+// Everything one thread needs to play matches without sharing
+struct alignas(64) BalanceWorker
+{
+	Simulation simulation;
+	BotRoster bots;
+	std::vector<PlayerInput> inputs;
+	PairingTotals totals[BALANCE_PAIRINGS];
+
+	BalanceWorker()
+	{
+		simulation.initPlayers(2);
+		bots.fill(2);
+		inputs.resize(2);
+	}
+};
+
+
+// Seed of one match, from its own stream of the run's seed. Matches don't depend on which thread
+// plays them or in what order, so a run can be repeated exactly.
+static unsigned int getMatchSeed(unsigned int seed, unsigned long long match)
+{
+	return CounterRng(seed).split(match).next();
+}
+
+// Loadout as the powerup names joined by '+'
+static std::string getLoadoutName(unsigned int loadout)
+{
+	static const char* names[] = { "speed", "accuracy", "damage", "cooldown" };
+	std::string name;
+
+	for (unsigned int bit = 0; bit < 4; bit++)
+	{
+		if (loadout & (1u << bit))
+		{
+			name += name.empty() ? names[bit] : std::string("+") + names[bit];
+		}
+	}
+
+	return name.empty() ? "none" : name;
+}
+
+static void setLoadout(Player& player, unsigned int loadout)
+{
+	player.setPowerups((loadout & POWERUP_SPEED) != 0, (loadout & POWERUP_ACCURACY) != 0, (loadout & POWERUP_DAMAGE) != 0, (loadout & POWERUP_COOLDOWN) != 0);
+}
+
+// Plays rounds between two bots until one has pointsToWin, and adds the match to the pairing's totals
+static void playMatch(BalanceWorker& worker, unsigned int pairing, unsigned int seed, unsigned int pointsToWin, PairingTotals& totals)
+{
+	Simulation& simulation = worker.simulation;
+	std::vector<Player*>& players = simulation.getPlayers();
+
+	simulation.seed(seed);
+	simulation.resetPlayers(true);
+
+	unsigned int step = 0;
+	int winner = -1;
+
+	while (winner < 0 && step < BALANCE_MAX_STEPS)
+	{
+		// Loadouts are bought again every round, as powerups only last one
+		simulation.resetPlayers();
+		simulation.resetWall();
+
+		setLoadout(*players[0], pairing / BALANCE_LOADOUTS);
+		setLoadout(*players[1], pairing % BALANCE_LOADOUTS);
+
+		for (; step < BALANCE_MAX_STEPS && !simulation.isRoundOver(); step++)
+		{
+			worker.bots.decide(simulation, worker.inputs);
+			simulation.step(worker.inputs);
+		}
+
+		// Nobody scores a round that timed out or that both players died in
+		int roundWinner = step < BALANCE_MAX_STEPS ? simulation.awardRound() : -1;
+
+		if (roundWinner >= 0 && players[roundWinner]->getPoints() >= pointsToWin)
+		{
+			winner = roundWinner;
+		}
+
+		totals.rounds += 1;
+		totals.firstHitDamage += (unsigned long long) players[0]->getHitDamageTaken();
+		totals.firstWallDamage += (unsigned long long) players[0]->getWallDamageTaken();
+		totals.secondHitDamage += (unsigned long long) players[1]->getHitDamageTaken();
+		totals.secondWallDamage += (unsigned long long) players[1]->getWallDamageTaken();
+	}
+
+	// A match that timed out is a draw
+	totals.matches += 1;
+	totals.firstWins += (unsigned long long) (winner == 0);
+	totals.secondWins += (unsigned long long) (winner == 1);
+	totals.steps += step;
+}
+
+static bool writeCsv(const std::string& path, const std::vector<PairingTotals>& pairings, double tickTime)
+{
+	std::ofstream file(path);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	file << "first_loadout,second_loadout,matches,first_match_win_rate,second_match_win_rate,match_draw_rate,rounds_per_match,mean_round_seconds,"
+		"first_hit_damage_per_round,first_wall_damage_per_round,second_hit_damage_per_round,second_wall_damage_per_round\n";
+
+	for (unsigned int pairing = 0; pairing < BALANCE_PAIRINGS; pairing++)
+	{
+		const PairingTotals& totals = pairings[pairing];
+		double matches = (double) std::max(totals.matches, 1ull);
+		double rounds = (double) std::max(totals.rounds, 1ull);
+
+		file << getLoadoutName(pairing / BALANCE_LOADOUTS) << ',' << getLoadoutName(pairing % BALANCE_LOADOUTS) << ',' << totals.matches << ','
+			<< totals.firstWins / matches << ',' << totals.secondWins / matches << ','
+			<< (totals.matches - totals.firstWins - totals.secondWins) / matches << ',' << totals.rounds / matches << ',' << totals.steps * tickTime / rounds << ','
+			<< totals.firstHitDamage / rounds << ',' << totals.firstWallDamage / rounds << ','
+			<< totals.secondHitDamage / rounds << ',' << totals.secondWallDamage / rounds << '\n';
+	}
+
+	return (bool) file;
+}
+
+
+int runBalance(int argc, char* argv[])
+{
+	unsigned int matchesPerPairing = argc > 0 ? (unsigned int) std::atoi(argv[0]) : 200;
+	std::string csvPath = argc > 1 ? argv[1] : "balance.csv";
+	unsigned int threadCount = argc > 2 ? (unsigned int) std::atoi(argv[2]) : 0;
+	unsigned int seed = argc > 3 ? (unsigned int) std::strtoul(argv[3], nullptr, 10) : std::random_device()();
+	unsigned int pointsToWin = argc > 4 ? (unsigned int) std::atoi(argv[4]) : SHORT_GAME_POINTS_TO_WIN;
+
+	if (pointsToWin == 0)
+	{
+		std::cout << "Matches need at least one point to win\n";
+		return 1;
+	}
+
+	ThreadPool pool(threadCount);
+
+	std::vector<BalanceWorker*> workers;
+
+	for (unsigned int thread = 0; thread < pool.getThreadCount(); thread++)
+	{
+		workers.push_back(new BalanceWorker());
+	}
+
+	// Matches vary a lot in length, so work is handed out in small chunks as threads free up
+	// rather than split evenly up front
+	unsigned int chunksPerPairing = (matchesPerPairing + BALANCE_CHUNK_MATCHES - 1) / BALANCE_CHUNK_MATCHES;
+
+	auto start = std::chrono::steady_clock::now();
+
+	pool.parallelFor(BALANCE_PAIRINGS * chunksPerPairing, [&](unsigned int chunk, unsigned int threadIndex)
+	{
+		BalanceWorker& worker = *workers[threadIndex];
+		unsigned int pairing = chunk / chunksPerPairing;
+
+		unsigned int first = chunk % chunksPerPairing * BALANCE_CHUNK_MATCHES;
+		unsigned int last = std::min(matchesPerPairing, first + BALANCE_CHUNK_MATCHES);
+
+		for (unsigned int match = first; match < last; match++)
+		{
+			unsigned long long runMatch = (unsigned long long) pairing * matchesPerPairing + match;
+			playMatch(worker, pairing, getMatchSeed(seed, runMatch), pointsToWin, worker.totals[pairing]);
+		}
+	});
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::vector<PairingTotals> pairings(BALANCE_PAIRINGS);
+	unsigned long long totalMatches = 0;
+	unsigned long long totalRounds = 0;
+	unsigned long long totalSteps = 0;
+	BotStats botStats;
+
+	for (BalanceWorker* worker : workers)
+	{
+		for (unsigned int pairing = 0; pairing < BALANCE_PAIRINGS; pairing++)
+		{
+			const PairingTotals& from = worker->totals[pairing];
+			PairingTotals& to = pairings[pairing];
+
+			to.matches += from.matches;
+			to.firstWins += from.firstWins;
+			to.secondWins += from.secondWins;
+			to.rounds += from.rounds;
+			to.steps += from.steps;
+			to.firstHitDamage += from.firstHitDamage;
+			to.firstWallDamage += from.firstWallDamage;
+			to.secondHitDamage += from.secondHitDamage;
+			to.secondWallDamage += from.secondWallDamage;
+
+			totalMatches += from.matches;
+			totalRounds += from.rounds;
+			totalSteps += from.steps;
+		}
+
+		botStats.decisions += worker->bots.getStats().decisions;
+		botStats.totalTime += worker->bots.getStats().totalTime;
+	}
+
+	double tickTime = workers[0]->simulation.getClock().getTickTime();
+
+	for (BalanceWorker* worker : workers)
+	{
+		delete worker;
+	}
+
+	// Each loadout's match win rate against every loadout, from both sides of the map
+	double winRates[BALANCE_LOADOUTS] = {};
+
+	for (unsigned int pairing = 0; pairing < BALANCE_PAIRINGS; pairing++)
+	{
+		const PairingTotals& totals = pairings[pairing];
+		double matches = (double) std::max(totals.matches, 1ull);
+
+		winRates[pairing / BALANCE_LOADOUTS] += totals.firstWins / matches / (2 * BALANCE_LOADOUTS);
+		winRates[pairing % BALANCE_LOADOUTS] += totals.secondWins / matches / (2 * BALANCE_LOADOUTS);
+	}
+
+	unsigned int ranking[BALANCE_LOADOUTS];
+
+	for (unsigned int loadout = 0; loadout < BALANCE_LOADOUTS; loadout++)
+	{
+		ranking[loadout] = loadout;
+	}
+
+	std::sort(ranking, ranking + BALANCE_LOADOUTS, [&](unsigned int a, unsigned int b) { return winRates[a] > winRates[b]; });
+
+	std::cout << "Played " << totalMatches << " matches to " << pointsToWin << " points (" << matchesPerPairing << " for each of " << BALANCE_PAIRINGS << " pairings, seed " << seed << ") on "
+		<< pool.getThreadCount() << " threads\n";
+	std::cout << "Rounds: " << totalRounds << " (" << (double) totalRounds / std::max(totalMatches, 1ull) << " per match)\n";
+	std::cout << "Elapsed: " << elapsed.count() << " s\n";
+	std::cout << "Matches per second: " << totalMatches / elapsed.count() << ", rounds per second: " << totalRounds / elapsed.count() << "\n";
+	std::cout << "Steps per second: " << totalSteps / elapsed.count() << "\n";
+	std::cout << "Bot decisions: " << botStats.totalTime / std::max(botStats.decisions, 1ull) * 1e9 << " ns each on average\n";
+	std::cout << "Match win rate against every loadout:\n";
+
+	for (unsigned int loadout : ranking)
+	{
+		std::cout << "  " << getLoadoutName(loadout) << ": " << winRates[loadout] * 100.0 << "%\n";
+	}
+
+	if (!writeCsv(csvPath, pairings, tickTime))
+	{
+		std::cout << "Couldn't write " << csvPath << "\n";
+		return 1;
+	}
+
+	std::cout << "Wrote " << csvPath << "\n";
+
+	return 0;
+}
@@ -0,0 +1,182 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "Commands.h"
+#include "entities/BulletPool.h"
+#include "sim/Simulation.h"
+#include "utils/MathUtils.h"
+#include "utils/Random.h"
+#include "utils/Settings.h"
+
+
+// The bullet as it was before pooling: one heap object per bullet, with
+// the direction turned into a velocity on every update
+class LegacyBullet
+{
+private:
+	Rect m_Rect;
+	double m_Direction;
+	double m_PosX, m_PosY;
+
+public:
+	LegacyBullet(double direction, double posX, double posY)
+		: m_Direction(direction), m_PosX(posX), m_PosY(posY)
+	{
+		m_Rect.w = BULLET_WIDTH;
+		m_Rect.h = BULLET_HEIGHT;
+	}
+
+	bool update(double dt, const std::vector<Barrier>& barriers)
+	{
+		m_PosX += std::cos(toRadians(m_Direction)) * BULLET_SPEED * dt;
+		m_PosY += std::sin(toRadians(m_Direction)) * BULLET_SPEED * dt;
+
+		m_Rect.x = (int) m_PosX;
+		m_Rect.y = (int) m_PosY;
+
+		if (m_PosX < 0.0 || m_PosX > SCREEN_WIDTH ||
+			m_PosY < 0.0 || m_PosY > SCREEN_HEIGHT)
+		{
+			return false;
+		}
+
+		for (const Barrier& barrier : barriers)
+		{
+			if (hasIntersection(barrier.getHorizontalRect(), m_Rect) ||
+				hasIntersection(barrier.getVerticalRect(), m_Rect))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+};
+
+
+// Prints bullets updated per millisecond for a timed run
+static void report(const char* name, unsigned int bullets, unsigned int iterations, std::chrono::duration<double, std::milli> elapsed)
+{
+	std::cout << name << ": " << elapsed.count() << " ms, " << (double) bullets * iterations / elapsed.count() << " bullets/ms\n";
+}
+
+
+int runBulletBenchmark(int argc, char* argv[])
+{
+	unsigned int bullets = argc > 0 ? (unsigned int) std::atoi(argv[0]) : BULLET_POOL_CAPACITY;
+	unsigned int iterations = argc > 1 ? (unsigned int) std::atoi(argv[1]) : 20000;
+
+	Random::init();
+
+	// Uses the real barrier layout
+	Simulation simulation;
+	const std::vector<Barrier>& barriers = simulation.getBarriers();
+
+	std::vector<LegacyBullet*> legacyBullets;
+	BulletPool pool(bullets);
+
+	for (unsigned int i = 0; i < bullets; i++)
+	{
+		double direction = Random::randdouble(0.0, 360.0);
+		double posX = Random::randdouble(100.0, SCREEN_WIDTH - 100.0);
+		double posY = Random::randdouble(100.0, SCREEN_HEIGHT - 100.0);
+
+		legacyBullets.push_back(new LegacyBullet(direction, posX, posY));
+		pool.spawn(direction, posX, posY, 0, (int) PLAYER_HIT_DAMAGE);
+	}
+
+	// Steps alternate forwards and backwards so bullets stay on screen and
+	// every iteration does the same amount of work
+	unsigned int survivors = 0;
+	auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		double dt = (i % 2 == 0) ? SIM_TICK_TIME : -SIM_TICK_TIME;
+
+		for (LegacyBullet* bullet : legacyBullets)
+		{
+			survivors += (unsigned int) bullet->update(dt, barriers);
+		}
+	}
+
+	report("Per-object bullets (before)", bullets, iterations, std::chrono::steady_clock::now() - start);
+
+	start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		double dt = (i % 2 == 0) ? SIM_TICK_TIME : -SIM_TICK_TIME;
+		pool.update(dt, simulation.getBarrierGrid());
+	}
+
+	report("Bullet pool update (after)", bullets, iterations, std::chrono::steady_clock::now() - start);
+
+	start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		double dt = (i % 2 == 0) ? SIM_TICK_TIME : -SIM_TICK_TIME;
+		pool.integrate(dt);
+		pool.killOutOfBounds();
+	}
+
+	report("Bullet pool integrate kernel only", bullets, iterations, std::chrono::steady_clock::now() - start);
+
+	// Bullet against player overlap tests, every pair versus the grid
+	std::vector<Rect> playerRects;
+
+	for (unsigned int i = 0; i < 32; i++)
+	{
+		playerRects.push_back(Rect { Random::randint(0, SCREEN_WIDTH - PLAYER_WIDTH), Random::randint(0, SCREEN_HEIGHT - PLAYER_HEIGHT), PLAYER_WIDTH, PLAYER_HEIGHT });
+	}
+
+	unsigned int hits = 0;
+	unsigned int collisionIterations = iterations / 10;
+	start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < collisionIterations; i++)
+	{
+		for (const Rect& playerRect : playerRects)
+		{
+			for (unsigned int bullet = 0; bullet < pool.size(); bullet++)
+			{
+				hits += (unsigned int) hasIntersection(playerRect, pool.getRect(bullet));
+			}
+		}
+	}
+
+	report("32 player collisions, every pair", bullets, collisionIterations, std::chrono::steady_clock::now() - start);
+
+	SpatialGrid grid(SCREEN_WIDTH, SCREEN_HEIGHT, COLLISION_GRID_CELL_SIZE, bullets);
+	start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < collisionIterations; i++)
+	{
+		pool.fillGrid(grid);
+
+		for (const Rect& playerRect : playerRects)
+		{
+			Rect searchRect = { playerRect.x - BULLET_WIDTH, playerRect.y - BULLET_HEIGHT, playerRect.w + BULLET_WIDTH, playerRect.h + BULLET_HEIGHT };
+
+			grid.query(searchRect, [&](unsigned int bullet)
+			{
+				hits += (unsigned int) hasIntersection(playerRect, pool.getRect(bullet));
+			});
+		}
+	}
+
+	report("32 player collisions, grid (including rebuild)", bullets, collisionIterations, std::chrono::steady_clock::now() - start);
+
+	// Keeps the results live so the loops aren't optimised away
+	std::cout << "(" << survivors << " legacy updates survived, " << hits << " hits)\n";
+
+	for (LegacyBullet* bullet : legacyBullets)
+	{
+		delete bullet;
+	}
+
+	return 0;
+}
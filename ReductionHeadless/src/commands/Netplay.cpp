@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Commands.h"
+#include "net/RollbackSession.h"
+#include "sim/Simulation.h"
+#include "utils/Settings.h"
+
+
+// First UDP port used, each peer listens on the next one along
+constexpr unsigned short NETPLAY_BASE_PORT = 27600;
+// Longest a peer waits for the last inputs once it has played every tick
+constexpr double NETPLAY_FINISH_TIMEOUT = 5.0;
+
+
+// What one peer measured
+struct PeerResult
+{
+	bool started = false;
+	bool confirmed = false;
+	unsigned int checksum = 0;
+	unsigned int roundsWon = 0;
+
+	// Re-simulation cost of every frame that had any
+	std::vector<double> resimulationTimes;
+	unsigned int maxResimulatedTicks = 0;
+
+	unsigned long long rollbacks = 0;
+	unsigned long long resimulatedTicks = 0;
+	unsigned long long stalls = 0;
+	unsigned long long packetsSent = 0;
+	unsigned long long packetsDropped = 0;
+};
+
+
+// Mashes buttons: holds a random input for a random number of ticks, so remote predictions keep failing
+class InputMasher
+{
+private:
+	std::mt19937 m_Rng;
+	PlayerInput m_Input;
+	unsigned int m_TicksLeft = 0;
+
+public:
+	explicit InputMasher(unsigned int seed)
+		: m_Rng(seed)
+	{
+	}
+
+	const PlayerInput& next()
+	{
+		if (m_TicksLeft == 0)
+		{
+			m_Input.rotation = std::uniform_int_distribution<>(-1, 1)(m_Rng);
+			m_Input.thrust = std::uniform_int_distribution<>(-1, 1)(m_Rng);
+			m_Input.shoot = std::uniform_int_distribution<>(0, 1)(m_Rng) == 1;
+			m_TicksLeft = std::uniform_int_distribution<unsigned int>(5, 30)(m_Rng);
+		}
+
+		m_TicksLeft -= 1;
+
+		return m_Input;
+	}
+};
+
+
+// Plays one peer in real time until every peer has played ticks ticks
+static void runPeer(const RollbackConfig& config, const NetworkConditions& conditions, unsigned long long ticks, std::atomic<bool>& failed, PeerResult& result)
+{
+	Simulation simulation;
+	RollbackSession session(simulation, config);
+
+	std::vector<NetAddress> peers;
+
+	for (unsigned int player = 0; player < config.playerCount; player++)
+	{
+		peers.push_back(NetAddress::localhost((unsigned short) (NETPLAY_BASE_PORT + player)));
+	}
+
+	if (!session.start((unsigned short) (NETPLAY_BASE_PORT + config.localPlayer), peers, conditions))
+	{
+		failed = true;
+		return;
+	}
+
+	result.started = true;
+	result.resimulationTimes.reserve((size_t) ticks);
+
+	InputMasher masher(config.seed * 31 + config.localPlayer);
+
+	using Clock = std::chrono::steady_clock;
+	Clock::duration tickTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(simulation.getClock().getTickTime()));
+	Clock::time_point nextTick = Clock::now();
+
+	// Waiting for a peer doesn't use up the local input, as it would in the game
+	bool hasInput = false;
+	PlayerInput input;
+
+	while (session.getTick() < ticks && !failed)
+	{
+		std::this_thread::sleep_until(nextTick);
+		nextTick += tickTime;
+
+		if (!hasInput)
+		{
+			input = masher.next();
+			hasInput = true;
+		}
+
+		hasInput = !session.advance(input);
+
+		if (session.getLastResimulatedTicks() > 0)
+		{
+			result.resimulationTimes.push_back(session.getLastResimulationTime());
+			result.maxResimulatedTicks = std::max(result.maxResimulatedTicks, session.getLastResimulatedTicks());
+		}
+	}
+
+	// Plays nothing new, but keeps sending so the others can finish too
+	Clock::time_point finishDeadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(NETPLAY_FINISH_TIMEOUT));
+
+	while (!session.isConfirmed() && Clock::now() < finishDeadline)
+	{
+		session.poll();
+		session.correct();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	// Peers that are already done still need to hear this one's acks
+	for (unsigned int i = 0; i < 200; i++)
+	{
+		session.poll();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	result.confirmed = session.isConfirmed();
+	result.checksum = simulation.getChecksum();
+	result.roundsWon = simulation.getPlayers()[config.localPlayer]->getPoints();
+	result.rollbacks = session.getRollbacks();
+	result.resimulatedTicks = session.getResimulatedTicks();
+	result.stalls = session.getStalls();
+	result.packetsSent = session.getEmulator().getPacketsSent();
+	result.packetsDropped = session.getEmulator().getPacketsDropped();
+}
+
+
+int runNetplay(int argc, char* argv[])
+{
+	double seconds = argc > 0 ? std::atof(argv[0]) : 20.0;
+	unsigned int players = argc > 1 ? (unsigned int) std::atoi(argv[1]) : 2;
+	double roundTripTime = argc > 2 ? std::atof(argv[2]) : 150.0;
+	double lossPercent = argc > 3 ? std::atof(argv[3]) : 2.0;
+	double jitter = argc > 4 ? std::atof(argv[4]) : 10.0;
+
+	RollbackConfig config;
+	config.seed = std::random_device()();
+	config.playerCount = players;
+	// The match goes on for the whole run
+	config.pointsToWin = 1000;
+
+	NetworkConditions conditions;
+	conditions.latencyMilliseconds = std::max(roundTripTime / 2 - jitter / 2, 0.0);
+	conditions.jitterMilliseconds = jitter;
+	conditions.lossChance = lossPercent / 100;
+
+	unsigned long long ticks = (unsigned long long) (seconds * SIM_TICK_RATE);
+
+	std::cout << "Playing " << ticks << " ticks with " << players << " peers on localhost (" << roundTripTime << " ms round trip, "
+		<< jitter << " ms jitter, " << lossPercent << "% loss, " << config.inputDelay << " ticks input delay, " << config.maxRollback << " ticks max rollback)\n";
+
+	std::vector<PeerResult> results(players);
+	std::vector<std::thread> threads;
+	std::atomic<bool> failed(false);
+
+	for (unsigned int player = 0; player < players; player++)
+	{
+		RollbackConfig peerConfig = config;
+		peerConfig.localPlayer = player;
+
+		threads.emplace_back(runPeer, peerConfig, conditions, ticks, std::ref(failed), std::ref(results[player]));
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	if (failed)
+	{
+		std::cout << "A peer could not start\n";
+		return 1;
+	}
+
+	bool inStep = true;
+
+	for (unsigned int player = 0; player < players; player++)
+	{
+		PeerResult& result = results[player];
+		std::vector<double>& times = result.resimulationTimes;
+		std::sort(times.begin(), times.end());
+
+		double total = 0.0;
+
+		for (double time : times)
+		{
+			total += time;
+		}
+
+		size_t overBudget = times.end() - std::upper_bound(times.begin(), times.end(), ROLLBACK_FRAME_BUDGET);
+
+		std::cout << "Peer " << player << ": " << (result.confirmed ? "confirmed" : "UNCONFIRMED") << ", checksum " << result.checksum << ", points " << result.roundsWon << "\n";
+		std::cout << "  Rollbacks: " << result.rollbacks << ", re-simulated ticks: " << result.resimulatedTicks << " (" << (double) result.resimulatedTicks / ticks << " per frame), most in one frame: " << result.maxResimulatedTicks << "\n";
+
+		if (!times.empty())
+		{
+			std::cout << "  Re-simulation per rolled-back frame: average " << total / times.size() << " ms, p99 " << times[(size_t) (times.size() * 0.99)] << " ms, max " << times.back() << " ms, "
+				<< overBudget << " over the " << ROLLBACK_FRAME_BUDGET << " ms budget\n";
+		}
+
+		std::cout << "  Stalled frames: " << result.stalls << ", packets sent: " << result.packetsSent << ", dropped: " << result.packetsDropped << "\n";
+
+		inStep = inStep && result.confirmed && result.checksum == results[0].checksum;
+	}
+
+	std::cout << (inStep ? "Every peer ended on the same world\n" : "Peers DESYNCED\n");
+
+	return inStep ? 0 : 1;
+}
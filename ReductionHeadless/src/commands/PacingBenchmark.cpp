@@ -0,0 +1,70 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "Commands.h"
+#include "utils/FramePacer.h"
+
+
+// Stands in for a frame's update and draw by keeping the core busy
+static void doFrameWork(double milliseconds)
+{
+	using Clock = std::chrono::steady_clock;
+
+	Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(milliseconds));
+	volatile unsigned int sink = 0;
+
+	while (Clock::now() < end)
+	{
+		for (unsigned int i = 0; i < 256; i++)
+		{
+			sink = sink * 1664525u + 1013904223u;
+		}
+	}
+}
+
+static void runMode(const char* name, const PacingConfig& config, double seconds, double workMilliseconds)
+{
+	FramePacer pacer(config);
+
+	while (pacer.getActiveStats().wallTime < seconds * 1000)
+	{
+		doFrameWork(workMilliseconds);
+		pacer.endFrame(false);
+	}
+
+	const PacingStats& stats = pacer.getActiveStats();
+
+	std::cout << name << ": " << stats.frames / (stats.wallTime / 1000) << " fps, frame average " << stats.getAverageFrameTime() << " ms, jitter "
+		<< stats.getJitter() << " ms, worst " << stats.maxFrameTime << " ms, " << stats.getCpuPercent() << "% CPU\n";
+}
+
+
+int runPacingBenchmark(int argc, char* argv[])
+{
+	double seconds = argc > 0 ? std::atof(argv[0]) : 5.0;
+	double frameRate = argc > 1 ? std::atof(argv[1]) : FRAME_RATE_LIMIT;
+	double workMilliseconds = argc > 2 ? std::atof(argv[2]) : 1.0;
+
+	std::cout << "Pacing " << workMilliseconds << " ms frames at " << frameRate << " fps for " << seconds << " seconds each\n";
+
+	PacingConfig unlimited;
+	unlimited.mode = PacingMode::Unlimited;
+	runMode("Unlimited (before)", unlimited, seconds, workMilliseconds);
+
+	PacingConfig sleepOnly;
+	sleepOnly.frameRate = frameRate;
+	sleepOnly.spinTime = 0.0;
+	runMode("Sleep only", sleepOnly, seconds, workMilliseconds);
+
+	PacingConfig spinOnly;
+	spinOnly.frameRate = frameRate;
+	spinOnly.spinTime = 1000 / frameRate;
+	runMode("Spin only", spinOnly, seconds, workMilliseconds);
+
+	PacingConfig hybrid;
+	hybrid.frameRate = frameRate;
+	runMode("Sleep then spin", hybrid, seconds, workMilliseconds);
+
+	return 0;
+}
@@ -0,0 +1,151 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Commands.h"
+#include "utils/CounterRng.h"
+#include "utils/Random.h"
+
+
+// Numbers made per batched call
+constexpr unsigned int RANDOM_BATCH_SIZE = 1024;
+
+
+// Random as it was before: one global Mersenne Twister, with a new distribution made on every call
+class LegacyRandom
+{
+private:
+	std::mt19937 m_Rng;
+
+public:
+	explicit LegacyRandom(unsigned int seed)
+		: m_Rng(seed)
+	{
+	}
+
+	double randdouble(double min, double max)
+	{
+		std::uniform_real_distribution<> dist(min, max);
+		return dist(m_Rng);
+	}
+};
+
+
+// Prints the time per number of a timed run in nanoseconds (the sum keeps the work from being optimised away)
+static void report(const char* name, unsigned int count, std::chrono::duration<double, std::nano> elapsed, double sum)
+{
+	std::cout << name << ": " << elapsed.count() / count << " ns per number (mean " << sum / count << ")\n";
+}
+
+
+int runRandomBenchmark(int argc, char* argv[])
+{
+	unsigned int count = argc > 0 ? (unsigned int) std::atoi(argv[0]) : 20000000;
+	count -= count % RANDOM_BATCH_SIZE;
+
+	// Philox4x32-10 known answer for a zero key and counter
+	unsigned int key[2] = { 0, 0 };
+	unsigned int block[4];
+	CounterRng::generateBlock(0, key, block);
+
+	bool isKnownAnswer = block[0] == 0x6627E8D5 && block[1] == 0xE169C58D && block[2] == 0xBC57AC4C && block[3] == 0x9B00DBD8;
+	std::cout << "Philox4x32-10 known answer: " << (isKnownAnswer ? "matches" : "WRONG") << "\n";
+
+	// Batches, seeks and copies of a stream must all give the same numbers as drawing one at a time
+	CounterRng single(42);
+	CounterRng batched(42);
+	std::vector<double> expected(RANDOM_BATCH_SIZE + 3);
+	std::vector<double> filled(RANDOM_BATCH_SIZE + 3);
+
+	for (double& value : expected)
+	{
+		value = single.nextDouble(-10.0, 10.0);
+	}
+
+	batched.next();
+	batched.seek(0);
+	batched.fillDoubles(filled.data(), 3, -10.0, 10.0);
+	batched.fillDoubles(filled.data() + 3, RANDOM_BATCH_SIZE, -10.0, 10.0);
+
+	CounterRng firstPlayer = CounterRng(42).split(0);
+	CounterRng secondPlayer = CounterRng(42).split(1);
+	unsigned int sameWords = 0;
+
+	for (unsigned int i = 0; i < 1000; i++)
+	{
+		sameWords += (unsigned int) (firstPlayer.next() == secondPlayer.next());
+	}
+
+	std::cout << "Batched and seeked stream matches single draws: " << (filled == expected ? "yes" : "NO") << "\n";
+	std::cout << "Words shared by the first 1000 of two split streams: " << sameWords << "\n";
+
+	LegacyRandom legacy(42);
+	double sum = 0.0;
+	auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		sum += legacy.randdouble(-10.0, 10.0);
+	}
+
+	report("Random::randdouble before (mt19937, new distribution each call)", count, std::chrono::steady_clock::now() - start, sum);
+
+	std::mt19937 twister(42);
+	std::uniform_real_distribution<> distribution(-10.0, 10.0);
+	sum = 0.0;
+	start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		sum += distribution(twister);
+	}
+
+	report("mt19937 with the distribution kept", count, std::chrono::steady_clock::now() - start, sum);
+
+	Random::seed(42);
+	sum = 0.0;
+	start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		sum += Random::randdouble(-10.0, 10.0);
+	}
+
+	report("Random::randdouble now (Philox)", count, std::chrono::steady_clock::now() - start, sum);
+
+	CounterRng rng(42);
+	std::vector<double> batch(RANDOM_BATCH_SIZE);
+	sum = 0.0;
+	start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < count; i += RANDOM_BATCH_SIZE)
+	{
+		rng.fillDoubles(batch.data(), batch.size(), -10.0, 10.0);
+
+		for (double value : batch)
+		{
+			sum += value;
+		}
+	}
+
+	report("CounterRng::fillDoubles, batches of 1024", count, std::chrono::steady_clock::now() - start, sum);
+
+	// Every number drawn straight from its position, as parallel or rewound code would
+	sum = 0.0;
+	start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < count; i += 2)
+	{
+		CounterRng::generateBlock(i / 2, key, block);
+		sum += (double) (long long) (((unsigned long long) block[0] << 32 | block[1]) >> 11) * (20.0 / 9007199254740992.0) - 10.0;
+		sum += (double) (long long) (((unsigned long long) block[2] << 32 | block[3]) >> 11) * (20.0 / 9007199254740992.0) - 10.0;
+	}
+
+	report("Philox block by position", count, std::chrono::steady_clock::now() - start, sum);
+
+	std::cout << "Generator state: CounterRng " << sizeof(CounterRng) << " bytes, mt19937 " << sizeof(std::mt19937) << " bytes\n";
+
+	return 0;
+}
@@ -0,0 +1,65 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "Commands.h"
+#include "replay/ReplayPlayback.h"
+#include "sim/Simulation.h"
+
+
+int runReplay(int argc, char* argv[])
+{
+	if (argc < 1)
+	{
+		std::cout << "Usage: replay <file> [repeats]\n";
+		return 1;
+	}
+
+	const char* path = argv[0];
+	unsigned int repeats = argc > 1 ? (unsigned int) std::atoi(argv[1]) : 1;
+
+	Simulation simulation;
+	ReplayPlayback playback(simulation);
+
+	unsigned long long totalTicks = 0;
+	unsigned int desyncs = 0;
+	std::chrono::duration<double> elapsed(0);
+
+	for (unsigned int repeat = 0; repeat < repeats; repeat++)
+	{
+		// Loading is left out of the timing
+		if (!playback.open(path))
+		{
+			return 1;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+
+		while (playback.step())
+		{
+		}
+
+		elapsed += std::chrono::steady_clock::now() - start;
+		totalTicks += playback.getTicksPlayed();
+		desyncs += playback.getDesyncs();
+	}
+
+	const ReplayHeader& header = playback.getHeader();
+
+	std::cout << "Replay: " << path << " (" << header.playerCount << " players, seed " << header.seed << ", " << header.tickRate << " ticks per second)\n";
+	std::cout << "Rounds: " << playback.getRoundsPlayed() << ", ticks: " << playback.getTicksPlayed() << "\n";
+	std::cout << "Points:";
+
+	for (const Player* player : simulation.getPlayers())
+	{
+		std::cout << " " << player->getPoints();
+	}
+
+	std::cout << "\n";
+	std::cout << "Desynced rounds: " << desyncs << " over " << repeats << " playbacks\n";
+	std::cout << "Elapsed: " << elapsed.count() << " s\n";
+	std::cout << "Ticks per second: " << totalTicks / elapsed.count() << "\n";
+	std::cout << "Speed: " << totalTicks / elapsed.count() / header.tickRate << "x real time\n";
+
+	return desyncs == 0 ? 0 : 1;
+}
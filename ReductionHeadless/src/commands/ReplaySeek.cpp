@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Commands.h"
+#include "replay/ReplayPlayback.h"
+#include "sim/Simulation.h"
+
+
+int runReplaySeek(int argc, char* argv[])
+{
+	if (argc < 1)
+	{
+		std::cout << "Usage: replay-seek <file> [seeks]\n";
+		return 1;
+	}
+
+	const char* path = argv[0];
+	unsigned int seeks = argc > 1 ? (unsigned int) std::atoi(argv[1]) : 1000;
+
+	Simulation simulation;
+	ReplayPlayback playback(simulation);
+
+	if (!playback.open(path))
+	{
+		return 1;
+	}
+
+	if (!playback.canSeek())
+	{
+		std::cout << "Replay has no keyframe index (recorded before version 2?)\n";
+		return 1;
+	}
+
+	// Plays straight through once, keeping the world's checksum after every tick to compare seeks against
+	std::vector<unsigned int> checksums;
+	checksums.push_back(simulation.getChecksum());
+
+	auto linearStart = std::chrono::steady_clock::now();
+
+	while (playback.step())
+	{
+		checksums.push_back(simulation.getChecksum());
+	}
+
+	std::chrono::duration<double, std::milli> linearTime = std::chrono::steady_clock::now() - linearStart;
+
+	unsigned long long tickCount = checksums.size() - 1;
+
+	// Its own generator, as the simulation's is restored by every seek
+	std::mt19937 rng(12345);
+	std::uniform_int_distribution<unsigned long long> tickDistribution(0, tickCount);
+
+	std::vector<double> seekTimes;
+	seekTimes.reserve(seeks);
+
+	unsigned int mismatches = 0;
+
+	for (unsigned int i = 0; i < seeks; i++)
+	{
+		unsigned long long tick = tickDistribution(rng);
+
+		auto start = std::chrono::steady_clock::now();
+		bool seeked = playback.seek(tick);
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+		seekTimes.push_back(elapsed.count());
+
+		if (!seeked || playback.getTicksPlayed() != tick || simulation.getChecksum() != checksums[(size_t) tick])
+		{
+			mismatches += 1;
+		}
+	}
+
+	std::sort(seekTimes.begin(), seekTimes.end());
+
+	double total = 0.0;
+
+	for (double time : seekTimes)
+	{
+		total += time;
+	}
+
+	const ReplayHeader& header = playback.getHeader();
+
+	std::cout << "Replay: " << path << " (" << header.playerCount << " players, " << tickCount << " ticks)\n";
+	std::cout << "Playing from the start: " << linearTime.count() << " ms\n";
+	std::cout << "Seeks: " << seeks << ", mismatched: " << mismatches << "\n";
+
+	if (seeks > 0)
+	{
+		std::cout << "Seek average: " << total / seeks << " ms, p99: " << seekTimes[(size_t) (seeks * 0.99)] << " ms, max: " << seekTimes.back() << " ms\n";
+	}
+
+	return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "Commands.h"
+#include "sim/Simulation.h"
+#include "utils/Settings.h"
+
+
+// Simulated time a player is parked outside the wall for (seconds)
+constexpr double RULES_WALL_SECONDS = 10.0;
+// How far outside the wall the player is parked (pixels)
+constexpr double RULES_WALL_DISTANCE = 100.0;
+// Life lost may differ by this share between tick rates, as the drain is rounded to whole life
+// each tick and the wall moves between the ticks of one rate and the other
+constexpr double RULES_WALL_TOLERANCE = 0.01;
+// Left edge of the player hit by bullets in a line, so the area searched for bullets ends just
+// before a new grid cell
+constexpr int RULES_KNOCKBACK_PLAYER_X = COLLISION_GRID_CELL_SIZE * 4 - PLAYER_WIDTH - (int) BULLET_KNOCKBACK;
+
+
+// Parks the first player just outside the wall and returns the life it loses over the time
+static int getWallDrain(unsigned int tickRate)
+{
+	Simulation simulation(BULLET_POOL_CAPACITY, tickRate);
+	simulation.seed(1);
+	simulation.initPlayers(2);
+	simulation.resetPlayers(true);
+	simulation.resetWall();
+
+	Player& player = *simulation.getPlayers()[0];
+	player.setCenter(SCREEN_WIDTH / 2 - SCREEN_HEIGHT / 2 - RULES_WALL_DISTANCE, SCREEN_HEIGHT / 2);
+
+	// No thrust, so the player stays where it was put
+	std::vector<PlayerInput> inputs(simulation.getPlayers().size());
+	unsigned int ticks = (unsigned int) (RULES_WALL_SECONDS * tickRate);
+
+	for (unsigned int tick = 0; tick < ticks; tick++)
+	{
+		simulation.step(inputs);
+	}
+
+	return (int) PLAYER_STARTING_LIFE - player.getLifeLeft();
+}
+
+// Life drains outside the wall at the same rate per second whatever the tick rate
+static bool checkWallDrain()
+{
+	int gameDrain = getWallDrain(SIM_TICK_RATE);
+	int serverDrain = getWallDrain(SERVER_TICK_RATE);
+	bool matched = gameDrain > 0 && std::abs(gameDrain - serverDrain) <= gameDrain * RULES_WALL_TOLERANCE;
+
+	std::cout << "Wall drain over " << RULES_WALL_SECONDS << " s: " << gameDrain << " life at " << SIM_TICK_RATE << " Hz, " << serverDrain << " at "
+		<< SERVER_TICK_RATE << " Hz (" << (matched ? "matched" : "MISMATCHED") << ")\n";
+
+	return matched;
+}
+
+// Bullets in a line along a player are all hit in one step, as a full scan of the pool would hit
+// them: the first two knock the player onto the third, which starts out beyond the grid cells
+// searched around the player
+static bool checkKnockbackHits()
+{
+	Simulation simulation;
+	simulation.seed(1);
+	simulation.initPlayers(2);
+	simulation.resetPlayers(true);
+	simulation.resetWall();
+
+	Player& player = *simulation.getPlayers()[0];
+	player.setCenter(RULES_KNOCKBACK_PLAYER_X + PLAYER_WIDTH / 2, SCREEN_HEIGHT / 2);
+
+	// Where each bullet's left edge is once it has moved this step (it is pushed back by a
+	// step's flight, plus half a pixel so rounding can't move it a pixel short)
+	int playerY = (int) (SCREEN_HEIGHT / 2 - PLAYER_HEIGHT / 2);
+	int bulletXs[] = { RULES_KNOCKBACK_PLAYER_X - 2, RULES_KNOCKBACK_PLAYER_X + 12, RULES_KNOCKBACK_PLAYER_X + PLAYER_WIDTH + 2 * (int) BULLET_KNOCKBACK - 8 };
+
+	for (int bulletX : bulletXs)
+	{
+		simulation.getBullets().spawn(0.0, bulletX + 0.5 - BULLET_SPEED / SIM_TICK_RATE, playerY + PLAYER_HEIGHT / 2 - BULLET_HEIGHT / 2 + 0.5, 1, (int) PLAYER_HIT_DAMAGE);
+	}
+
+	std::vector<PlayerInput> inputs(simulation.getPlayers().size());
+	simulation.step(inputs);
+
+	unsigned int hits = (unsigned int) (player.getHitDamageTaken() / (int) PLAYER_HIT_DAMAGE);
+	bool matched = hits == 3;
+
+	std::cout << "Bullets in a line: " << hits << " of 3 hit (" << (matched ? "matched" : "MISMATCHED") << ")\n";
+
+	return matched;
+}
+
+
+int runRuleChecks(int argc, char* argv[])
+{
+	bool passed = checkWallDrain();
+	passed = checkKnockbackHits() && passed;
+
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "Commands.h"
+#include "sim/BotRoster.h"
+#include "sim/RenderState.h"
+#include "sim/Simulation.h"
+#include "utils/AllocationTracker.h"
+#include "utils/CounterRng.h"
+#include "utils/Settings.h"
+
+
+// Every scene starts from this seed, so two runs of the same build play the same ticks
+constexpr unsigned int SCENE_SEED = 1;
+// Untimed ticks before measuring, so bullets are already in the air
+constexpr unsigned int SCENE_WARMUP_TICKS = SIM_TICK_RATE;
+
+
+enum class SceneKind
+{
+	// Two players with no input, the cheapest a tick gets
+	Idle,
+	// Three players spinning on the spot with the trigger held
+	ConstantFire,
+	// Bots playing, with the bullet count topped up every tick by harmless stray bullets
+	Bots,
+	// Bots playing after the wall has closed in as far as it goes
+	WallClosed,
+};
+
+struct Scene
+{
+	const char* name;
+	SceneKind kind;
+};
+
+static const Scene s_Scenes[] = {
+	{ "idle-2", SceneKind::Idle },
+	{ "fire-3", SceneKind::ConstantFire },
+	{ "bots", SceneKind::Bots },
+	{ "wall-closed", SceneKind::WallClosed },
+};
+
+struct SceneOptions
+{
+	unsigned int ticks = 0;
+	unsigned int bots = 3;
+	unsigned int bullets = 512;
+	// Copies each step out for drawing, as the game does every frame
+	bool capture = false;
+};
+
+struct SceneResult
+{
+	const char* name;
+	unsigned int players;
+	double nanosecondsPerTick;
+	double allocationsPerTick;
+	double bytesPerTick;
+	// Tick times in nanoseconds
+	double p50, p99, p999, max;
+	double averageBullets;
+	unsigned int checksum;
+};
+
+
+static unsigned int getPlayerCount(const Scene& scene, const SceneOptions& options)
+{
+	switch (scene.kind)
+	{
+	case SceneKind::Idle:
+		return 2;
+
+	case SceneKind::Bots:
+		return options.bots;
+
+	default:
+		return 3;
+	}
+}
+
+static void startRound(const Scene& scene, Simulation& simulation)
+{
+	simulation.resetPlayers(true);
+	simulation.resetWall();
+
+	if (scene.kind == SceneKind::WallClosed)
+	{
+		simulation.closeWall();
+	}
+}
+
+// Fills in the inputs for a tick, and tops up the bullets in the bots scene
+static void prepareTick(const Scene& scene, const SceneOptions& options, Simulation& simulation, BotRoster& bots, CounterRng& rng, std::vector<PlayerInput>& inputs)
+{
+	switch (scene.kind)
+	{
+	case SceneKind::Idle:
+		break;
+
+	case SceneKind::ConstantFire:
+		for (PlayerInput& input : inputs)
+		{
+			input.rotation = 1;
+			input.shoot = true;
+		}
+
+		break;
+
+	case SceneKind::Bots:
+	{
+		bots.decide(simulation, inputs);
+
+		// Stray bullets do no damage, so the players live long enough to fly through them
+		BulletPool& bullets = simulation.getBullets();
+
+		while (bullets.size() < options.bullets)
+		{
+			double posX = rng.nextDouble() * (SCREEN_WIDTH - BULLET_WIDTH);
+			double posY = rng.nextDouble() * (SCREEN_HEIGHT - BULLET_HEIGHT);
+
+			if (!bullets.spawn(rng.nextDouble() * 360, posX, posY, (unsigned int) inputs.size(), 0))
+			{
+				break;
+			}
+		}
+
+		break;
+	}
+
+	case SceneKind::WallClosed:
+		bots.decide(simulation, inputs);
+		break;
+	}
+}
+
+static SceneResult runScene(const Scene& scene, const SceneOptions& options)
+{
+	unsigned int players = getPlayerCount(scene, options);
+
+	Simulation simulation(std::max(options.bullets, BULLET_POOL_CAPACITY));
+	simulation.seed(SCENE_SEED);
+	simulation.initPlayers(players);
+	startRound(scene, simulation);
+
+	BotRoster bots;
+	bots.fill(players);
+
+	CounterRng rng(SCENE_SEED);
+	std::vector<PlayerInput> inputs(players);
+	RenderState renderState;
+
+	std::vector<double> tickTimes;
+	tickTimes.reserve(options.ticks);
+
+	unsigned long long bulletTotal = 0;
+
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point start;
+	AllocationCounts startCounts;
+
+	for (unsigned int tick = 0; tick < SCENE_WARMUP_TICKS + options.ticks; tick++)
+	{
+		if (tick == SCENE_WARMUP_TICKS)
+		{
+			start = Clock::now();
+			startCounts = AllocationTracker::getCounts();
+		}
+
+		Clock::time_point tickStart = Clock::now();
+
+		prepareTick(scene, options, simulation, bots, rng, inputs);
+		simulation.step(inputs);
+
+		if (options.capture)
+		{
+			renderState.capture(simulation);
+		}
+
+		if (simulation.isRoundOver())
+		{
+			simulation.awardRound();
+			startRound(scene, simulation);
+		}
+
+		if (tick >= SCENE_WARMUP_TICKS)
+		{
+			std::chrono::duration<double, std::nano> tickTime = Clock::now() - tickStart;
+			tickTimes.push_back(tickTime.count());
+			bulletTotal += simulation.getBullets().size();
+		}
+	}
+
+	std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+	AllocationCounts endCounts = AllocationTracker::getCounts();
+
+	std::sort(tickTimes.begin(), tickTimes.end());
+
+	auto percentile = [&](double fraction)
+	{
+		return tickTimes[std::min((size_t) (fraction * tickTimes.size()), tickTimes.size() - 1)];
+	};
+
+	SceneResult result;
+	result.name = scene.name;
+	result.players = players;
+	result.nanosecondsPerTick = elapsed.count() / options.ticks;
+	result.allocationsPerTick = (double) (endCounts.allocations - startCounts.allocations) / options.ticks;
+	result.bytesPerTick = (double) (endCounts.bytes - startCounts.bytes) / options.ticks;
+	result.p50 = percentile(0.5);
+	result.p99 = percentile(0.99);
+	result.p999 = percentile(0.999);
+	result.max = tickTimes.back();
+	result.averageBullets = (double) bulletTotal / options.ticks;
+	result.checksum = simulation.getChecksum();
+
+	return result;
+}
+
+static void writeJson(std::ostream& out, const SceneOptions& options, const std::vector<SceneResult>& results)
+{
+	out << "{\n  \"ticks\": " << options.ticks << ",\n  \"capture\": " << (options.capture ? "true" : "false") << ",\n  \"scenes\": [\n";
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const SceneResult& result = results[i];
+
+		out << "    { \"name\": \"" << result.name << "\", \"players\": " << result.players << ", \"ns_per_tick\": " << result.nanosecondsPerTick
+			<< ", \"allocs_per_tick\": " << result.allocationsPerTick << ", \"bytes_per_tick\": " << result.bytesPerTick
+			<< ", \"p50_ns\": " << result.p50 << ", \"p99_ns\": " << result.p99 << ", \"p999_ns\": " << result.p999 << ", \"max_ns\": " << result.max
+			<< ", \"bullets\": " << result.averageBullets << ", \"checksum\": " << result.checksum << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+
+	out << "  ]\n}\n";
+}
+
+
+int runSceneBenchmark(int argc, char* argv[])
+{
+	SceneOptions options;
+	options.ticks = argc > 0 ? (unsigned int) std::atoi(argv[0]) : SIM_TICK_RATE * 60;
+	const char* sceneName = argc > 1 ? argv[1] : "all";
+	const char* jsonPath = argc > 2 ? argv[2] : "-";
+	options.capture = argc > 3 && std::atoi(argv[3]) != 0;
+	options.bots = argc > 4 ? (unsigned int) std::atoi(argv[4]) : options.bots;
+	options.bullets = argc > 5 ? (unsigned int) std::atoi(argv[5]) : options.bullets;
+
+	// The simulation seats two or three players
+	options.bots = std::min(std::max(options.bots, 2u), 3u);
+	options.ticks = std::max(options.ticks, 1u);
+
+	std::vector<SceneResult> results;
+
+	for (const Scene& scene : s_Scenes)
+	{
+		if (std::strcmp(sceneName, "all") == 0 || std::strcmp(sceneName, scene.name) == 0)
+		{
+			results.push_back(runScene(scene, options));
+		}
+	}
+
+	if (results.empty())
+	{
+		std::cout << "Unknown scene: " << sceneName << " (scenes are idle-2, fire-3, bots, wall-closed or all)\n";
+		return 1;
+	}
+
+	if (std::strcmp(jsonPath, "-") == 0)
+	{
+		writeJson(std::cout, options, results);
+		return 0;
+	}
+
+	std::ofstream file(jsonPath);
+
+	if (!file)
+	{
+		std::cout << "Could not write " << jsonPath << "\n";
+		return 1;
+	}
+
+	writeJson(file, options, results);
+
+	for (const SceneResult& result : results)
+	{
+		std::cout << result.name << ": " << result.nanosecondsPerTick << " ns a tick, " << result.allocationsPerTick << " allocations a tick, p99 "
+			<< result.p99 << " ns, p99.9 " << result.p999 << " ns\n";
+	}
+
+	return 0;
+}
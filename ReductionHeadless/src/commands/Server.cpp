@@ -0,0 +1,190 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Commands.h"
+#include "replay/ReplayFormat.h"
+#include "server/DedicatedServer.h"
+#include "net/SnapshotCodec.h"
+#include "server/ServerMessages.h"
+#include "utils/ByteIO.h"
+#include "utils/Settings.h"
+
+
+// What the loopback clients measured
+struct ClientResult
+{
+	bool started = false;
+	unsigned long long inputsSent = 0;
+	unsigned long long statesReceived = 0;
+	unsigned long long stateBytes = 0;
+	// States that couldn't be decoded (every one should be, even with packets lost)
+	unsigned long long statesRejected = 0;
+};
+
+
+// Plays slot 0 of the first few matches from localhost, mashing random inputs each tick
+static void runClients(unsigned short port, unsigned int clientCount, unsigned int matchCount, std::atomic<bool>& stop, ClientResult& result)
+{
+	std::vector<UdpSocket> sockets(clientCount);
+	std::vector<SnapshotDecoder> decoders(clientCount);
+	StateSnapshot snapshot;
+
+	for (UdpSocket& socket : sockets)
+	{
+		if (!socket.open(0))
+		{
+			return;
+		}
+	}
+
+	result.started = true;
+
+	NetAddress server = NetAddress::localhost(port);
+	std::mt19937 rng(port);
+
+	std::vector<unsigned char> message;
+	message.reserve(SERVER_INPUT_MESSAGE_SIZE);
+	std::vector<unsigned char> receiveBuffer(SERVER_MAX_STATE_SIZE);
+
+	using Clock = std::chrono::steady_clock;
+	Clock::duration tickTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / SERVER_TICK_RATE));
+	Clock::time_point nextTick = Clock::now();
+
+	for (unsigned int sequence = 1; !stop; sequence++)
+	{
+		std::this_thread::sleep_until(nextTick);
+		nextTick += tickTime;
+
+		for (unsigned int client = 0; client < clientCount; client++)
+		{
+			PlayerInput input;
+			input.rotation = std::uniform_int_distribution<>(-1, 1)(rng);
+			input.thrust = std::uniform_int_distribution<>(0, 1)(rng);
+			input.shoot = std::uniform_int_distribution<>(0, 1)(rng) == 1;
+
+			message.clear();
+			message.push_back(SERVER_INPUT_MESSAGE);
+			writeFixed(message, client % matchCount);
+			message.push_back(0);
+			writeFixed(message, sequence);
+			message.push_back((unsigned char) decoders[client].hasAck());
+			writeFixed(message, decoders[client].getAck());
+			message.push_back(packInputFlags(input));
+
+			sockets[client].send(server, message.data(), message.size());
+			result.inputsSent += 1;
+
+			NetAddress from;
+			int size;
+
+			while ((size = sockets[client].receive(receiveBuffer.data(), receiveBuffer.size(), from)) >= 0)
+			{
+				if (size < (int) SERVER_STATE_HEADER_SIZE || receiveBuffer[0] != SERVER_STATE_MESSAGE)
+				{
+					continue;
+				}
+
+				bool decoded = decoders[client].decode(receiveBuffer.data() + SERVER_STATE_HEADER_SIZE, (size_t) size - SERVER_STATE_HEADER_SIZE, snapshot);
+
+				result.statesReceived += 1;
+				result.stateBytes += (unsigned long long) size;
+				result.statesRejected += (unsigned long long) !decoded;
+			}
+		}
+	}
+}
+
+
+int runServer(int argc, char* argv[])
+{
+	ServerConfig config;
+	config.matchCount = argc > 0 ? (unsigned int) std::atoi(argv[0]) : 256;
+	double seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+	config.threadCount = argc > 2 ? (unsigned int) std::atoi(argv[2]) : 0;
+	unsigned int clientCount = argc > 3 ? (unsigned int) std::atoi(argv[3]) : 0;
+	config.playerCount = argc > 4 ? (unsigned int) std::atoi(argv[4]) : 2;
+	config.seed = std::random_device()();
+
+	if (config.matchCount == 0 || (config.playerCount != 2 && config.playerCount != 3))
+	{
+		std::cout << "Needs at least one match, of 2 or 3 players\n";
+		return 1;
+	}
+
+	DedicatedServer server(config);
+
+	if (!server.start())
+	{
+		std::cout << "Couldn't listen on UDP port " << config.port << "\n";
+		return 1;
+	}
+
+	std::atomic<bool> stop { false };
+	ClientResult clientResult;
+	std::thread clients;
+
+	if (clientCount > 0)
+	{
+		clients = std::thread(runClients, config.port, clientCount, config.matchCount, std::ref(stop), std::ref(clientResult));
+	}
+
+	unsigned long long frames = (unsigned long long) (seconds * SERVER_TICK_RATE);
+
+	for (unsigned long long frame = 0; frame < frames; frame++)
+	{
+		server.update();
+	}
+
+	unsigned int connected = 0;
+
+	for (const ServerMatch* match : server.getMatches())
+	{
+		connected += match->getConnectedClients();
+	}
+
+	stop = true;
+
+	if (clients.joinable())
+	{
+		clients.join();
+	}
+
+	ServerStats stats = server.getStats();
+	unsigned long long matchesPlayed = 0;
+
+	for (const ServerMatch* match : server.getMatches())
+	{
+		matchesPlayed += match->getMatchesPlayed();
+	}
+
+	double tickTime = stats.matchTicks > 0 ? stats.matchTickTime / stats.matchTicks : 0.0;
+
+	std::cout << "Hosted " << config.matchCount << " matches of " << config.playerCount << " players at " << SERVER_TICK_RATE << " Hz on " << server.getThreadCount() << " threads for " << seconds << " s\n";
+	std::cout << "Memory per match: " << server.getMatchMemoryUsage() << " bytes (" << server.getTotalMemoryUsage() / 1024 << " KB in total)\n";
+	std::cout << "Match tick: " << tickTime * 1e6 << " us on average (" << stats.matchTicks << " ticks)\n";
+	std::cout << "Matches per core at " << SERVER_TICK_RATE << " Hz: " << (tickTime > 0.0 ? (unsigned long long) (1.0 / (SERVER_TICK_RATE * tickTime)) : 0) << "\n";
+	std::cout << "Frame work: " << server.getFrameTimePercentile(0.5) << " ms p50, " << server.getFrameTimePercentile(0.99) << " ms p99, "
+		<< stats.overruns << " of " << stats.frames << " frames over the " << 1000.0 / SERVER_TICK_RATE << " ms budget\n";
+	std::cout << "Matches finished: " << matchesPlayed << "\n";
+
+	if (clientCount > 0)
+	{
+		if (!clientResult.started)
+		{
+			std::cout << "Couldn't open the client sockets\n";
+			return 1;
+		}
+
+		std::cout << "Clients: " << connected << " of " << clientCount << " connected, " << clientResult.inputsSent << " inputs sent, "
+			<< stats.packetsReceived << " received (" << stats.packetsRefused << " refused), " << clientResult.statesReceived << " states received, "
+			<< (clientResult.statesReceived > 0 ? clientResult.stateBytes / clientResult.statesReceived : 0) << " bytes each on average, "
+			<< clientResult.statesRejected << " couldn't be decoded\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "Commands.h"
+#include "replay/ReplayRecorder.h"
+#include "sim/BotRoster.h"
+#include "sim/SimThread.h"
+#include "sim/Simulation.h"
+#include "utils/Settings.h"
+
+
+// Frames drawn a second by the stand-in render loop, and how often one of them stalls
+constexpr double SIM_THREAD_BENCH_FRAME_RATE = 60.0;
+constexpr unsigned int SIM_THREAD_BENCH_HICCUP_EVERY = 20;
+
+
+// Waits out a frame, and every so often much longer, like a slow present or texture upload
+static void renderFrame(unsigned int frame, double hiccupMilliseconds)
+{
+	double frameMilliseconds = 1000.0 / SIM_THREAD_BENCH_FRAME_RATE;
+
+	if (frame % SIM_THREAD_BENCH_HICCUP_EVERY == SIM_THREAD_BENCH_HICCUP_EVERY - 1)
+	{
+		frameMilliseconds += hiccupMilliseconds;
+	}
+
+	std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(frameMilliseconds));
+}
+
+static void startRound(Simulation& simulation)
+{
+	simulation.resetPlayers(true);
+	simulation.resetWall();
+}
+
+static void report(const char* name, const SimThreadStats& stats, double seconds)
+{
+	std::cout << name << ": " << stats.ticks / seconds << " ticks a second, " << stats.lateTicks << " of " << stats.ticks << " started over "
+		<< SIM_LATE_TICK_TIME << " ms late, lateness average " << stats.totalLateness / std::max(stats.ticks, 1ull) << " ms, worst " << stats.maxLateness << " ms\n";
+}
+
+
+int runSimThreadBenchmark(int argc, char* argv[])
+{
+	double seconds = argc > 0 ? std::atof(argv[0]) : 10.0;
+	double hiccupMilliseconds = argc > 1 ? std::atof(argv[1]) : 50.0;
+
+	using Clock = std::chrono::steady_clock;
+
+	Simulation simulation;
+	simulation.seed(1);
+	simulation.initPlayers(3);
+
+	BotRoster bots;
+	bots.fill(3);
+
+	ReplayRecorder recorder;
+	std::vector<PlayerInput> inputs(3);
+
+	double tickTime = simulation.getClock().getTickTime();
+	Clock::duration tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(tickTime));
+
+	// Before: steps run on the render loop, catching up after each frame as Game used to
+	SimThreadStats serial;
+	startRound(simulation);
+
+	Clock::time_point start = Clock::now();
+	Clock::time_point nextTick = start;
+	unsigned int frame = 0;
+
+	while (Clock::now() - start < std::chrono::duration<double>(seconds))
+	{
+		renderFrame(frame++, hiccupMilliseconds);
+
+		Clock::time_point now = Clock::now();
+
+		for (; nextTick <= now; nextTick += tickDuration)
+		{
+			std::chrono::duration<double, std::milli> lateness = now - nextTick;
+
+			serial.ticks += 1;
+			serial.lateTicks += (unsigned long long) (lateness.count() > SIM_LATE_TICK_TIME);
+			serial.totalLateness += lateness.count();
+			serial.maxLateness = std::max(serial.maxLateness, lateness.count());
+
+			bots.decide(simulation, inputs);
+			simulation.step(inputs);
+
+			if (simulation.isRoundOver())
+			{
+				startRound(simulation);
+			}
+		}
+	}
+
+	report("Render loop steps (before)", serial, seconds);
+
+	// After: the same frames, with the steps on their own thread
+	SimThread simThread(simulation, bots, recorder);
+	SimThreadStats threaded;
+	unsigned long long staleFrames = 0;
+	unsigned long long lastTick = 0;
+
+	startRound(simulation);
+	simThread.start(3);
+
+	start = Clock::now();
+	frame = 0;
+
+	while (Clock::now() - start < std::chrono::duration<double>(seconds))
+	{
+		renderFrame(frame++, hiccupMilliseconds);
+
+		simThread.sendInputs(inputs);
+		const RenderState& state = simThread.getLatestState();
+
+		// A frame that found no new step since the last one (expected to be rare at 120 ticks a second)
+		staleFrames += (unsigned long long) (state.tick == lastTick);
+		lastTick = state.tick;
+
+		if (state.isRoundOver)
+		{
+			simThread.stop();
+
+			const SimThreadStats& stats = simThread.getStats();
+			threaded.ticks += stats.ticks;
+			threaded.lateTicks += stats.lateTicks;
+			threaded.totalLateness += stats.totalLateness;
+			threaded.maxLateness = std::max(threaded.maxLateness, stats.maxLateness);
+			threaded.maxStepTime = std::max(threaded.maxStepTime, stats.maxStepTime);
+
+			startRound(simulation);
+			simThread.start(3);
+		}
+	}
+
+	simThread.stop();
+
+	const SimThreadStats& stats = simThread.getStats();
+	threaded.ticks += stats.ticks;
+	threaded.lateTicks += stats.lateTicks;
+	threaded.totalLateness += stats.totalLateness;
+	threaded.maxLateness = std::max(threaded.maxLateness, stats.maxLateness);
+	threaded.maxStepTime = std::max(threaded.maxStepTime, stats.maxStepTime);
+
+	report("Simulation thread (after)", threaded, seconds);
+	std::cout << "Slowest step on the simulation thread: " << threaded.maxStepTime << " ms, frames with no new step: " << staleFrames << " of " << frame << "\n";
+
+	return 0;
+}
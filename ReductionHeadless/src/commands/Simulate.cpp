@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Commands.h"
+#include "sim/Simulation.h"
+#include "sim/ScriptedInput.h"
+#include "sim/BotRoster.h"
+#include "replay/ReplayRecorder.h"
+#include "utils/Settings.h"
+
+
+// Longest a headless match may run (three simulated minutes)
+constexpr unsigned int HEADLESS_MAX_STEPS = SIM_TICK_RATE * 180;
+
+
+int runSimulate(int argc, char* argv[])
+{
+	unsigned int matches = argc > 0 ? (unsigned int) std::atoi(argv[0]) : 1000;
+	unsigned int numberOfPlayers = argc > 1 ? (unsigned int) std::atoi(argv[1]) : 2;
+	// "-" skips the replay, so the bots can still be chosen
+	std::string replayPath = argc > 2 && std::string(argv[2]) != "-" ? argv[2] : "";
+	bool useBots = argc > 3 && std::string(argv[3]) == "default";
+
+	// Every match is seeded, so the recorded one can be played back exactly
+	unsigned int firstSeed = std::random_device()();
+
+	Simulation simulation;
+	simulation.initPlayers(numberOfPlayers);
+
+	ReplayRecorder recorder;
+
+	std::vector<PlayerInput> inputs(simulation.getPlayers().size());
+
+	BotRoster bots;
+
+	if (useBots)
+	{
+		bots.fill(numberOfPlayers);
+	}
+
+	unsigned long long totalSteps = 0;
+	unsigned int timedOut = 0;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int match = 0; match < matches; match++)
+	{
+		simulation.seed(firstSeed + match);
+
+		simulation.resetPlayers(true);
+		simulation.resetWall();
+
+		// Records the first match when asked to
+		if (match == 0 && !replayPath.empty())
+		{
+			recorder.begin(ReplayHeader { firstSeed, simulation.getClock().getTickRate(), 1, numberOfPlayers });
+			recorder.beginRound(simulation);
+		}
+
+		unsigned int step = 0;
+
+		for (; step < HEADLESS_MAX_STEPS && !simulation.isRoundOver(); step++)
+		{
+			if (useBots)
+			{
+				bots.decide(simulation, inputs);
+			}
+
+			else
+			{
+				for (unsigned int player = 0; player < inputs.size(); player++)
+				{
+					inputs[player] = scriptChaseInput(simulation, player);
+				}
+			}
+
+			recorder.recordTick(inputs, simulation);
+			simulation.step(inputs);
+		}
+
+		if (recorder.isRecording())
+		{
+			recorder.endRound(simulation.getChecksum());
+			recorder.finish(replayPath);
+
+			std::cout << "Recorded match 0 to " << replayPath << "\n";
+		}
+
+		totalSteps += step;
+		timedOut += (unsigned int) (step == HEADLESS_MAX_STEPS);
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << "Simulated " << matches << " matches (" << numberOfPlayers << " players, " << timedOut << " timed out)\n";
+	std::cout << "Total steps: " << totalSteps << "\n";
+	std::cout << "Elapsed: " << elapsed.count() << " s\n";
+	std::cout << "Matches per second: " << matches / elapsed.count() << "\n";
+	std::cout << "Steps per second: " << totalSteps / elapsed.count() << "\n";
+
+	if (useBots)
+	{
+		const BotStats& stats = bots.getStats();
+
+		std::cout << "Bot decisions: " << stats.totalTime / std::max(stats.decisions, 1ull) * 1e9 << " ns each on average, slowest tick "
+			<< stats.maxTickTime * 1e6 << " us, " << stats.ticksOverBudget << " of " << stats.ticks << " ticks over budget\n";
+	}
+
+	return 0;
+}
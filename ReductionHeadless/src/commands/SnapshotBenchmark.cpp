@@ -0,0 +1,131 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "Commands.h"
+#include "entities/BulletPool.h"
+#include "sim/Simulation.h"
+#include "sim/SimSnapshot.h"
+#include "utils/Settings.h"
+
+
+// Ticks played before timing, so the world has bullets in flight
+constexpr unsigned int SNAPSHOT_WARMUP_TICKS = SIM_TICK_RATE * 2;
+// Ticks played between saving and restoring when checking a round trip
+constexpr unsigned int SNAPSHOT_CHECK_TICKS = SIM_TICK_RATE;
+
+
+// Prints the time per call of a timed run in microseconds
+static void report(const char* name, unsigned int iterations, std::chrono::duration<double, std::micro> elapsed)
+{
+	std::cout << name << ": " << elapsed.count() / iterations << " us\n";
+}
+
+// Every player spins and fires, filling the screen with bullets
+static void stepSpinning(Simulation& simulation, const std::vector<PlayerInput>& inputs, unsigned int ticks)
+{
+	for (unsigned int tick = 0; tick < ticks; tick++)
+	{
+		simulation.step(inputs);
+	}
+}
+
+
+int runSnapshotBenchmark(int argc, char* argv[])
+{
+	unsigned int iterations = argc > 0 ? (unsigned int) std::atoi(argv[0]) : 100000;
+
+	Simulation simulation;
+	simulation.seed(1);
+	simulation.initPlayers(3);
+	simulation.resetWall();
+
+	std::vector<PlayerInput> inputs(simulation.getPlayers().size());
+
+	for (PlayerInput& input : inputs)
+	{
+		input.rotation = 1;
+		input.thrust = 1;
+		input.shoot = true;
+	}
+
+	stepSpinning(simulation, inputs, SNAPSHOT_WARMUP_TICKS);
+
+	SimSnapshot snapshot(simulation.getMaxStateSize());
+	const unsigned char* buffer = snapshot.getData();
+
+	// Saving then playing on and restoring must give back the same world, and the same future
+	simulation.saveSnapshot(snapshot);
+	unsigned int savedChecksum = simulation.getChecksum();
+
+	stepSpinning(simulation, inputs, SNAPSHOT_CHECK_TICKS);
+	unsigned int futureChecksum = simulation.getChecksum();
+
+	bool restored = simulation.restoreSnapshot(snapshot) && simulation.getChecksum() == savedChecksum;
+	stepSpinning(simulation, inputs, SNAPSHOT_CHECK_TICKS);
+	restored = restored && simulation.getChecksum() == futureChecksum;
+
+	simulation.restoreSnapshot(snapshot);
+
+	std::cout << "World: " << simulation.getPlayers().size() << " players, " << simulation.getBullets().size() << " bullets\n";
+	std::cout << "Snapshot: " << snapshot.getSize() << " bytes (capacity " << snapshot.getCapacity() << ")\n";
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		simulation.saveSnapshot(snapshot);
+	}
+
+	report("Save", iterations, std::chrono::steady_clock::now() - start);
+
+	start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		simulation.restoreSnapshot(snapshot);
+	}
+
+	report("Restore", iterations, std::chrono::steady_clock::now() - start);
+
+	// Worst case for the bullets: a full pool
+	BulletPool pool;
+
+	for (unsigned int i = 0; i < pool.getCapacity(); i++)
+	{
+		pool.spawn(i * 360.0 / pool.getCapacity(), SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, i % 3, 1);
+	}
+
+	std::vector<unsigned char> poolBuffer;
+	poolBuffer.reserve(pool.getMaxStateSize());
+
+	start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		poolBuffer.clear();
+		pool.saveState(poolBuffer);
+	}
+
+	report("Save full bullet pool", iterations, std::chrono::steady_clock::now() - start);
+
+	start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		size_t offset = 0;
+		pool.loadState(poolBuffer.data(), poolBuffer.size(), offset);
+	}
+
+	report("Restore full bullet pool", iterations, std::chrono::steady_clock::now() - start);
+
+	// The buffer never moving means it was never reallocated
+	bool allocationFree = snapshot.getData() == buffer && poolBuffer.capacity() == pool.getMaxStateSize();
+
+	std::cout << "Full bullet pool: " << poolBuffer.size() << " bytes (" << pool.size() << " bullets)\n";
+	std::cout << "Round trip: " << (restored ? "matched" : "MISMATCHED") << "\n";
+	std::cout << "Buffers reallocated: " << (allocationFree ? "no" : "YES") << "\n";
+
+	return restored && allocationFree ? 0 : 1;
+}
@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "Commands.h"
+#include "net/SnapshotCodec.h"
+#include "server/ServerMatch.h"
+#include "server/ServerMessages.h"
+#include "server/SpectatorRelay.h"
+#include "utils/ByteIO.h"
+#include "utils/Settings.h"
+
+
+// UDP port the relay listens on
+constexpr unsigned short SPECTATE_RELAY_PORT = 27800;
+// Threads playing the viewers
+constexpr unsigned int SPECTATE_VIEWER_THREADS = 2;
+// One viewer in this many fully decodes its states, the rest only read the sequence (keeps the
+// load generator from using up the CPU the relay is being measured on)
+constexpr unsigned int SPECTATE_DECODE_EVERY = 16;
+// How often a slow viewer gets round to reading its socket (seconds)
+constexpr double SPECTATE_SLOW_READ_INTERVAL = 3.0;
+// How often the relay's link to a stalled viewer backs up (seconds), and for how many states (more
+// than its queue holds, so the queue overflows and the viewer resyncs on the next keyframe)
+constexpr double SPECTATE_STALL_INTERVAL = 2.0;
+constexpr unsigned int SPECTATE_STALL_STATES = RELAY_QUEUE_PACKETS * 3;
+
+
+// One watcher on localhost
+struct Spectator
+{
+	UdpSocket socket;
+	bool isSlow = false;
+	bool isStalled = false;
+	// Only set for the viewers that decode
+	SnapshotDecoder* decoder = nullptr;
+
+	bool hasAck = false;
+	unsigned short ack = 0;
+
+	unsigned long long statesReceived = 0;
+	unsigned long long decodeFailures = 0;
+};
+
+// What one group of viewers measured
+struct SpectatorResult
+{
+	unsigned long long statesReceived = 0;
+	unsigned long long slowStatesReceived = 0;
+	unsigned long long stalledStatesReceived = 0;
+	unsigned long long decoded = 0;
+	unsigned long long decodeFailures = 0;
+};
+
+
+static void sendWatch(Spectator& spectator, const NetAddress& relay)
+{
+	std::vector<unsigned char> buffer;
+	buffer.reserve(SPECTATOR_WATCH_MESSAGE_SIZE);
+
+	buffer.push_back(SPECTATOR_WATCH_MESSAGE);
+	writeFixed(buffer, 0u);
+	buffer.push_back((unsigned char) spectator.hasAck);
+	writeFixed(buffer, spectator.ack);
+
+	spectator.socket.send(relay, buffer.data(), buffer.size());
+}
+
+// Reads every state waiting for a viewer
+static void readStates(Spectator& spectator, std::vector<unsigned char>& buffer, StateSnapshot& snapshot, SpectatorResult& result)
+{
+	NetAddress from;
+	int size;
+
+	while ((size = spectator.socket.receive(buffer.data(), buffer.size(), from)) >= 0)
+	{
+		if (size < (int) SERVER_STATE_HEADER_SIZE + 2 || buffer[0] != SPECTATOR_STATE_MESSAGE)
+		{
+			continue;
+		}
+
+		const unsigned char* state = buffer.data() + SERVER_STATE_HEADER_SIZE;
+		size_t stateSize = (size_t) size - SERVER_STATE_HEADER_SIZE;
+		bool isValid = true;
+
+		if (spectator.decoder)
+		{
+			isValid = spectator.decoder->decode(state, stateSize, snapshot);
+
+			result.decoded += (unsigned long long) isValid;
+			spectator.decodeFailures += (unsigned long long) !isValid;
+		}
+
+		if (isValid)
+		{
+			// The sequence is the first 16 bits of the encoded state
+			spectator.hasAck = true;
+			spectator.ack = (unsigned short) (state[0] | state[1] << 8);
+		}
+
+		spectator.statesReceived += 1;
+	}
+}
+
+// Plays a group of viewers until stopped: each joins, reads its states and acknowledges them
+static void runSpectators(std::vector<Spectator>& spectators, std::atomic<bool>& stop, SpectatorResult& result)
+{
+	NetAddress relay = NetAddress::localhost(SPECTATE_RELAY_PORT);
+
+	std::vector<unsigned char> buffer(SERVER_MAX_STATE_SIZE);
+	StateSnapshot snapshot;
+
+	using Clock = std::chrono::steady_clock;
+	Clock::duration frameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / SERVER_TICK_RATE));
+	Clock::duration slowInterval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(SPECTATE_SLOW_READ_INTERVAL));
+
+	// Each viewer joins and acknowledges on its own frame of the interval, as real viewers would
+	// be spread out rather than all arriving in one burst
+	unsigned int ackFrames = std::max(1u, (unsigned int) (RELAY_ACK_INTERVAL / 1000.0 * SERVER_TICK_RATE));
+	unsigned int frame = 0;
+
+	Clock::time_point nextFrame = Clock::now();
+	Clock::time_point nextSlowRead = nextFrame + slowInterval;
+
+	while (!stop)
+	{
+		std::this_thread::sleep_until(nextFrame);
+		nextFrame += frameTime;
+
+		bool isSlowReadDue = Clock::now() >= nextSlowRead;
+
+		for (size_t i = 0; i < spectators.size(); i++)
+		{
+			Spectator& spectator = spectators[i];
+
+			if (!spectator.isSlow || isSlowReadDue)
+			{
+				readStates(spectator, buffer, snapshot, result);
+			}
+
+			if (i % ackFrames == frame)
+			{
+				sendWatch(spectator, relay);
+			}
+		}
+
+		frame = (frame + 1) % ackFrames;
+
+		if (isSlowReadDue)
+		{
+			nextSlowRead += slowInterval;
+		}
+	}
+
+	for (Spectator& spectator : spectators)
+	{
+		(spectator.isSlow ? result.slowStatesReceived : spectator.isStalled ? result.stalledStatesReceived : result.statesReceived) += spectator.statesReceived;
+		result.decodeFailures += spectator.decodeFailures;
+
+		delete spectator.decoder;
+		spectator.decoder = nullptr;
+	}
+}
+
+
+int runSpectate(int argc, char* argv[])
+{
+	unsigned int viewerCount = argc > 0 ? (unsigned int) std::atoi(argv[0]) : 2000;
+	double seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+	unsigned int threadCount = argc > 2 ? (unsigned int) std::atoi(argv[2]) : 0;
+	double slowShare = argc > 3 ? std::atof(argv[3]) / 100.0 : 0.05;
+	double stalledShare = argc > 4 ? std::atof(argv[4]) / 100.0 : 0.01;
+
+	ThreadPool pool(threadCount);
+	SpectatorRelay relay(0, &pool);
+
+	if (!relay.start(SPECTATE_RELAY_PORT))
+	{
+		std::cout << "Couldn't listen on UDP port " << SPECTATE_RELAY_PORT << "\n";
+		return 1;
+	}
+
+	// Bots play every slot, so the match needs no socket of its own
+	ServerMatch match(0, 3, MEDIUM_GAME_POINTS_TO_WIN, 1);
+	match.setRelay(&relay);
+	UdpSocket unusedSocket;
+
+	// Viewers are split between the threads, slow and stalled ones spread evenly through them
+	std::vector<std::vector<Spectator>> groups;
+	// Where the relay sees each stalled viewer, so its link can be backed up
+	std::vector<NetAddress> stalledAddresses;
+	unsigned int slowPeriod = slowShare > 0.0 ? std::max(1u, (unsigned int) (1.0 / slowShare)) : 0;
+	unsigned int stalledPeriod = stalledShare > 0.0 ? std::max(1u, (unsigned int) (1.0 / stalledShare)) : 0;
+
+	for (unsigned int group = 0; group < SPECTATE_VIEWER_THREADS; group++)
+	{
+		groups.emplace_back(viewerCount / SPECTATE_VIEWER_THREADS + (group < viewerCount % SPECTATE_VIEWER_THREADS));
+
+		for (Spectator& spectator : groups.back())
+		{
+			unsigned int index = (unsigned int) (&spectator - groups.back().data()) * SPECTATE_VIEWER_THREADS + group;
+
+			if (!spectator.socket.open(0))
+			{
+				std::cout << "Couldn't open a socket for every viewer (raise the open file limit)\n";
+				return 1;
+			}
+
+			spectator.isSlow = slowPeriod > 0 && index % slowPeriod == 0;
+			spectator.isStalled = stalledPeriod > 0 && index % stalledPeriod == stalledPeriod / 2 && !spectator.isSlow;
+			spectator.decoder = index % SPECTATE_DECODE_EVERY == 1 && !spectator.isSlow && !spectator.isStalled ? new SnapshotDecoder() : nullptr;
+
+			if (spectator.isStalled)
+			{
+				stalledAddresses.push_back(NetAddress::localhost(spectator.socket.getPort()));
+			}
+		}
+	}
+
+	std::atomic<bool> stop { false };
+	std::vector<SpectatorResult> results(SPECTATE_VIEWER_THREADS);
+	std::vector<std::thread> threads;
+
+	for (unsigned int group = 0; group < SPECTATE_VIEWER_THREADS; group++)
+	{
+		threads.emplace_back(runSpectators, std::ref(groups[group]), std::ref(stop), std::ref(results[group]));
+	}
+
+	using Clock = std::chrono::steady_clock;
+	Clock::duration frameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / SERVER_TICK_RATE));
+	Clock::time_point nextFrame = Clock::now();
+
+	unsigned long long frames = (unsigned long long) (seconds * SERVER_TICK_RATE);
+	unsigned long long stallFrames = std::max(1ull, (unsigned long long) (SPECTATE_STALL_INTERVAL * SERVER_TICK_RATE));
+	unsigned long long stalls = 0;
+	double relayTime = 0.0;
+	double peakViewers = 0.0;
+
+	for (unsigned long long frame = 0; frame < frames; frame++)
+	{
+		std::this_thread::sleep_until(nextFrame);
+		nextFrame += frameTime;
+
+		// Once viewers have had a second to join, their links back up every so often
+		if (frame >= SERVER_TICK_RATE && frame % stallFrames == 0)
+		{
+			for (const NetAddress& address : stalledAddresses)
+			{
+				relay.stallViewer(address, SPECTATE_STALL_STATES);
+			}
+
+			stalls += stalledAddresses.size();
+		}
+
+		Clock::time_point start = Clock::now();
+
+		relay.receive();
+		match.tick(unusedSocket);
+		relay.flush();
+
+		relayTime += std::chrono::duration<double>(Clock::now() - start).count();
+		peakViewers = std::max(peakViewers, (double) relay.getViewerCount());
+	}
+
+	unsigned int connected = relay.getViewerCount();
+	size_t relayMemory = relay.getMemoryUsage();
+
+	stop = true;
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	SpectatorResult total;
+	unsigned int slowViewers = 0;
+	unsigned int stalledViewers = (unsigned int) stalledAddresses.size();
+
+	for (unsigned int group = 0; group < SPECTATE_VIEWER_THREADS; group++)
+	{
+		total.statesReceived += results[group].statesReceived;
+		total.slowStatesReceived += results[group].slowStatesReceived;
+		total.stalledStatesReceived += results[group].stalledStatesReceived;
+		total.decoded += results[group].decoded;
+		total.decodeFailures += results[group].decodeFailures;
+
+		for (const Spectator& spectator : groups[group])
+		{
+			slowViewers += (unsigned int) spectator.isSlow;
+		}
+	}
+
+	RelayStats stats = relay.getStats();
+	unsigned int fastViewers = viewerCount - slowViewers - stalledViewers;
+	double busyPerSecond = relayTime / seconds;
+
+	std::cout << "Relayed one match to " << viewerCount << " viewers (" << slowViewers << " slow, " << stalledViewers << " stalled) on " << pool.getThreadCount() << " threads for " << seconds << " s\n";
+	std::cout << "Viewers connected at the end: " << connected << " (" << stats.viewersJoined << " joined, " << stats.viewersTimedOut << " timed out)\n";
+	std::cout << "States: " << stats.statesPublished << " encoded once each, " << stats.packetsSent << " packets sent ("
+		<< stats.bytesSent / std::max(stats.packetsSent, 1ull) << " bytes each on average), " << relay.getPacketBufferCount() << " packet buffers in circulation\n";
+	std::cout << "Joining viewers: " << stats.statesHeldForJoin << " states held back until their first keyframe\n";
+	std::cout << "Slow readers: " << stats.statesHeldForLag << " states held back while their acknowledgements lagged\n";
+	std::cout << "Stalled links: " << stalls << " stalls of " << SPECTATE_STALL_STATES << " states, " << stats.queueOverflows << " queue overflows, "
+		<< stats.statesHeldForResync << " states dropped until a resync keyframe (" << (double) stats.statesHeldForResync / std::max(stats.queueOverflows, 1ull)
+		<< " per overflow), " << stats.sendFailures << " sends refused\n";
+	std::cout << "Received per second: " << total.statesReceived / std::max(fastViewers, 1u) / seconds << " states per viewer, "
+		<< total.slowStatesReceived / std::max(slowViewers, 1u) / seconds << " per slow viewer, "
+		<< total.stalledStatesReceived / std::max(stalledViewers, 1u) / seconds << " per stalled viewer\n";
+	std::cout << "Decoded " << total.decoded << " states on " << (fastViewers + SPECTATE_DECODE_EVERY - 1) / SPECTATE_DECODE_EVERY << " sampled viewers, "
+		<< total.decodeFailures << " couldn't be (waiting for a keyframe)\n";
+	std::cout << "Relay busy: " << busyPerSecond * 1000.0 << " ms a second (" << busyPerSecond * 100.0 << "% of a core), "
+		<< busyPerSecond * 1e6 / std::max(peakViewers, 1.0) << " us a second per viewer\n";
+	std::cout << "Relay memory: " << relayMemory / 1024 << " KB, " << relayMemory / std::max(connected, 1u) << " bytes per viewer\n";
+
+	return 0;
+}
@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Commands.h"
+#include "entities/BulletPool.h"
+#include "net/SnapshotCodec.h"
+#include "net/StateSnapshot.h"
+#include "utils/MathUtils.h"
+#include "utils/Settings.h"
+
+
+// States sent before the round trip to the client has been made, each way
+constexpr unsigned int STATE_BENCH_LATENCY = 3;
+// Chance a state message is lost on the way to the client
+constexpr double STATE_BENCH_LOSS = 0.05;
+// Chance a bullet hits something each tick, so bullets leave from all over the pool
+constexpr double STATE_BENCH_HIT_CHANCE = 0.002;
+// Bytes per state in the plain format of the first dedicated server (header, 10 per player, 5 per bullet)
+constexpr unsigned int STATE_BENCH_PLAIN_HEADER = 14;
+
+
+// A player of the synthetic world, which has room for more players than the game
+struct BenchPlayer
+{
+	double x = 0.0;
+	double y = 0.0;
+	double direction = 0.0;
+	double turnSpeed = 0.0;
+	int life = (int) PLAYER_STARTING_LIFE;
+	unsigned int points = 0;
+};
+
+// What one scene measured
+struct StateBenchResult
+{
+	unsigned long long states = 0;
+	unsigned long long bullets = 0;
+	unsigned long long fullBytes = 0;
+	unsigned long long plainBytes = 0;
+	std::vector<unsigned int> deltaSizes;
+	double encodeTime = 0.0;
+	double decodeTime = 0.0;
+	unsigned long long decoded = 0;
+	unsigned long long mismatches = 0;
+};
+
+
+// Players wander and fire until the pool holds about bulletTarget bullets, then states are sent
+// through an encoder and decoder with latency and loss between them
+static StateBenchResult runScene(unsigned int playerCount, unsigned int bulletTarget, unsigned int stateCount)
+{
+	std::mt19937 rng(playerCount * 7919 + bulletTarget);
+	std::uniform_real_distribution<> unit(0.0, 1.0);
+
+	const double dt = 1.0 / SERVER_TICK_RATE;
+
+	std::vector<BenchPlayer> players(playerCount);
+
+	for (BenchPlayer& player : players)
+	{
+		player.x = unit(rng) * SCREEN_WIDTH;
+		player.y = unit(rng) * SCREEN_HEIGHT;
+		player.direction = unit(rng) * 360.0;
+	}
+
+	BulletPool bullets(std::max(bulletTarget * 2, 16u));
+
+	SnapshotEncoder encoder;
+	SnapshotDecoder decoder;
+	// Never acknowledged, so it always writes states in full
+	SnapshotEncoder fullEncoder;
+	StateSnapshot snapshot;
+	StateSnapshot received;
+
+	// Messages and acks on their way, by the state they arrive at
+	std::vector<std::vector<unsigned char>> inFlight(STATE_BENCH_LATENCY);
+	std::vector<StateSnapshot> sentStates(STATE_BENCH_LATENCY);
+	std::vector<int> acks(STATE_BENCH_LATENCY, -1);
+
+	std::vector<unsigned char> fullMessage;
+
+	StateBenchResult result;
+	result.deltaSizes.reserve(stateCount);
+
+	using Clock = std::chrono::steady_clock;
+
+	for (unsigned int state = 0; state < stateCount + STATE_BENCH_LATENCY; state++)
+	{
+		for (unsigned int tick = 0; tick < SERVER_STATE_INTERVAL; tick++)
+		{
+			for (unsigned int i = 0; i < playerCount; i++)
+			{
+				BenchPlayer& player = players[i];
+
+				player.turnSpeed = std::min(std::max(player.turnSpeed + (unit(rng) - 0.5) * 60.0, -PLAYER_ROTATION_SPEED), PLAYER_ROTATION_SPEED);
+				player.direction = std::fmod(player.direction + player.turnSpeed * dt + 360.0, 360.0);
+
+				double radians = toRadians(player.direction);
+				player.x = std::min(std::max(player.x + std::sin(radians) * MAX_PLAYER_SPEED * 0.5 * dt, 0.0), (double) SCREEN_WIDTH - PLAYER_WIDTH);
+				player.y = std::min(std::max(player.y - std::cos(radians) * MAX_PLAYER_SPEED * 0.5 * dt, 0.0), (double) SCREEN_HEIGHT - PLAYER_HEIGHT);
+
+				if (unit(rng) < 0.002)
+				{
+					player.life = std::max(player.life - (int) PLAYER_HIT_DAMAGE, 0);
+				}
+			}
+
+			bullets.integrate(dt);
+			bullets.killOutOfBounds();
+
+			for (unsigned int i = 0; i < bullets.size(); i++)
+			{
+				if (unit(rng) < STATE_BENCH_HIT_CHANCE)
+				{
+					bullets.kill(i);
+				}
+			}
+
+			bullets.compact();
+
+			// Tops the pool back up a few bullets a tick, from random players
+			for (unsigned int shot = 0; shot < playerCount && bullets.size() < bulletTarget; shot++)
+			{
+				const BenchPlayer& shooter = players[std::uniform_int_distribution<unsigned int>(0, playerCount - 1)(rng)];
+				unsigned int owner = (unsigned int) (&shooter - players.data());
+
+				bullets.spawn(shooter.direction + (unit(rng) - 0.5) * BULLET_DIRECTION_OFFSET_MAX, shooter.x + PLAYER_WIDTH / 2, shooter.y + PLAYER_HEIGHT / 2, owner, (int) PLAYER_HIT_DAMAGE);
+			}
+		}
+
+		snapshot.tick = (state + 1) * SERVER_STATE_INTERVAL;
+		snapshot.players.clear();
+		snapshot.bullets.clear();
+
+		for (const BenchPlayer& player : players)
+		{
+			QuantizedPlayer quantized;
+			quantized.x = quantizePosition(player.x);
+			quantized.y = quantizePosition(player.y);
+			quantized.direction = quantizeDirection(player.direction);
+			quantized.life = quantizeLife(player.life);
+			quantized.points = (unsigned char) player.points;
+			quantized.isAlive = player.life > 0;
+
+			snapshot.players.push_back(quantized);
+		}
+
+		quantizeBullets(bullets, snapshot.bullets);
+
+		// Acks sent STATE_BENCH_LATENCY states ago arrive now
+		unsigned int slot = state % (STATE_BENCH_LATENCY);
+
+		if (acks[slot] >= 0)
+		{
+			encoder.acknowledge((unsigned short) acks[slot]);
+		}
+
+		std::vector<unsigned char>& message = inFlight[slot];
+		StateSnapshot& arrivingState = sentStates[slot];
+
+		// The message sent STATE_BENCH_LATENCY states ago arrives at the client (unless it was lost)
+		if (state >= STATE_BENCH_LATENCY && !message.empty())
+		{
+			Clock::time_point start = Clock::now();
+			bool decoded = decoder.decode(message.data(), message.size(), received);
+			result.decodeTime += std::chrono::duration<double>(Clock::now() - start).count();
+
+			result.decoded += (unsigned long long) decoded;
+			result.mismatches += (unsigned long long) (!decoded || received != arrivingState);
+		}
+
+		acks[slot] = decoder.hasAck() ? decoder.getAck() : -1;
+
+		if (state >= stateCount)
+		{
+			message.clear();
+			continue;
+		}
+
+		message.clear();
+
+		Clock::time_point start = Clock::now();
+		encoder.encode(snapshot, message);
+		result.encodeTime += std::chrono::duration<double>(Clock::now() - start).count();
+
+		arrivingState = snapshot;
+		result.deltaSizes.push_back((unsigned int) message.size());
+
+		fullMessage.clear();
+		fullEncoder.encode(snapshot, fullMessage);
+
+		result.states += 1;
+		result.bullets += snapshot.bullets.size();
+		result.fullBytes += fullMessage.size();
+		result.plainBytes += STATE_BENCH_PLAIN_HEADER + playerCount * 10 + (unsigned int) snapshot.bullets.size() * 5;
+
+		if (unit(rng) < STATE_BENCH_LOSS)
+		{
+			message.clear();
+		}
+	}
+
+	return result;
+}
+
+static void reportScene(unsigned int playerCount, const StateBenchResult& result)
+{
+	std::vector<unsigned int> sizes = result.deltaSizes;
+	std::sort(sizes.begin(), sizes.end());
+
+	unsigned long long deltaBytes = 0;
+
+	for (unsigned int size : sizes)
+	{
+		deltaBytes += size;
+	}
+
+	double states = (double) result.states;
+	double statesPerSecond = (double) SERVER_TICK_RATE / SERVER_STATE_INTERVAL;
+
+	std::cout << playerCount << " players, " << result.bullets / result.states << " bullets on average (" << result.states << " states):\n";
+	std::cout << "  Plain: " << result.plainBytes / states << " bytes, full: " << result.fullBytes / states << " bytes, delta: "
+		<< deltaBytes / states << " bytes average, " << sizes[sizes.size() * 99 / 100] << " p99, " << sizes.back() << " max\n";
+	std::cout << "  Encode: " << result.encodeTime * 1e9 / states << " ns, decode: " << result.decodeTime * 1e9 / std::max(result.decoded, 1ull) << " ns\n";
+	std::cout << "  Per connection at " << statesPerSecond << " states a second: " << deltaBytes / states * statesPerSecond * 8 / 1000 << " kbit/s, "
+		<< result.encodeTime / states * statesPerSecond * 1e6 << " us of encoding a second\n";
+	std::cout << "  Decoded " << result.decoded << " (the rest were lost), " << result.mismatches << " differed from what was sent\n";
+}
+
+
+int runStateCodecBenchmark(int argc, char* argv[])
+{
+	unsigned int stateCount = argc > 0 ? (unsigned int) std::atoi(argv[0]) : 20000;
+	unsigned int bulletTarget = argc > 1 ? (unsigned int) std::atoi(argv[1]) : 300;
+
+	if (stateCount == 0 || bulletTarget > SNAPSHOT_MAX_BULLETS)
+	{
+		std::cout << "Needs at least one state, and at most " << SNAPSHOT_MAX_BULLETS << " bullets\n";
+		return 1;
+	}
+
+	bool matched = true;
+
+	for (unsigned int playerCount : { 3u, 32u })
+	{
+		StateBenchResult result = runScene(playerCount, bulletTarget, stateCount);
+		reportScene(playerCount, result);
+
+		matched = matched && result.mismatches == 0;
+	}
+
+	return matched ? 0 : 1;
+}